@@ -46,8 +46,8 @@ void HelpRun::execute()
    {
       // Create and initialize a string list and enumeration used to figure out which
       // command was given.
-      enum {Run,Chunkrun,Merge,Dump,Inject,Settings};
-      const QStringList commands {"run","chunkrun","merge","dump","inject","settings"};
+      enum {Run,Chunkrun,Merge,Parallelrun,Dump,Inject,Settings};
+      const QStringList commands {"run","chunkrun","merge","parallelrun","dump","inject","settings"};
 
       // Determine which help command is given by the user.
       QString command {_command.pop()};
@@ -62,6 +62,9 @@ void HelpRun::execute()
       case Merge:
          mergeHelp();
          break;
+      case Parallelrun:
+         parallelrunHelp();
+         break;
       case Dump:
          dumpHelp();
          break;
@@ -268,6 +271,8 @@ void HelpRun::basic()
           << "          file.\n\n"
           << "   merge: Merge all temporary result files from chunkruns into the finished\n"
           << "          output data objects of the analytic run.\n\n"
+          << "parallelrun: Run an analytic with local chunkrun processes, merging each\n"
+          << "             chunk file as soon as its chunkrun is finished.\n\n"
           << "    dump: Dump the system or user metadata of a data object to standard output\n"
           << "          as JSON formatted text.\n\n"
           << "  inject: Inject new user metadata into a data object from a JSON formatted text\n"
@@ -344,7 +349,8 @@ void HelpRun::chunkrunHelp()
              << "the total analytic and saving its temporary results to a chunk file. All these\n"
              << "chunk files are later merged with the merge command. WARNING: ALL analytic\n"
              << "options must be identical for all individual chunk run executions or they will\n"
-             << "not properly merge together.\n\n"
+             << "not properly merge together. If a chunk run is interrupted then running it\n"
+             << "again with the same options resumes from its last complete result block.\n\n"
              << "index: The specific chunk index of work that will be run on the given analytic\n"
              << "       and results saved.\n"
              << " size: The total number of chunks that the total analytic work is separated\n"
@@ -392,8 +398,9 @@ void HelpRun::mergeHelp()
              << "Merges all chunkrun output files into the finalized output of the given analytic"
              << "and options run. WARNING: ALL analytic options must be identical for the merge\n"
              << "command and all individual chunk run executions or they will not properly merge\n"
-             << "together. Also all chunk run executions must be complete before the merge\n"
-             << "command can be executed.\n\n"
+             << "together. The merge command can be started while chunk runs are still\n"
+             << "executing; each chunk file is merged once its chunk run is complete. Chunk\n"
+             << "runs that have not started yet are waited on up to the merge timeout setting.\n\n"
              << " size: The total number of chunks that the total analytic work is separated\n"
              << "       into.\n\n"
              << "Help: " << _runName << " help merge <analytic>\n"
@@ -418,6 +425,54 @@ void HelpRun::mergeHelp()
 
 
 
+
+/*!
+ * Displays the help text for the parallel run command.
+ */
+void HelpRun::parallelrunHelp()
+{
+   // If there is still a command to be processed then run the analytic help command.
+   if ( _command.size() > 0 )
+   {
+      analyticHelp();
+   }
+
+   // Else this is the run help command.
+   else
+   {
+      // Create a text stream to standard output and print out the parallel run help
+      // text header.
+      QTextStream stream(stdout);
+      stream << "Command: " << _runName << " parallelrun <size> <analytic> <options...>\n"
+             << "Runs the given analytic and options by spawning <size> chunkrun processes of\n"
+             << "this program on the local system and merging their chunk files. Each chunk\n"
+             << "file is merged as soon as its chunkrun process is finished instead of waiting\n"
+             << "for all of them. The CPU threads of this system are divided between all\n"
+             << "chunkrun processes if the CPU thread size setting is automatic.\n\n"
+             << " size: The total number of chunkrun processes that the total analytic work is\n"
+             << "       separated into.\n\n"
+             << "Help: " << _runName << " help parallelrun <analytic>\n"
+             << "Get help about parallel running a specific analytic <analytic>.\n\n"
+             << "Valid analytics:\n";
+
+      // Iterate through all possible analytics, printing out their command line name
+      // and then full name.
+      EAbstractAnalyticFactory& factory {EAbstractAnalyticFactory::instance()};
+      for (quint16 i = 0; i < factory.size() ;++i)
+      {
+         stream << factory.commandName(i) << ": " << factory.name(i) << "\n";
+      }
+
+      // Print out the final closing empty new line of the parallel run help text.
+      stream << "\n";
+   }
+}
+
+
+
+
+
+
 /*!
  * Displays the help text for the dump command.
  */
@@ -495,9 +550,9 @@ void HelpRun::analyticHelp()
 
       // Output the basic help header information about the created analytic to standard
       // output.
-      stream << "Command: " << _runName << " run|chunkrun|merge " << name << " <options...>\n"
-             << "Run the given analytic in normal, chunk, or merge mode. For chunk and merge\n"
-             << "modes all separate executions MUST have the same options provided to the\n"
+      stream << "Command: " << _runName << " run|chunkrun|merge|parallelrun " << name << " <options...>\n"
+             << "Run the given analytic in normal, chunk, merge, or parallel mode. For chunk and\n"
+             << "merge modes all separate executions MUST have the same options provided to the\n"
              << "analytic.\n\n"
              << "OPTIONS\n\n";
 
@@ -599,8 +654,8 @@ void HelpRun::settingsSetHelp()
 {
    // Initialize an enumeration and string list used to determine what setting set
    // command was given to get help on, if any.
-   enum {CUDA,OpenCL,Threads,Buffer,ChunkDir,ChunkPre,ChunkExt,Logging,LogPort};
-   QStringList list {"cuda","opencl","threads","buffer","chunkdir","chunkpre","chunkext","logging","logport"};
+   enum {CUDA,OpenCL,Threads,CPUThreads,Buffer,Reduce,Timeout,Checkpoint,Window,ChunkDir,ChunkPre,ChunkExt,MergeTimeout,History,Logging,LogPort};
+   QStringList list {"cuda","opencl","threads","cputhreads","buffer","reduce","timeout","checkpoint","window","chunkdir","chunkpre","chunkext","mergetimeout","history","logging","logport"};
 
    // Create an empty command string, setting it to this run's next command argument
    // is any exists.
@@ -622,9 +677,24 @@ void HelpRun::settingsSetHelp()
    case Threads:
       settingsSetThreadsHelp();
       break;
+   case CPUThreads:
+      settingsSetCPUThreadsHelp();
+      break;
    case Buffer:
       settingsSetBufferHelp();
       break;
+   case Reduce:
+      settingsSetReduceHelp();
+      break;
+   case Timeout:
+      settingsSetTimeoutHelp();
+      break;
+   case Checkpoint:
+      settingsSetCheckpointHelp();
+      break;
+   case Window:
+      settingsSetWindowHelp();
+      break;
    case ChunkDir:
       settingsSetChunkDirHelp();
       break;
@@ -634,6 +704,12 @@ void HelpRun::settingsSetHelp()
    case ChunkExt:
       settingsSetChunkExtHelp();
       break;
+   case MergeTimeout:
+      settingsSetMergeTimeoutHelp();
+      break;
+   case History:
+      settingsSetHistoryHelp();
+      break;
    case Logging:
       settingsSetLoggingHelp();
       break;
@@ -648,8 +724,9 @@ void HelpRun::settingsSetHelp()
          stream << "Command: " << _runName << " settings set <key> <value>\n"
                 << "Updates a persistent setting with the given key to the new given value.\n\n"
                 << "  key: The key of the setting that will be updated to a new value. Valid keys\n"
-                << "       are cuda, opencl, threads, buffer, chunkdir, chunkpre, chunkext,\n"
-                << "       logging, and logport.\n\n"
+                << "       are cuda, opencl, threads, cputhreads, buffer, reduce, timeout,\n"
+                << "       checkpoint, window, chunkdir, chunkpre, chunkext, mergetimeout,\n"
+                << "       history, logging, and logport.\n\n"
                 << "value: The new value of the given setting.\n\n"
                 << "Help: " << _runName << " help settings set <key>\n"
                 << "Get help about a specific setting to set with the given key.\n\n"
@@ -723,6 +800,28 @@ void HelpRun::settingsSetThreadsHelp()
 
 
 
+/*!
+ * Displays the help text for the settings set cputhreads command.
+ */
+void HelpRun::settingsSetCPUThreadsHelp()
+{
+   // Create a text stream to standard output and print the settings set cputhreads
+   // command help text.
+   QTextStream stream(stdout);
+   stream << "Command: " << _runName << " settings set cputhreads <number/auto>\n"
+          << "Updates the CPU thread size setting. The CPU thread size is the number of\n"
+          << "threads used to process work blocks in an analytic run that does not use a\n"
+          << "CUDA or OpenCL device. In an MPI run this is the number of threads used by\n"
+          << "each serial slave node.\n\n"
+          << "number: The number of CPU threads used, or auto to use all CPU cores which are\n"
+          << "        divided evenly between MPI processes on the same node.\n\n";
+}
+
+
+
+
+
+
 /*!
  * Displays the help text for the settings set buffer command.
  */
@@ -747,6 +846,95 @@ void HelpRun::settingsSetBufferHelp()
 
 
 
+/*!
+ * Displays the help text for the settings set reduce command.
+ */
+void HelpRun::settingsSetReduceHelp()
+{
+   // Create a text stream to standard output and print the settings set reduce
+   // command help text.
+   QTextStream stream(stdout);
+   stream << "Command: " << _runName << " settings set reduce <on/off>\n"
+          << "Activates or disables MPI result reduction. If it is on then the slave nodes of\n"
+          << "an MPI run that share a system with each other, but not with the master node,\n"
+          << "send their result blocks to one of them which gathers them into a single\n"
+          << "message for the master node. If the analytic supports it, result blocks with\n"
+          << "contiguous indexes are also combined into one before they are sent. This lowers\n"
+          << "the number of messages the master node must receive in large MPI runs.\n\n";
+}
+
+
+
+
+
+
+/*!
+ * Displays the help text for the settings set timeout command.
+ */
+void HelpRun::settingsSetTimeoutHelp()
+{
+   // Create a text stream to standard output and print the settings set timeout
+   // command help text.
+   QTextStream stream(stdout);
+   stream << "Command: " << _runName << " settings set timeout <seconds/off>\n"
+          << "Updates the MPI timeout setting. If a slave node of an MPI run has work blocks\n"
+          << "and sends no results to the master node for this long then it is assumed lost\n"
+          << "and its work blocks are given to other slave nodes. A lost slave node that\n"
+          << "sends results again is given work again.\n\n"
+          << "seconds: The new timeout in seconds, or off to wait forever.\n\n";
+}
+
+
+
+
+
+
+/*!
+ * Displays the help text for the settings set checkpoint command.
+ */
+void HelpRun::settingsSetCheckpointHelp()
+{
+   // Create a text stream to standard output and print the settings set checkpoint
+   // command help text.
+   QTextStream stream(stdout);
+   stream << "Command: " << _runName << " settings set checkpoint <seconds/off>\n"
+          << "Updates the MPI checkpoint interval setting. If it is on then the master node\n"
+          << "of an MPI run saves every result block it writes to a checkpoint file in the\n"
+          << "chunk working directory and marks how far it has gotten this often. If the\n"
+          << "same MPI run is started again after it was stopped then the saved result\n"
+          << "blocks are written again without being processed and the run continues from\n"
+          << "the last mark. The checkpoint file is removed once the run finishes.\n\n"
+          << "seconds: The new checkpoint interval in seconds, or off to disable it.\n\n";
+}
+
+
+
+
+
+
+/*!
+ * Displays the help text for the settings set window command.
+ */
+void HelpRun::settingsSetWindowHelp()
+{
+   // Create a text stream to standard output and print the settings set window
+   // command help text.
+   QTextStream stream(stdout);
+   stream << "Command: " << _runName << " settings set window <size/auto>\n"
+          << "Updates the window size setting. The window size is the maximum number of work\n"
+          << "blocks a single or chunk run keeps in flight, counting blocks waiting to be\n"
+          << "executed and results waiting to be saved in order. New work blocks are only\n"
+          << "made as results are saved, so memory use does not grow with the size of the\n"
+          << "analytic.\n\n"
+          << "size: The new window size, or auto to use twice the sum of the number of\n"
+          << "      blocks the device or CPU threads process at once and the buffer size.\n\n";
+}
+
+
+
+
+
+
 /*!
  * Displays the help text for the settings set chunkdir command.
  */
@@ -806,6 +994,52 @@ void HelpRun::settingsSetChunkExtHelp()
 
 
 
+/*!
+ * Displays the help text for the settings set mergetimeout command.
+ */
+void HelpRun::settingsSetMergeTimeoutHelp()
+{
+   // Create a text stream to standard output and print the settings set mergetimeout
+   // command help text.
+   QTextStream stream(stdout);
+   stream << "Command: " << _runName << " settings set mergetimeout <seconds/off>\n"
+          << "Updates the merge timeout setting. A merge waits for every chunk file that is\n"
+          << "not finished yet, including those of chunk runs that have not started. If a\n"
+          << "chunk has had neither a finished nor a temporary chunk file for this long then\n"
+          << "the merge fails. A merge always fails if a temporary chunk file is removed\n"
+          << "before its chunk run finishes.\n\n"
+          << "seconds: The new merge timeout in seconds, or off to wait forever.\n\n";
+}
+
+
+
+
+
+
+/*!
+ * Displays the help text for the settings set history command.
+ */
+void HelpRun::settingsSetHistoryHelp()
+{
+   // Create a text stream to standard output and print the settings set history
+   // command help text.
+   QTextStream stream(stdout);
+   stream << "Command: " << _runName << " settings set history <directory/off>\n"
+          << "Updates the metadata history store directory. The system metadata of every new\n"
+          << "data object only records each input data object by its uuid, command, and the\n"
+          << "SHA-256 hashes of its system and user metadata. If the history store is on\n"
+          << "then the full system and user metadata of every input data object is also saved\n"
+          << "in this directory in a file named by its hash, so the complete history of a\n"
+          << "data object can be followed back through the store.\n\n"
+          << "directory: The path to an existing directory used to store metadata history,\n"
+          << "           or off to disable the history store.\n\n";
+}
+
+
+
+
+
+
 /*!
  * Displays the help text for the settings set logging command.
  */
@@ -31,6 +31,7 @@ namespace Ace
       void runHelp();
       void chunkrunHelp();
       void mergeHelp();
+      void parallelrunHelp();
       void dumpHelp();
       void injectHelp();
       void analyticHelp();
@@ -39,10 +40,17 @@ namespace Ace
       void settingsSetCUDAHelp();
       void settingsSetOpenCLHelp();
       void settingsSetThreadsHelp();
+      void settingsSetCPUThreadsHelp();
       void settingsSetBufferHelp();
+      void settingsSetReduceHelp();
+      void settingsSetTimeoutHelp();
+      void settingsSetCheckpointHelp();
+      void settingsSetWindowHelp();
       void settingsSetChunkDirHelp();
       void settingsSetChunkPreHelp();
       void settingsSetChunkExtHelp();
+      void settingsSetMergeTimeoutHelp();
+      void settingsSetHistoryHelp();
       void settingsSetLoggingHelp();
       void settingsSetLogPortHelp();
       void settingsListHelp();
@@ -1,6 +1,9 @@
 #include "ace_run.h"
 #include <limits>
+#include <QCoreApplication>
 #include "../core/ace_analytic_abstractmanager.h"
+#include "../core/ace_analytic_chunk.h"
+#include "../core/ace_analytic_merge.h"
 #include "../core/eabstractanalyticfactory.h"
 #include "../core/eexception.h"
 #include "../core/edebug.h"
@@ -22,7 +25,7 @@ namespace Ace
  * Constructs a new run object with the given command arguments and options.
  *
  * @param command The command arguments, including the very first argument that
- *                should be run, chunkrun, or merge.
+ *                should be run, chunkrun, merge, or parallelrun.
  *
  * @param options The command line options used as input for the analytic being
  *                ran.
@@ -36,9 +39,15 @@ Run::Run(const Command& command, const Options& options)
    // Add the debug header.
    EDEBUG_FUNC(this,&command,&options);
 
-   // Setup the chunk run indexes and then setup this object's analytic manager.
+   // Setup the chunk run indexes and then setup this object's analytic manager. If
+   // this is a parallel run then spawn its chunk run processes.
    setupIndexes();
-   setupManager(getType());
+   quint16 type {getType()};
+   setupManager(type);
+   if ( _parallel )
+   {
+      setupWorkers(type);
+   }
 
    // .
    _start = std::chrono::system_clock::now();
@@ -50,11 +59,11 @@ Run::Run(const Command& command, const Options& options)
 
 
 /*!
- * Called when this object's analytic manager has made progress to a new percent
- * complete.
+ * Called when this object's analytic manager, or the chunk run processes of a
+ * parallel run, have made progress to a new percent complete.
  *
  * @param percentComplete The new percent complete out of 100 for this object's
- *                        analytic manager.
+ *                        analytic run.
  */
 void Run::progressed(int percentComplete)
 {
@@ -120,6 +129,126 @@ void Run::finished()
 
 
 
+/*!
+ * Called when one of this parallel run's chunk run processes has written to its
+ * standard output. Each complete line that reports a percent complete is used
+ * to update that process's progress, reporting the average progress of all
+ * processes if it has increased.
+ *
+ * @param index The chunk index of the process that has output to read.
+ */
+void Run::workerOutput(int index)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,index);
+
+   // Read every complete line of output from the given process, saving its percent
+   // complete if the line reports one.
+   QProcess* worker {_workers.at(index)};
+   while ( worker->canReadLine() )
+   {
+      QString line {QString::fromLocal8Bit(worker->readLine())};
+      bool ok;
+      int percent {line.left(line.indexOf('%')).toInt(&ok)};
+      if ( ok )
+      {
+         _workerProgress[index] = percent;
+      }
+   }
+
+   // Determine the average percent complete of all processes and report it if it has
+   // increased.
+   int total {0};
+   for (auto progress: qAsConst(_workerProgress))
+   {
+      total += progress;
+   }
+   total /= _workerProgress.size();
+   if ( total > _percentComplete && total < 100 )
+   {
+      _percentComplete = total;
+      progressed(total);
+   }
+}
+
+
+
+
+
+
+/*!
+ * Called when one of this parallel run's chunk run processes has finished. If
+ * the process failed then all other processes are stopped and an exception is
+ * thrown, else its chunk file is passed to this object's merge manager.
+ *
+ * @param index The chunk index of the process that finished.
+ *
+ * @param exitCode The exit code of the finished process.
+ *
+ * @param exitStatus The exit status of the finished process.
+ */
+void Run::workerFinished(int index, int exitCode, QProcess::ExitStatus exitStatus)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,index,exitCode,exitStatus);
+
+   // If the process crashed or returned a failure code then stop all other processes
+   // and throw an exception.
+   if ( exitStatus != QProcess::NormalExit || exitCode != 0 )
+   {
+      stopWorkers();
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Parallel Run Error"));
+      e.setDetails(tr("Chunk run process %1 failed with exit code %2, exiting...")
+                   .arg(index)
+                   .arg(exitCode));
+      throw e;
+   }
+
+   // Read any remaining output of the process and then mark its chunk file as
+   // finished for this object's merge manager.
+   workerOutput(index);
+   _merge->chunkFinished(index);
+}
+
+
+
+
+
+
+/*!
+ * Called when one of this parallel run's chunk run processes has an error. If
+ * the process failed to start then all other processes are stopped and an
+ * exception is thrown. Any other error is reported when the process finishes.
+ *
+ * @param index The chunk index of the process with an error.
+ *
+ * @param error The error of the process.
+ */
+void Run::workerError(int index, QProcess::ProcessError error)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,index,error);
+
+   // If the process failed to start then stop all other processes and throw an
+   // exception.
+   if ( error == QProcess::FailedToStart )
+   {
+      stopWorkers();
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Parallel Run Error"));
+      e.setDetails(tr("Failed starting chunk run process %1: %2")
+                   .arg(index)
+                   .arg(_workers.at(index)->errorString()));
+      throw e;
+   }
+}
+
+
+
+
+
+
 /*!
  * Convert and return the given number of seconds into a string in the format of
  * days, hours, minutes, and seconds.
@@ -196,6 +325,12 @@ void Run::setupIndexes()
       setupMerge();
    }
 
+   // Else if the command is parallel run then setup the parallel run.
+   else if ( command == QString("parallelrun") )
+   {
+      setupParallel();
+   }
+
    // Make sure there is an additional command argument naming the analytic to run
    // regardless of the type of run.
    if ( _command.size() < 1 )
@@ -305,6 +440,140 @@ void Run::setupMerge()
 
 
 
+/*!
+ * Initializes this analytic run as a parallel run, grabbing the number of
+ * chunk run processes from this object's command arguments. A parallel run is
+ * merged like a merge run but spawns its own chunk run processes. If only one
+ * process is given then this is simply a normal run.
+ */
+void Run::setupParallel()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Make sure there is a command argument to be processed.
+   if ( _command.size() < 1 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Invalid Argument"));
+      e.setDetails(tr("Size value not given for parallelrun, exiting..."));
+      throw e;
+   }
+
+   // Pop and read in the size argument, making sure it worked and is valid.
+   bool ok;
+   _size = _command.pop().toInt(&ok);
+   if ( !ok || _size < 1 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Invalid Argument"));
+      e.setDetails(tr("Given size for parallelrun is invalid, exiting..."));
+      throw e;
+   }
+
+   // If there is more than one process then set this object's index to -1 denoting
+   // a merge run and mark this as a parallel run.
+   if ( _size > 1 )
+   {
+      _index = -1;
+      _parallel = true;
+   }
+}
+
+
+
+
+
+
+/*!
+ * Spawns this parallel run's chunk run processes, one for every chunk index,
+ * as new instances of this program given the chunk run command with the given
+ * analytic type and this object's options. Each process is told how many
+ * processes share this system so they divide its CPU threads between them.
+ *
+ * @param type The analytic type every chunk run process runs.
+ */
+void Run::setupWorkers(quint16 type)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,type);
+
+   // Build the list of arguments shared by all chunk run processes, leaving the chunk
+   // index argument empty so it can be set for each process.
+   QStringList arguments
+   {
+      QStringLiteral("chunkrun")
+      ,QString()
+      ,QString::number(_size)
+      ,EAbstractAnalyticFactory::instance().commandName(type)
+   };
+   for (int i = 0; i < _options.size() ;++i)
+   {
+      arguments << QStringLiteral("--").append(_options.key(i)) << _options.value(i);
+   }
+
+   // Build the environment of all chunk run processes, adding the number of chunk
+   // runs sharing this system.
+   QProcessEnvironment environment {QProcessEnvironment::systemEnvironment()};
+   environment.insert(Analytic::Chunk::shareVariable,QString::number(_size));
+
+   // Iterate through all chunk indexes, spawning a chunk run process for each one.
+   // Standard error of each process is forwarded to this program's standard error
+   // and standard output is read for its progress.
+   _workers.resize(_size);
+   _workerProgress.fill(0,_size);
+   for (int i = 0; i < _size ;++i)
+   {
+      QProcess* worker {new QProcess(this)};
+      _workers[i] = worker;
+      worker->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+      worker->setProcessEnvironment(environment);
+      connect(worker,&QProcess::readyReadStandardOutput,this,[this,i]{ workerOutput(i); });
+      connect(worker
+              ,QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished)
+              ,this
+              ,[this,i](int exitCode, QProcess::ExitStatus exitStatus)
+               { workerFinished(i,exitCode,exitStatus); });
+      connect(worker
+              ,&QProcess::errorOccurred
+              ,this
+              ,[this,i](QProcess::ProcessError error){ workerError(i,error); });
+      arguments[1] = QString::number(i);
+      worker->start(QCoreApplication::applicationFilePath(),arguments);
+   }
+}
+
+
+
+
+
+
+/*!
+ * Stops all of this parallel run's chunk run processes that are still running,
+ * killing them and waiting for them to exit.
+ */
+void Run::stopWorkers()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Iterate through all chunk run processes, killing any that are still running.
+   for (auto worker: qAsConst(_workers))
+   {
+      if ( worker->state() != QProcess::NotRunning )
+      {
+         worker->disconnect(this);
+         worker->kill();
+         worker->waitForFinished();
+      }
+   }
+}
+
+
+
+
+
+
 /*!
  * Returns the analytic type based off the name given from this object's first
  * command argument. If no analytic can be found with the given command line
@@ -365,12 +634,26 @@ void Run::setupManager(quint16 type)
    EDEBUG_FUNC(this,type);
 
    // Create a new analytic manager with the given analytic type and this object's
-   // index and size, setting this as its parent.
-   _manager = Analytic::AbstractManager::makeManager(type,_index,_size).release();
+   // index and size, setting this as its parent. A parallel run always uses a merge
+   // manager that waits for its chunk run processes to finish.
+   if ( _parallel )
+   {
+      _merge = new Analytic::Merge(type,_size,true);
+      _manager = _merge;
+   }
+   else
+   {
+      _manager = Analytic::AbstractManager::makeManager(type,_index,_size).release();
+   }
    _manager->setParent(this);
 
-   // Connect all required signals to this run object.
-   connect(_manager,&Analytic::AbstractManager::progressed,this,&Run::progressed);
+   // Connect all required signals to this run object. A parallel run reports the
+   // average progress of its chunk run processes instead of its merge manager's,
+   // so only one figure is ever written.
+   if ( !_parallel )
+   {
+      connect(_manager,&Analytic::AbstractManager::progressed,this,&Run::progressed);
+   }
    connect(_manager,&Analytic::AbstractManager::done,this,&Run::done);
    connect(_manager,&Analytic::AbstractManager::finished,this,&Run::finished);
 
@@ -1,6 +1,8 @@
 #ifndef ACE_RUN_H
 #define ACE_RUN_H
 #include <QTextStream>
+#include <QProcess>
+#include <QVector>
 #include "../core/ace_analytic.h"
 #include "ace_options.h"
 #include "ace_command.h"
@@ -15,13 +17,16 @@ namespace Ace
 {
    /*!
     * This handles all run commands for the CLI program of ACE. These commands
-    * include run, chunk run, and merge. If MPI is being used it is auto detected
-    * by this class. The main responsibility of this class is to initialize an
-    * analytic manager and start its process of running the analytic. This class
-    * handles all input from the user, feeding it to the analytic manager to setup
-    * the analytic. This class is event driven and expects the qt event system to
-    * be running in order to function properly. When the analytic manager signals
-    * it is finished this class deletes itself and as a result deletes the manager.
+    * include run, chunk run, merge, and parallel run. If MPI is being used it is
+    * auto detected by this class. The main responsibility of this class is to
+    * initialize an analytic manager and start its process of running the analytic.
+    * This class handles all input from the user, feeding it to the analytic
+    * manager to setup the analytic. This class is event driven and expects the qt
+    * event system to be running in order to function properly. When the analytic
+    * manager signals it is finished this class deletes itself and as a result
+    * deletes the manager. A parallel run spawns chunk run processes of this
+    * program and streams their chunk files into a merge manager as each process
+    * finishes, reporting the average progress of the processes.
     */
    class Run : public QObject
    {
@@ -32,12 +37,18 @@ namespace Ace
       void progressed(int percentComplete);
       void done();
       void finished();
+      void workerOutput(int index);
+      void workerFinished(int index, int exitCode, QProcess::ExitStatus exitStatus);
+      void workerError(int index, QProcess::ProcessError error);
    private:
       static QString secondsToString(int seconds);
    private:
       void setupIndexes();
       void setupChunk();
       void setupMerge();
+      void setupParallel();
+      void setupWorkers(quint16 type);
+      void stopWorkers();
       quint16 getType();
       void setupManager(quint16 type);
       void addArguments();
@@ -73,6 +84,30 @@ namespace Ace
        * chunk or merge run.
        */
       int _size {1};
+      /*!
+       * True if this is a parallel run that spawns its own chunk run processes or
+       * false otherwise.
+       */
+      bool _parallel {false};
+      /*!
+       * Pointer to this object's analytic manager as a merge manager if this is a
+       * parallel run.
+       */
+      Analytic::Merge* _merge {nullptr};
+      /*!
+       * Pointer list of this parallel run's chunk run processes, where the index of
+       * each process is its chunk index.
+       */
+      QVector<QProcess*> _workers;
+      /*!
+       * The last percent complete reported by each of this parallel run's chunk run
+       * processes.
+       */
+      QVector<int> _workerProgress;
+      /*!
+       * The last total percent complete reported by this parallel run.
+       */
+      int _percentComplete {0};
       /*!
        */
       std::chrono::time_point<std::chrono::system_clock> _start;
@@ -53,10 +53,17 @@ void SettingsRun::execute()
       stream << "            CUDA Device: " << cudaDeviceString() << "\n";
       stream << "          OpenCL Device: " << openCLDeviceString() << "\n";
       stream << "CUDA/OpenCL Thread Size: " << QString::number(settings.threadSize()) << "\n";
+      stream << "        CPU Thread Size: " << cpuThreadString() << "\n";
       stream << "        MPI Buffer Size: " << QString::number(settings.bufferSize()) << "\n";
+      stream << "          MPI Reduction: " << ( settings.reductionEnabled() ? QStringLiteral("on") : QStringLiteral("off") ) << "\n";
+      stream << "            MPI Timeout: " << secondsString(settings.timeout()) << "\n";
+      stream << "MPI Checkpoint Interval: " << secondsString(settings.checkpointInterval()) << "\n";
+      stream << "            Window Size: " << windowString() << "\n";
       stream << "Chunk Working Directory: " << settings.chunkDir() << "\n";
       stream << "           Chunk Prefix: " << settings.chunkPrefix() << "\n";
       stream << "        Chunk Extension: " << settings.chunkExtension() << "\n";
+      stream << "          Merge Timeout: " << secondsString(settings.mergeTimeout()) << "\n";
+      stream << "      History Directory: " << ( settings.historyDir().isEmpty() ? QStringLiteral("off") : settings.historyDir() ) << "\n";
       stream << "                Logging: " << ( settings.loggingEnabled() ? QStringLiteral("on") : QStringLiteral("off") ) << "\n";
       stream << "           Logging Port: " << settings.loggingPort() << "\n";
    }
@@ -145,6 +152,25 @@ QString SettingsRun::cudaDeviceString()
 
 
 
+/*!
+ * Returns a string of the given number of seconds for a setting, where 0 means
+ * the setting is off.
+ *
+ * @param seconds The number of seconds of the setting.
+ *
+ * @return String of the given seconds or "off".
+ */
+QString SettingsRun::secondsString(int seconds)
+{
+   EDEBUG_FUNC(this,seconds);
+   return seconds > 0 ? QString::number(seconds) : QString("off");
+}
+
+
+
+
+
+
 /*!
  * Returns the OpenCL device setting as a string.
  *
@@ -178,6 +204,66 @@ QString SettingsRun::openCLDeviceString()
 
 
 
+/*!
+ * Returns the CPU thread size setting as a string.
+ *
+ * @return CPU thread size setting.
+ */
+QString SettingsRun::cpuThreadString()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Create the return string, setting it to "auto" as the default if the CPU thread
+   // size is determined automatically.
+   QString ret {"auto"};
+
+   // If a CPU thread size is set then overwrite the return string with its number.
+   int size {Ace::Settings::instance().cpuThreadSize()};
+   if ( size > 0 )
+   {
+      ret = QString::number(size);
+   }
+
+   // Return the string.
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * Returns the window size setting as a string.
+ *
+ * @return Window size setting.
+ */
+QString SettingsRun::windowString()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Create the return string, setting it to "auto" as the default if the window
+   // size is determined automatically.
+   QString ret {"auto"};
+
+   // If a window size is set then overwrite the return string with its number.
+   int size {Ace::Settings::instance().windowSize()};
+   if ( size > 0 )
+   {
+      ret = QString::number(size);
+   }
+
+   // Return the string.
+   return ret;
+}
+
+
+
+
+
+
 /*!
  * Executes the settings set command. This simply parses for which setting is to
  * be set and calls the appropriate method. If the setting is unknown then an
@@ -198,8 +284,8 @@ void SettingsRun::set()
    }
 
    // Create an enumeration and string list used to determine the command given.
-   enum {Unknown=-1,CUDACom,OpenCLCom,Threads,Buffer,ChunkDir,ChunkPre,ChunkExt,Logging,LogPort};
-   QStringList list {"cuda","opencl","threads","buffer","chunkdir","chunkpre","chunkext","logging","logport"};
+   enum {Unknown=-1,CUDACom,OpenCLCom,Threads,CPUThreads,Buffer,Reduce,Timeout,Checkpoint,Window,ChunkDir,ChunkPre,ChunkExt,MergeTimeout,History,Logging,LogPort};
+   QStringList list {"cuda","opencl","threads","cputhreads","buffer","reduce","timeout","checkpoint","window","chunkdir","chunkpre","chunkext","mergetimeout","history","logging","logport"};
 
    // Determine which setting is to be set by the command given, calling the
    // appropriate method and popping this object's first command argument.
@@ -215,9 +301,24 @@ void SettingsRun::set()
    case Threads:
       setThreads();
       break;
+   case CPUThreads:
+      setCPUThreads();
+      break;
    case Buffer:
       setBuffer();
       break;
+   case Reduce:
+      setReduce();
+      break;
+   case Timeout:
+      setTimeout();
+      break;
+   case Checkpoint:
+      setCheckpoint();
+      break;
+   case Window:
+      setWindow();
+      break;
    case ChunkDir:
       setChunkDir();
       break;
@@ -227,6 +328,12 @@ void SettingsRun::set()
    case ChunkExt:
       setChunkExt();
       break;
+   case MergeTimeout:
+      setMergeTimeout();
+      break;
+   case History:
+      setHistory();
+      break;
    case Logging:
       setLogging();
       break;
@@ -420,6 +527,55 @@ void SettingsRun::setThreads()
 
 
 
+/*!
+ * Executes the settings set cputhreads command, setting the global CPU thread
+ * size setting for ACE. The special "auto" string sets the CPU thread size to
+ * be determined automatically. If the new thread size given by the first
+ * command argument is invalid or less than one then an exception is thrown.
+ */
+void SettingsRun::setCPUThreads()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Make sure there is a command argument to process.
+   if ( _command.size() < 1 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid argument"));
+      e.setDetails(QObject::tr("Settings set cputhreads requires sub argument, exiting..."));
+      throw e;
+   }
+
+   // Create a new thread size, initializing it to 0 which assumes it is being set to
+   // automatic.
+   int size {0};
+
+   // Check to see if the command is something besides the special auto keyword.
+   if ( _command.first() != QString("auto") )
+   {
+      // Read in the new thread size as an integer, making sure it worked and the size
+      // is valid.
+      bool ok;
+      size = _command.first().toInt(&ok);
+      if ( !ok || size < 1 )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(QObject::tr("Invalid argument"));
+         e.setDetails(QObject::tr("Given CPU thread size '%1' invalid, exiting...").arg(_command.first()));
+         throw e;
+      }
+   }
+
+   // Set the new CPU thread size to ACE global settings.
+   Ace::Settings::instance().setCPUThreadSize(size);
+}
+
+
+
+
+
+
 /*!
  * Executes the settings set buffer command, setting the global buffer size
  * setting for ACE. If the new buffer size given by the first command argument
@@ -460,6 +616,173 @@ void SettingsRun::setBuffer()
 
 
 
+/*!
+ * Executes the settings set reduce command, setting the global MPI reduction
+ * enabled state for ACE.
+ */
+void SettingsRun::setReduce()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Make sure there is a command argument to process.
+   if ( _command.size() < 1 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid argument"));
+      e.setDetails(QObject::tr("Settings set reduce requires sub argument, exiting..."));
+      throw e;
+   }
+
+   // Set the state of MPI reduction to ACE global settings, using the on keyword to
+   // enable it or disable it if the argument is any other string.
+   Ace::Settings::instance().setReductionEnabled(_command.first() == QStringLiteral("on"));
+}
+
+
+
+
+
+
+/*!
+ * Executes the settings set timeout command, setting the global MPI timeout
+ * setting for ACE. The special "off" string disables the timeout. If the new
+ * timeout given by the first command argument is invalid or less than one then
+ * an exception is thrown.
+ */
+void SettingsRun::setTimeout()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Make sure there is a command argument to process.
+   if ( _command.size() < 1 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid argument"));
+      e.setDetails(QObject::tr("Settings set timeout requires sub argument, exiting..."));
+      throw e;
+   }
+
+   // Read in the new timeout as an integer unless it is the special off keyword,
+   // making sure it worked and the timeout is valid.
+   int seconds {0};
+   if ( _command.first() != QString("off") )
+   {
+      bool ok;
+      seconds = _command.first().toInt(&ok);
+      if ( !ok || seconds < 1 )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(QObject::tr("Invalid argument"));
+         e.setDetails(QObject::tr("Given timeout '%1' invalid, exiting...").arg(_command.first()));
+         throw e;
+      }
+   }
+
+   // Set the new timeout to ACE global settings.
+   Ace::Settings::instance().setTimeout(seconds);
+}
+
+
+
+
+
+
+/*!
+ * Executes the settings set checkpoint command, setting the global MPI
+ * checkpoint interval setting for ACE. The special "off" string disables
+ * checkpoints. If the new interval given by the first command argument is
+ * invalid or less than one then an exception is thrown.
+ */
+void SettingsRun::setCheckpoint()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Make sure there is a command argument to process.
+   if ( _command.size() < 1 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid argument"));
+      e.setDetails(QObject::tr("Settings set checkpoint requires sub argument, exiting..."));
+      throw e;
+   }
+
+   // Read in the new checkpoint interval as an integer unless it is the special off
+   // keyword, making sure it worked and the interval is valid.
+   int seconds {0};
+   if ( _command.first() != QString("off") )
+   {
+      bool ok;
+      seconds = _command.first().toInt(&ok);
+      if ( !ok || seconds < 1 )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(QObject::tr("Invalid argument"));
+         e.setDetails(QObject::tr("Given checkpoint interval '%1' invalid, exiting...").arg(_command.first()));
+         throw e;
+      }
+   }
+
+   // Set the new checkpoint interval to ACE global settings.
+   Ace::Settings::instance().setCheckpointInterval(seconds);
+}
+
+
+
+
+
+
+/*!
+ * Executes the settings set window command, setting the global window size
+ * setting for ACE. The special "auto" string sets the window size to be
+ * determined automatically. If the new window size given by the first command
+ * argument is invalid or less than one then an exception is thrown.
+ */
+void SettingsRun::setWindow()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Make sure there is a command argument to process.
+   if ( _command.size() < 1 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid argument"));
+      e.setDetails(QObject::tr("Settings set window requires sub argument, exiting..."));
+      throw e;
+   }
+
+   // Create a new window size, initializing it to 0 which assumes it is being set to
+   // automatic.
+   int size {0};
+
+   // Check to see if the command is something besides the special auto keyword.
+   if ( _command.first() != QString("auto") )
+   {
+      // Read in the new window size as an integer, making sure it worked and the size
+      // is valid.
+      bool ok;
+      size = _command.first().toInt(&ok);
+      if ( !ok || size < 1 )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(QObject::tr("Invalid argument"));
+         e.setDetails(QObject::tr("Given window size '%1' invalid, exiting...").arg(_command.first()));
+         throw e;
+      }
+   }
+
+   // Set the new window size to ACE global settings.
+   Ace::Settings::instance().setWindowSize(size);
+}
+
+
+
+
+
+
 /*!
  * Executes the setting set chunkdir command, setting the global chunk working
  * directory setting for ACE.
@@ -541,6 +864,85 @@ void SettingsRun::setChunkExt()
 
 
 
+/*!
+ * Executes the settings set mergetimeout command, setting the global merge
+ * timeout setting for ACE. The special "off" string disables the timeout. If
+ * the new timeout given by the first command argument is invalid or less than
+ * one then an exception is thrown.
+ */
+void SettingsRun::setMergeTimeout()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Make sure there is a command argument to process.
+   if ( _command.size() < 1 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid argument"));
+      e.setDetails(QObject::tr("Settings set mergetimeout requires sub argument, exiting..."));
+      throw e;
+   }
+
+   // Read in the new merge timeout as an integer unless it is the special off
+   // keyword, making sure it worked and the timeout is valid.
+   int seconds {0};
+   if ( _command.first() != QString("off") )
+   {
+      bool ok;
+      seconds = _command.first().toInt(&ok);
+      if ( !ok || seconds < 1 )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(QObject::tr("Invalid argument"));
+         e.setDetails(QObject::tr("Given merge timeout '%1' invalid, exiting...").arg(_command.first()));
+         throw e;
+      }
+   }
+
+   // Set the new merge timeout to ACE global settings.
+   Ace::Settings::instance().setMergeTimeout(seconds);
+}
+
+
+
+
+
+
+/*!
+ * Executes the setting set history command, setting the global metadata history
+ * directory setting for ACE. The special "off" string disables the history
+ * store.
+ */
+void SettingsRun::setHistory()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Make sure there is a command argument to process.
+   if ( _command.size() < 1 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid argument"));
+      e.setDetails(QObject::tr("Settings set history requires sub argument, exiting..."));
+      throw e;
+   }
+
+   // Set the new history directory to ACE global settings, clearing it if the special
+   // off keyword was given.
+   QString path {_command.first()};
+   if ( path == QString("off") )
+   {
+      path.clear();
+   }
+   Ace::Settings::instance().setHistoryDir(path);
+}
+
+
+
+
+
+
 /*!
  * Executes the setting set logging command, setting the global logging enabled
  * state for ACE.
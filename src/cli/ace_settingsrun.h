@@ -27,14 +27,24 @@ namespace Ace
       void settings();
       QString cudaDeviceString();
       QString openCLDeviceString();
+      QString cpuThreadString();
+      QString windowString();
+      QString secondsString(int seconds);
       void set();
       void setCUDA();
       void setOpenCL();
       void setThreads();
+      void setCPUThreads();
       void setBuffer();
+      void setReduce();
+      void setTimeout();
+      void setCheckpoint();
+      void setWindow();
       void setChunkDir();
       void setChunkPre();
       void setChunkExt();
+      void setMergeTimeout();
+      void setHistory();
       void setLogging();
       void setLogPort();
       void list();
@@ -146,8 +146,8 @@ int EApplication::exec()
       }
 
       // Create an enumeration and string list used to identify the command argument.
-      enum {Unknown = -1,Settings,Run,ChunkRun,Merge,Dump,Inject,Help};
-      QStringList commands {"settings","run","chunkrun","merge","dump","inject","help"};
+      enum {Unknown = -1,Settings,Run,ChunkRun,Merge,ParallelRun,Dump,Inject,Help};
+      QStringList commands {"settings","run","chunkrun","merge","parallelrun","dump","inject","help"};
 
       // Determine and execute which primary command is given.
       switch (_command.peek(commands))
@@ -164,6 +164,7 @@ int EApplication::exec()
       case Run:
       case ChunkRun:
       case Merge:
+      case ParallelRun:
          {
             // Initialize the run object.
             Ace::Run* run {new Ace::Run(_command,_options)};
@@ -184,8 +185,13 @@ int EApplication::exec()
                Ace::LogServer::log()->wait();
             }
 
-            // Start the analytic run.
+            // Start the analytic run, making sure all log messages have been written to the
+            // log clients once it is done.
             int ret {QCoreApplication::exec()};
+            if ( Ace::LogServer* log = Ace::LogServer::log() )
+            {
+               log->flush();
+            }
             Ace::QMPI::shutdown();
             return ret;
          }
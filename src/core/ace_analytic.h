@@ -22,13 +22,17 @@ namespace Ace
       class AbstractManager;
       class SimpleRun;
       class SerialRun;
+      class RunThread;
       class Single;
       class OpenCLRunThread;
       class OpenCLRun;
       class CUDARunThread;
       class CUDARun;
+      class ThreadPoolRunThread;
+      class ThreadPoolRun;
       class Chunk;
       class Merge;
+      class MergeThread;
       class AbstractMPI;
       class MPIMaster;
       class MPISlave;
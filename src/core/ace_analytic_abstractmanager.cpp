@@ -1,4 +1,7 @@
 #include "ace_analytic_abstractmanager.h"
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QDir>
 #include "ace_analytic_single.h"
 #include "ace_analytic_mpimaster.h"
 #include "ace_analytic_mpislave.h"
@@ -224,9 +227,10 @@ void AbstractManager::initialize()
    inputFiles();
    inputData();
 
-   // Clear the analytic input pointer, run the initialize interface of this
-   // manager's analytic, and prepare the start slot to be called once the event loop
-   // begins.
+   // Build the run key while the analytic input still exists, clear the analytic
+   // input pointer, run the initialize interface of this manager's analytic, and
+   // prepare the start slot to be called once the event loop begins.
+   _runKey = buildRunKey();
    _input = nullptr;
    _analytic->initialize();
    QTimer::singleShot(0,this,&AbstractManager::start);
@@ -839,7 +843,11 @@ EMetadata AbstractManager::buildMetaVersion()
 
 /*!
  * Builds the input section of the system metadata for new output data objects
- * with the given list of input data objects.
+ * with the given list of input data objects. Each input data object is only
+ * recorded by reference, so the system metadata of a data object does not grow
+ * with the length of the pipeline that made it. The record of each input has
+ * its uuid, its command, and the hashes of its system and user metadata. The
+ * full metadata of each input is saved to the history store if it is enabled.
  *
  * @param inputs List of input data objects used to build the metadata.
  *
@@ -854,18 +862,86 @@ EMetadata AbstractManager::buildMetaInput(const QList<Ace::DataObject*>& inputs)
    EMetadata ret(EMetadata::Object);
    for (auto input: inputs)
    {
-      // Create a new metadata object type, inserting the system and user keys for the
-      // system and user metadata of the input data object, and insert the new metadata
-      // object type into the return metadata object type using the input data object's
-      // raw path as the key.
+      // Create a new metadata object type, inserting the uuid and command of the input
+      // data object from its system metadata and the hashes of its system and user
+      // metadata, and insert the new metadata object type into the return metadata
+      // object type using the input data object's raw path as the key.
+      const EMetaObject& system {input->systemMeta().toObject()};
       EMetadata inputMeta(EMetadata::Object);
-      inputMeta.toObject().insert("system",input->systemMeta());
-      inputMeta.toObject().insert("user",input->userMeta());
+      inputMeta.toObject().insert("uuid",system.at("uuid"));
+      inputMeta.toObject().insert("command",system.at("command"));
+      inputMeta.toObject().insert("system",EMetadata(storeMeta(input->systemMeta())));
+      inputMeta.toObject().insert("user",EMetadata(storeMeta(input->userMeta())));
       ret.toObject().insert(input->rawPath(),inputMeta);
    }
 
    // Return the metadata object type containing a list of all input data objects
-   // with their corresponding system and user metadata.
+   // with their corresponding provenance records.
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * Returns the SHA-256 hash of the compact encoding of the given metadata as a
+ * hexadecimal string. If the history store is enabled and does not contain the
+ * given metadata yet then its encoding is saved to a file in the history store
+ * named by its hash, creating the history directory if it does not exist. If
+ * creating the directory or saving the file fails then an exception is thrown.
+ *
+ * @param meta The metadata that is hashed and saved.
+ *
+ * @return Hexadecimal SHA-256 hash of the given metadata.
+ */
+QString AbstractManager::storeMeta(const EMetadata& meta)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,&meta);
+
+   // Encode the given metadata and hash its encoding.
+   const QByteArray bytes {meta.encode()};
+   QString ret {QCryptographicHash::hash(bytes,QCryptographicHash::Sha256).toHex()};
+
+   // If the history store is disabled or already contains the metadata then return
+   // its hash, else go to the next step.
+   const QString dir {Settings::instance().historyDir()};
+   if ( dir.isEmpty() )
+   {
+      return ret;
+   }
+   const QString path {QDir(dir).filePath(ret + ".meta")};
+   if ( QFile::exists(path) )
+   {
+      return ret;
+   }
+
+   // Make sure the history directory exists, creating it and any missing parent
+   // directories. If creating it fails then throw an exception.
+   if ( !QDir().mkpath(dir) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("System Error"));
+      e.setDetails(tr("Failed creating metadata history directory %1.").arg(dir));
+      throw e;
+   }
+
+   // Save the encoded metadata to the history store, committing the file only once it
+   // is fully written. If saving fails then throw an exception.
+   QSaveFile file(path);
+   if ( !file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size() || !file.commit() )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("System Error"));
+      e.setDetails(tr("Failed saving metadata history file %1: %2")
+                   .arg(path)
+                   .arg(file.errorString()));
+      throw e;
+   }
+
+   // Return the hash of the metadata.
    return ret;
 }
 
@@ -909,6 +985,24 @@ EMetadata AbstractManager::buildMetaCommand()
 
 
 
+/*!
+ * Returns a hash of the analytic name and all command line arguments of this
+ * run, used to make sure files saved by one run are only used by the same run.
+ * This is only valid once this manager is initialized.
+ *
+ * @return Hash identifying this run.
+ */
+QByteArray AbstractManager::runKey() const
+{
+   EDEBUG_FUNC(this);
+   return _runKey;
+}
+
+
+
+
+
+
 /*!
  * Sets output data object arguments to this manager's abstract analytic input
  * object, opening the new data objects with the given system metadata in the
@@ -942,5 +1036,37 @@ void AbstractManager::inputDataOut(const EMetadata& system)
    }
 }
 
+
+
+
+
+
+/*!
+ * Builds the hash of the analytic name and all command line arguments of this
+ * run. This must be called before this manager's analytic input is cleared.
+ *
+ * @return Hash identifying this run.
+ */
+QByteArray AbstractManager::buildRunKey()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Hash the analytic name and every command line option with its value, returning
+   // the result.
+   EMetadata command {buildMetaCommand()};
+   EMetadata options {command.toObject().at("options")};
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+   hash.addData(command.toObject().at("analytic").toString().toUtf8());
+   for (auto i = options.toObject().cbegin(); i != options.toObject().cend() ;++i)
+   {
+      hash.addData("\n");
+      hash.addData(i.key().toUtf8());
+      hash.addData("=");
+      hash.addData(i->toString().toUtf8());
+   }
+   return hash.result();
+}
+
 }
 }
@@ -78,6 +78,8 @@ namespace Ace
          void writeResult(std::unique_ptr<EAbstractAnalyticBlock>&& result, int expectedIndex);
          EAbstractAnalytic* analytic();
          const EAbstractAnalytic* analytic() const;
+         EMetadata buildMetaCommand();
+         QByteArray runKey() const;
       protected slots:
          virtual void start();
       private:
@@ -91,8 +93,9 @@ namespace Ace
          EMetadata buildMeta(const QList<Ace::DataObject*>& inputs);
          EMetadata buildMetaVersion();
          EMetadata buildMetaInput(const QList<Ace::DataObject*>& inputs);
-         EMetadata buildMetaCommand();
+         QString storeMeta(const EMetadata& meta);
          void inputDataOut(const EMetadata& system);
+         QByteArray buildRunKey();
       private:
          /*!
           * The analytic type this manager uses.
@@ -120,6 +123,11 @@ namespace Ace
           * finished once this manager's analytic is finished.
           */
          QList<Ace::DataObject*> _outputData;
+         /*!
+          * Hash of the analytic name and all command line arguments of this run, made
+          * once all input is set.
+          */
+         QByteArray _runKey;
          /*!
           * The percent of blocks this manager has completed processing.
           */
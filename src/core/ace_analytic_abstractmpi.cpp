@@ -7,6 +7,7 @@
 #include "opencl_device.h"
 #include "eexception.h"
 #include "edebug.h"
+#include "eabstractanalyticblock.h"
 
 
 
@@ -98,6 +99,7 @@ void AbstractMPI::start()
       if ( _mpi.isMaster() )
       {
          analytic()->initializeOutputs();
+         mpiResume();
          ++i;
       }
 
@@ -148,9 +150,87 @@ void AbstractMPI::start()
 
 
 /*!
- * Called when this node received new data from the local MPI comm. The only
- * purpose for this is to send instructions for starting this node as a slave
- * with a given resource encoded within the data received.
+ * Makes a new result block from this manager's analytic and reads the given
+ * data into it. If the analytic fails making a result block then an exception
+ * is thrown.
+ *
+ * @param data The data containing the result block.
+ *
+ * @return The new result block.
+ */
+std::unique_ptr<EAbstractAnalyticBlock> AbstractMPI::makeResult(const QByteArray& data)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,data);
+
+   // Create a blank result block from this object's analytic, making sure it worked,
+   // and read in the given data to it.
+   std::unique_ptr<EAbstractAnalyticBlock> ret {analytic()->makeResult()};
+   if ( !ret )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Logic Error"));
+      e.setDetails(tr("Analytic returned null result block pointer."));
+      throw e;
+   }
+   ret->fromBytes(data);
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * This interface is called on the master node once its analytic's outputs are
+ * initialized and before any slave node is started, so a previous run can be
+ * resumed. The default implementation does nothing.
+ */
+void AbstractMPI::mpiResume()
+{
+   EDEBUG_FUNC(this);
+}
+
+
+
+
+
+
+/*!
+ * This interface is called when this node receives a result batch from another
+ * node on its system through the local MPI comm. The default implementation
+ * throws an exception because only slave nodes that gather results receive
+ * them.
+ *
+ * @param data The data containing the result batch.
+ *
+ * @param fromRank The local rank of the node that sent the result batch.
+ */
+void AbstractMPI::localResultsReceived(const QByteArray& data, int fromRank)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,data,fromRank);
+
+   // Throw an exception.
+   Q_UNUSED(data)
+   Q_UNUSED(fromRank)
+   E_MAKE_EXCEPTION(e);
+   e.setTitle(tr("Logic Error"));
+   e.setDetails(tr("Received MPI result batch on node that does not gather results."));
+   throw e;
+}
+
+
+
+
+
+
+/*!
+ * Called when this node received new data from the local MPI comm. This is
+ * either a result batch from another node on this system or instructions for
+ * starting this node as a slave with a given resource encoded within the data
+ * received.
  *
  * @param data The data received from a slave node.
  *
@@ -162,9 +242,16 @@ void AbstractMPI::localDataReceived(const QByteArray& data, int fromRank)
    // Add the debug header.
    EDEBUG_FUNC(this,data,fromRank);
 
+   // If the given data is a result batch then pass it to the local results received
+   // interface and exit, else go to the next step.
+   if ( EAbstractAnalyticBlock::extractIndex(data) == ResultBatch )
+   {
+      localResultsReceived(data,fromRank);
+      return;
+   }
+
    // If this node has already been started then throw an exception, else go to the
    // next step.
-   Q_UNUSED(fromRank)
    if ( _started )
    {
       E_MAKE_EXCEPTION(e);
@@ -79,11 +79,46 @@ namespace Ace
              * node to signal it is ready to execute work blocks using a CUDA run object.
              */
             ,ReadyAsCUDA = -4
+            /*!
+             * Defines the ready as thread pool code which is sent to the master node by a
+             * slave node to signal it is ready to execute work blocks using a thread pool
+             * run object. The number of threads the slave node uses follows this code.
+             */
+            ,ReadyAsThreadPool = -5
+            /*!
+             * Defines the work batch code which is sent to a slave node with a run of work
+             * blocks that have contiguous indexes. Each work block follows this code as a
+             * byte array.
+             */
+            ,WorkBatch = -6
+            /*!
+             * Defines the result batch code which is sent to the master node with any
+             * number of result blocks. Each result block follows this code as a byte
+             * array. This also signals the slave node wants more work blocks.
+             */
+            ,ResultBatch = -7
+            /*!
+             * Defines the work range code which is sent to a slave node with the first
+             * index and number of a run of work blocks it makes itself. This is only used
+             * if the analytic can make work blocks on any node.
+             */
+            ,WorkRange = -8
+            /*!
+             * Defines the gathered batch code which is sent to the master node by the
+             * local leader of a system with the result blocks of all slave nodes on that
+             * system. The number of slave nodes follows this code, then the rank and
+             * number of finished work blocks of each one, and then the number of indexes
+             * and byte array of each result block.
+             */
+            ,GatheredBatch = -9
          };
       protected:
          virtual void mpiStart(Type type, int platform, int device);
+         virtual void localResultsReceived(const QByteArray& data, int fromRank);
+         virtual void mpiResume();
       protected:
          explicit AbstractMPI(quint16 type);
+         std::unique_ptr<EAbstractAnalyticBlock> makeResult(const QByteArray& data);
       protected slots:
          virtual void start() override final;
       private slots:
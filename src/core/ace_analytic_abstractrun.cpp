@@ -1,4 +1,5 @@
 #include "ace_analytic_abstractrun.h"
+#include "ace_settings.h"
 #include "edebug.h"
 
 
@@ -13,6 +14,23 @@ namespace Analytic
 
 
 
+/*!
+ * This interface returns the number of work blocks this abstract run can
+ * process at the same time. The default implementation returns 1.
+ *
+ * @return Number of work blocks this abstract run processes at once.
+ */
+int AbstractRun::capacity() const
+{
+   EDEBUG_FUNC(this);
+   return 1;
+}
+
+
+
+
+
+
 /*!
  * Constructs a new abstract run object with an optional parent.
  *
@@ -25,5 +43,35 @@ AbstractRun::AbstractRun(QObject* parent)
    EDEBUG_FUNC(this,parent);
 }
 
+
+
+
+
+
+/*!
+ * Returns the maximum number of blocks a manager should have in flight with
+ * this abstract run at any one time. Blocks in flight are work blocks given to
+ * this run that have not been executed plus result blocks waiting to be
+ * written in order. If the global window size setting is automatic then this
+ * is twice the sum of this run's capacity and the global buffer size.
+ *
+ * @return Maximum number of blocks in flight with this abstract run.
+ */
+int AbstractRun::windowSize() const
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Use the window size setting if it is set, else determine it from this run's
+   // capacity and the buffer size setting.
+   Settings& settings {Settings::instance()};
+   int ret {settings.windowSize()};
+   if ( ret < 1 )
+   {
+      ret = 2*(capacity() + settings.bufferSize());
+   }
+   return ret;
+}
+
 }
 }
@@ -37,8 +37,10 @@ namespace Ace
           * @param block Block of work that is added to this abstract run for processing.
           */
          virtual void addWork(std::unique_ptr<EAbstractAnalyticBlock>&& block) = 0;
+         virtual int capacity() const;
       public:
          explicit AbstractRun(QObject* parent = nullptr);
+         int windowSize() const;
       signals:
          /*!
           * Signals that this abstract run has finished processing all blocks.
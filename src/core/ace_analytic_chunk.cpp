@@ -1,6 +1,9 @@
 #include "ace_analytic_chunk.h"
 #include <QTimer>
+#include <QFile>
+#include <QDataStream>
 #include "ace_analytic_serialrun.h"
+#include "ace_analytic_threadpoolrun.h"
 #include "ace_analytic_openclrun.h"
 #include "ace_analytic_cudarun.h"
 #include "ace_settings.h"
@@ -20,6 +23,13 @@ namespace Analytic
 
 
 
+/*!
+ * The name of the chunk run share environment variable.
+ */
+const char* Chunk::shareVariable {"ACE_CHUNK_SHARE"};
+
+
+
 
 
 
@@ -43,6 +53,252 @@ bool Chunk::isFinished() const
 
 
 
+/*!
+ * Returns the path of the complete chunk file for the given chunk index, as
+ * determined by the global settings.
+ *
+ * @param index The chunk index whose chunk file path is returned.
+ *
+ * @return Path of the complete chunk file for the given chunk index.
+ */
+QString Chunk::path(int index)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(index);
+
+   // Build the chunk file path from the global settings object.
+   Settings& settings {Settings::instance()};
+   return settings.chunkDir().append("/")
+                             .append(settings.chunkPrefix())
+                             .append(QString::number(index))
+                             .append(".")
+                             .append(settings.chunkExtension());
+}
+
+
+
+
+
+
+/*!
+ * Writes a chunk file header to the given data stream with the given analytic
+ * type, run key, chunk index, and range of block indexes.
+ *
+ * @param stream The data stream the header is written to.
+ *
+ * @param type The analytic type of the chunk run.
+ *
+ * @param key The run key of the chunk run.
+ *
+ * @param index The chunk index of the chunk run.
+ *
+ * @param begin The first block index of the chunk run.
+ *
+ * @param end The block index after the last of the chunk run.
+ */
+void Chunk::writeHeader(QDataStream& stream, quint16 type, const QByteArray& key, int index, int begin, int end)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(&stream,type,key,index,begin,end);
+
+   // Write the header values.
+   stream << qint64 {_fileMagic}
+          << quint8 {_fileVersion}
+          << type
+          << key
+          << qint32 {index}
+          << qint32 {begin}
+          << qint32 {end};
+}
+
+
+
+
+
+
+/*!
+ * Reads a chunk file header from the given data stream, testing if it matches
+ * the given analytic type, run key, chunk index, and range of block indexes.
+ *
+ * @param stream The data stream the header is read from.
+ *
+ * @param type The expected analytic type.
+ *
+ * @param key The expected run key.
+ *
+ * @param index The expected chunk index.
+ *
+ * @param begin The expected first block index.
+ *
+ * @param end The expected block index after the last.
+ *
+ * @return True if the header was read and matches or false otherwise.
+ */
+bool Chunk::readHeader(QDataStream& stream, quint16 type, const QByteArray& key, int index, int begin, int end)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(&stream,type,key,index,begin,end);
+
+   // Read the header values and return if they all match.
+   qint64 magic;
+   quint8 version;
+   quint16 fileType;
+   QByteArray fileKey;
+   qint32 fileIndex;
+   qint32 fileBegin;
+   qint32 fileEnd;
+   stream >> magic >> version >> fileType >> fileKey >> fileIndex >> fileBegin >> fileEnd;
+   return stream.status() == QDataStream::Ok
+          && magic == _fileMagic
+          && version == _fileVersion
+          && fileType == type
+          && fileKey == key
+          && fileIndex == index
+          && fileBegin == begin
+          && fileEnd == end;
+}
+
+
+
+
+
+
+/*!
+ * Writes a chunk file record of the given result block data to the given data
+ * stream, followed by its checksum.
+ *
+ * @param stream The data stream the record is written to.
+ *
+ * @param index The block index of the result block.
+ *
+ * @param data The result block data.
+ */
+void Chunk::writeRecord(QDataStream& stream, int index, const QByteArray& data)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(&stream,index,data);
+
+   // Write the record values.
+   stream << qint32 {index}
+          << data
+          << qChecksum(data.constData(),static_cast<uint>(data.size()));
+}
+
+
+
+
+
+
+/*!
+ * Reads a chunk file record from the given data stream, testing its checksum.
+ *
+ * @param stream The data stream the record is read from.
+ *
+ * @param index Set to the block index of the read result block.
+ *
+ * @param data Set to the read result block data.
+ *
+ * @return True if the record was read and its checksum matches or false
+ *         otherwise.
+ */
+bool Chunk::readRecord(QDataStream& stream, qint32& index, QByteArray& data)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(&stream,index,data);
+
+   // Read the record values and return if the checksum matches.
+   quint16 checksum;
+   stream >> index >> data >> checksum;
+   return stream.status() == QDataStream::Ok
+          && checksum == qChecksum(data.constData(),static_cast<uint>(data.size()));
+}
+
+
+
+
+
+
+/*!
+ * Writes a chunk file table of the given entries to the given data stream at
+ * its current position, followed by the trailer.
+ *
+ * @param stream The data stream the table is written to.
+ *
+ * @param table The block index and file offset of every record.
+ */
+void Chunk::writeTable(QDataStream& stream, const QVector<Entry>& table)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(&stream,&table);
+
+   // Write every table entry and then the trailer.
+   qint64 offset {stream.device()->pos()};
+   for (const auto& entry: table)
+   {
+      stream << entry.first << entry.second;
+   }
+   stream << offset << qint32 {table.size()} << qint64 {_fileMagic};
+}
+
+
+
+
+
+
+/*!
+ * Reads a chunk file table from the given data stream using its trailer,
+ * testing that it contains the given number of entries.
+ *
+ * @param stream The data stream the table is read from.
+ *
+ * @param size The expected number of table entries.
+ *
+ * @param table Set to the block index and file offset of every record.
+ *
+ * @return True if the table was read and contains the expected number of
+ *         entries or false otherwise.
+ */
+bool Chunk::readTable(QDataStream& stream, int size, QVector<Entry>& table)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(&stream,size,&table);
+
+   // Read the trailer from the end of the stream's device, making sure it is valid
+   // and its table is where it says.
+   QIODevice* device {stream.device()};
+   qint64 end {device->size() - _trailerSize};
+   if ( end < 0 || !device->seek(end) )
+   {
+      return false;
+   }
+   qint64 offset;
+   qint32 count;
+   qint64 magic;
+   stream >> offset >> count >> magic;
+   if ( stream.status() != QDataStream::Ok
+        || magic != _fileMagic
+        || count != size
+        || offset < 0
+        || offset + count*_entrySize != end
+        || !device->seek(offset) )
+   {
+      return false;
+   }
+
+   // Read every table entry and return if that worked.
+   table.resize(count);
+   for (auto& entry: table)
+   {
+      stream >> entry.first >> entry.second;
+   }
+   return stream.status() == QDataStream::Ok;
+}
+
+
+
+
+
+
 /*!
  * Constructs a new chunk manager with the given analytic type, chunk index, and
  * chunk size.
@@ -142,13 +398,12 @@ void Chunk::saveResult(std::unique_ptr<EAbstractAnalyticBlock>&& result)
 {
    EDEBUG_FUNC(this,result.get())
 
-   // save the given result block to the temporary binary file deleting it and
-   // increment the next result. If any write error to the file occurs then throw an
-   // exception.
-   QByteArray data {result->toBytes()};
+   // save the given result block to the temporary binary file as a record, adding
+   // it to the table, deleting it and increment the next result. If any write error
+   // to the file occurs then throw an exception.
+   _table << Entry(result->index(),_file->pos());
+   writeRecord(*_stream,result->index(),result->toBytes());
    result.reset();
-   *_stream << data.size();
-   _stream->device()->write(data);
    ++_nextResult;
    if ( _stream->status() != QDataStream::Ok )
    {
@@ -160,12 +415,27 @@ void Chunk::saveResult(std::unique_ptr<EAbstractAnalyticBlock>&& result)
       throw e;
    }
 
+   // If this was the last result block then complete this chunk's file.
+   if ( isFinished() )
+   {
+      closeFile();
+   }
+
    int percentComplete {static_cast<int>(static_cast<qint64>(_nextResult - _begin)*100/(_end - _begin))};
    if ( percentComplete != _percentComplete )
    {
       _percentComplete = percentComplete;
       emit progressed(_percentComplete);
    }
+
+   // If there is more work to add then schedule this object's process slot to be
+   // called if it is not already, since saving this result made room in this
+   // manager's window of blocks in flight.
+   if ( !_scheduled && _nextWork < _end )
+   {
+      _scheduled = true;
+      QTimer::singleShot(0,this,&Chunk::process);
+   }
 }
 
 
@@ -198,8 +468,10 @@ void Chunk::start()
    connect(_runner,&AbstractRun::finished,this,&AbstractManager::finish);
 
    // .
-   setupFile();
    setupIndexes();
+   setupFile();
+   _window = _runner->windowSize();
+   _scheduled = true;
    QTimer::singleShot(0,this,&Chunk::process);
 }
 
@@ -210,23 +482,39 @@ void Chunk::start()
 
 /*!
  * Processes the work blocks this chunk manager is responsible for saving,
- * adding them to this manager's abstract run object for processing.
+ * adding them to this manager's abstract run object for processing until this
+ * manager's window of blocks in flight is full. Work blocks whose result block
+ * was recovered from a previous run are skipped. This is called again each
+ * time a result is saved and there is more work to add.
  */
 void Chunk::process()
 {
    EDEBUG_FUNC(this);
 
-   if ( _nextWork >= _end )
+   // While this manager still has work block indexes to process and the number of
+   // blocks in flight is less than this manager's window make the next work block
+   // and add it to this manager's abstract run object. A recovered block index is
+   // counted as saved instead.
+   _scheduled = false;
+   while ( _nextWork < _end && _nextWork - _nextResult < _window )
    {
-      emit _runner->finished();
-      return;
+      if ( _done.at(_nextWork - _begin) )
+      {
+         ++_nextWork;
+         ++_nextResult;
+         continue;
+      }
+      _runner->addWork(makeWork(_nextWork++));
    }
 
-   // While this manager still has work block indexes to process make the next work
-   // block and add it to this manager's abstract run object.
-   while ( _nextWork < _end )
+   // If this chunk has no work blocks left to save and its file was not already
+   // completed by saving the last result block, because it has none at all or the
+   // rest were recovered, then complete its file and signal it is finished. If the
+   // last result block was saved then the abstract run object has already signaled.
+   if ( isFinished() && !_closed )
    {
-      _runner->addWork(makeWork(_nextWork++));
+      closeFile();
+      emit _runner->finished();
    }
 }
 
@@ -236,26 +524,26 @@ void Chunk::process()
 
 
 /*!
- * Opens this chunk manager's temporary binary file as write only and truncated.
- * This also creates this manager's qt data stream used for file output. If
+ * Opens this chunk manager's temporary binary file for reading and writing.
+ * This also creates this manager's qt data stream used for file output. If the
+ * file is left from an interrupted run of this same chunk then its valid
+ * records are recovered, else it is truncated and a new header is written. If
  * opening fails then an exception is thrown.
  */
 void Chunk::setupFile()
 {
    EDEBUG_FUNC(this)
 
-   // Determine this chunk's file name from the global settings object.
-   Settings& settings {Settings::instance()};
-   _fileName = settings.chunkDir().append("/")
-                                  .append(settings.chunkPrefix())
-                                  .append(QString::number(_index))
-                                  .append(".")
-                                  .append(settings.chunkExtension());
+   // Determine this chunk's final path and temporary file name, removing any complete
+   // chunk file left by a previous run so it is never mistaken as finished.
+   _path = path(_index);
+   _fileName = _path + QStringLiteral(".tmp");
+   QFile::remove(_path);
 
-   // Create a new qt file and open this chunk's file as write only and truncate. If
+   // Create a new qt file and open this chunk's file for reading and writing. If
    // opening fails then throw an exception, else go to the next step.
    _file = new QFile(_fileName,this);
-   if ( !_file->open(QIODevice::WriteOnly|QIODevice::Truncate) )
+   if ( !_file->open(QIODevice::ReadWrite) )
    {
       E_MAKE_EXCEPTION(e);
       e.setTitle(tr("Open Error"));
@@ -265,10 +553,117 @@ void Chunk::setupFile()
       throw e;
    }
 
-   // Save the file name of this chunk's binary file and create a new qt data stream
-   // from the open file.
-   _fileName = QFileInfo(_fileName).fileName();
+   // Create a new qt data stream from the open file. If nothing can be recovered from
+   // the file then truncate it and write a new header.
    _stream = new QDataStream(_file);
+   _done.fill(false,qMax(_end - _begin,0));
+   if ( !recoverFile() )
+   {
+      _file->resize(0);
+      _file->seek(0);
+      writeHeader(*_stream,analyticType(),runKey(),_index,_begin,_end);
+   }
+
+   // Save the file name of this chunk's binary file.
+   _fileName = QFileInfo(_fileName).fileName();
+}
+
+
+
+
+
+
+/*!
+ * Recovers every valid record from this chunk manager's temporary binary file
+ * if it has a header matching this chunk, marking their block indexes as done.
+ * Anything after the last valid record is removed.
+ *
+ * @return True if the file had a matching header or false otherwise.
+ */
+bool Chunk::recoverFile()
+{
+   EDEBUG_FUNC(this)
+
+   // If the file does not begin with a header matching this chunk then there is
+   // nothing to recover.
+   if ( !readHeader(*_stream,analyticType(),runKey(),_index,_begin,_end) )
+   {
+      _stream->resetStatus();
+      return false;
+   }
+
+   // Read records until the end of the file or one is invalid, out of range, or a
+   // duplicate, marking each valid one as done and adding it to the table.
+   qint64 valid {_file->pos()};
+   while ( !_file->atEnd() )
+   {
+      qint32 index;
+      QByteArray data;
+      if ( !readRecord(*_stream,index,data)
+           || index < _begin
+           || index >= _end
+           || _done.at(index - _begin) )
+      {
+         break;
+      }
+      _done[index - _begin] = true;
+      _table << Entry(index,valid);
+      valid = _file->pos();
+   }
+
+   // Remove anything after the last valid record so new records are appended to it.
+   _stream->resetStatus();
+   _file->resize(valid);
+   _file->seek(valid);
+   return true;
+}
+
+
+
+
+
+
+/*!
+ * Writes the table to this chunk manager's temporary binary file, closes it,
+ * and renames it to its final path, marking it as complete. If the file is
+ * already complete then this does nothing. If writing or renaming fails then
+ * an exception is thrown.
+ */
+void Chunk::closeFile()
+{
+   EDEBUG_FUNC(this)
+
+   // If the file is already complete then there is nothing to do.
+   if ( _closed )
+   {
+      return;
+   }
+
+   // Write the table of all records to the end of the file. If any write error to the
+   // file occurs then throw an exception.
+   writeTable(*_stream,_table);
+   if ( _stream->status() != QDataStream::Ok )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Write Error"));
+      e.setDetails(tr("Failed writing to temporary chunk file %1: %2")
+                   .arg(_fileName)
+                   .arg(_file->errorString()));
+      throw e;
+   }
+
+   // Rename the temporary file to its final path, which also closes it. If renaming
+   // fails then throw an exception.
+   if ( !_file->rename(_path) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Write Error"));
+      e.setDetails(tr("Failed renaming temporary chunk file %1: %2")
+                   .arg(_fileName)
+                   .arg(_file->errorString()));
+      throw e;
+   }
+   _closed = true;
 }
 
 
@@ -389,11 +784,20 @@ bool Chunk::setupSerial()
    bool ret {false};
 
    // If this manager's analytic creates a valid abstract serial object then create a
-   // new serial run object and set it to this object's run pointer, else throw an
-   // exception.
+   // new thread pool run object if more than one CPU thread is available or a new
+   // serial run object otherwise and set it to this object's run pointer. The CPU
+   // threads are divided between all chunk runs sharing this system if known.
    if ( EAbstractAnalyticSerial* serial = analytic()->makeSerial() )
    {
-      _runner = new SerialRun(serial,this,this);
+      int size {ThreadPoolRun::size(qEnvironmentVariableIntValue(shareVariable))};
+      if ( size > 1 )
+      {
+         _runner = new ThreadPoolRun(analytic(),serial,size,this,this);
+      }
+      else
+      {
+         _runner = new SerialRun(serial,this,this);
+      }
       ret = true;
    }
 
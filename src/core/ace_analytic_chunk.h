@@ -1,5 +1,7 @@
 #ifndef ACE_ANALYTIC_CHUNK_H
 #define ACE_ANALYTIC_CHUNK_H
+#include <QVector>
+#include <QPair>
 #include "ace_analytic_abstractmanager.h"
 #include "ace_analytic_abstractinput.h"
 #include "ace_analytic.h"
@@ -27,11 +29,40 @@ namespace Ace
        * process into result blocks based off the index and size it is given. From
        * there it processes the chunk of blocks and saved them into a temporary binary
        * file. The location and file name of the chunk is determined by global
-       * settings and the index of this chunk manager.
+       * settings and the index of this chunk manager. The chunk file is written under
+       * a temporary name and only given its final name once it is complete, so a
+       * merge can tell which chunk files are finished while chunk runs still execute.
+       *
+       * A chunk file begins with a header of its analytic type, run key, chunk index,
+       * and range of block indexes. Each result block is saved as a record of its
+       * index, data, and checksum in the order it is received. Once complete a table
+       * of every record's index and file offset is appended, followed by a trailer of
+       * the table offset, record count, and file magic number. If a chunk run is
+       * started again with an incomplete chunk file of the same run then every valid
+       * record is kept and only the missing result blocks are processed.
        */
       class Chunk : public AbstractManager, public AbstractInput
       {
          Q_OBJECT
+      public:
+         /*!
+          * The name of the environment variable that, if set, gives the number of chunk
+          * run processes sharing this system's CPU cores.
+          */
+         static const char* shareVariable;
+      public:
+         /*!
+          * A chunk file record's block index and file offset.
+          */
+         using Entry = QPair<qint32,qint64>;
+      public:
+         static QString path(int index);
+         static void writeHeader(QDataStream& stream, quint16 type, const QByteArray& key, int index, int begin, int end);
+         static bool readHeader(QDataStream& stream, quint16 type, const QByteArray& key, int index, int begin, int end);
+         static void writeRecord(QDataStream& stream, int index, const QByteArray& data);
+         static bool readRecord(QDataStream& stream, qint32& index, QByteArray& data);
+         static void writeTable(QDataStream& stream, const QVector<Entry>& table);
+         static bool readTable(QDataStream& stream, int size, QVector<Entry>& table);
       public:
          virtual bool isFinished() const override final;
       public:
@@ -46,11 +77,29 @@ namespace Ace
          void process();
       private:
          void setupFile();
+         bool recoverFile();
+         void closeFile();
          void setupIndexes();
          bool setupCUDA();
          bool setupOpenCL();
          bool setupSerial();
       private:
+         /*!
+          * Magic number identifying a chunk file, which is ASCII "ACECHUNK".
+          */
+         constexpr static qint64 _fileMagic {0x4143454348554E4B};
+         /*!
+          * Format version of chunk files.
+          */
+         constexpr static quint8 _fileVersion {1};
+         /*!
+          * Size in bytes of the trailer at the end of a complete chunk file.
+          */
+         constexpr static qint64 _trailerSize {20};
+         /*!
+          * Size in bytes of a single entry in a chunk file's table.
+          */
+         constexpr static qint64 _entrySize {12};
          /*!
           * The chunk index for this chunk manager.
           */
@@ -68,6 +117,22 @@ namespace Ace
           * result blocks.
           */
          QString _fileName;
+         /*!
+          * The final path of this chunk manager's temporary binary file once it is
+          * complete.
+          */
+         QString _path;
+         /*!
+          * The block index and file offset of every record saved to this chunk manager's
+          * temporary binary file.
+          */
+         QVector<Entry> _table;
+         /*!
+          * Flags for every block index of this chunk manager, relative to its first,
+          * that is true if its result block was recovered from a previous run or false
+          * otherwise.
+          */
+         QVector<bool> _done;
          /*!
           * Pointer to the qt file of this chunk manager's temporary binary file.
           */
@@ -97,6 +162,21 @@ namespace Ace
          /*!
           */
          int _percentComplete;
+         /*!
+          * The maximum number of blocks this manager keeps in flight, counting work
+          * blocks not yet executed and saved.
+          */
+         int _window {1};
+         /*!
+          * True if this manager's process slot has been scheduled to be called or false
+          * otherwise.
+          */
+         bool _scheduled {false};
+         /*!
+          * True if this manager's temporary binary file has been completed and renamed
+          * to its final path or false otherwise.
+          */
+         bool _closed {false};
       };
    }
 }
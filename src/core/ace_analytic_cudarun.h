@@ -36,6 +36,7 @@ namespace Ace
          Q_OBJECT
       public:
          virtual void addWork(std::unique_ptr<EAbstractAnalyticBlock>&& block) override final;
+         virtual int capacity() const override final;
       public:
          explicit CUDARun(EAbstractAnalyticCUDA* cuda, CUDA::Device* device, AbstractInput* base, QObject* parent = nullptr);
          virtual ~CUDARun() override final;
@@ -64,6 +65,10 @@ namespace Ace
           * Queue of idle threads ready to execute another work block.
           */
          QQueue<CUDARunThread*> _idle;
+         /*!
+          * Queue of work blocks waiting for an idle thread.
+          */
+         QQueue<EAbstractAnalyticBlock*> _work;
       };
    }
 }
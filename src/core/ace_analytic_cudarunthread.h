@@ -1,6 +1,6 @@
 #ifndef ACE_ANALYTIC_CUDARUNTHREAD_H
 #define ACE_ANALYTIC_CUDARUNTHREAD_H
-#include <QThread>
+#include "ace_analytic_runthread.h"
 #include "ace_analytic_cudarun.h"
 #include "global.h"
 
@@ -26,23 +26,16 @@ namespace Ace
        * separate thread to enhance speed. An abstract CUDA worker object is used for
        * actual processing using a CUDA device for acceleration.
        */
-      class CUDARunThread : public QThread
+      class CUDARunThread : public RunThread
       {
          Q_OBJECT
       public:
          explicit CUDARunThread(CUDA::Context* context, std::unique_ptr<EAbstractAnalyticCUDAWorker>&& worker, QObject* parent = nullptr);
-         void execute(std::unique_ptr<EAbstractAnalyticBlock>&& block);
-         std::unique_ptr<EAbstractAnalyticBlock> result();
-      signals:
-         /*!
-          */
-         void blockFinished();
+         using RunThread::execute;
       protected:
-         virtual void run() override final;
+         virtual void initialize() override final;
+         virtual std::unique_ptr<EAbstractAnalyticBlock> execute(const EAbstractAnalyticBlock* block) override final;
       private:
-         /*!
-          */
-         QAtomicInteger<int> _switch {0};
          /*!
           * Pointer to the CUDA context used by this CUDA run object.
           */
@@ -52,20 +45,6 @@ namespace Ace
           * result blocks using CUDA acceleration.
           */
          EAbstractAnalyticCUDAWorker* _worker;
-         /*!
-          * Pointer to saved work block, if any, passed along to the separate thread for
-          * processing.
-          */
-         EAbstractAnalyticBlock* _work {nullptr};
-         /*!
-          * Pointer to result block, if any, saved by this object's separate thread.
-          */
-         EAbstractAnalyticBlock* _result {nullptr};
-         /*!
-          * Pointer to any exception that occurs on this object's separate thread while
-          * processing a work block.
-          */
-         EException* _exception {nullptr};
       };
    }
 }
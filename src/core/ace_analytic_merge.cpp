@@ -1,7 +1,6 @@
 #include "ace_analytic_merge.h"
-#include <QFile>
-#include <QDataStream>
-#include "ace_settings.h"
+#include "ace_analytic_mergethread.h"
+#include "ace_analytic_threadpoolrun.h"
 #include "eabstractanalyticblock.h"
 #include "edebug.h"
 
@@ -35,20 +34,27 @@ bool Merge::isFinished() const
 
 
 /*!
- * Constructs a new merge manager with the given analytic type and the given
- * chunk size.
+ * Constructs a new merge manager with the given analytic type, chunk size, and
+ * optional wait state.
  *
  * @param type The analytic type that is used by this manager.
  *
  * @param size The chunk size of the chunk runs this manager will merge to
  *             finish the analytic.
+ *
+ * @param wait True if this manager should wait for each chunk file to be
+ *             marked as finished with the chunk finished slot before reading
+ *             it or false if it should wait for each complete chunk file to
+ *             exist.
  */
-Merge::Merge(quint16 type, int size)
+Merge::Merge(quint16 type, int size, bool wait)
    :
    AbstractManager(type),
-   _size(size)
+   _size(size),
+   _wait(wait),
+   _ready(size,false)
 {
-   EDEBUG_FUNC(this,type,size);
+   EDEBUG_FUNC(this,type,size,wait);
 }
 
 
@@ -57,15 +63,22 @@ Merge::Merge(quint16 type, int size)
 
 
 /*!
- * Implements the interface that returns the next expected result block index to
- * maintain order of result blocks.
- *
- * @return The next expected result block index to maintain order.
+ * Stops and deletes all merge threads this manager contains, blocking until
+ * each one has finished execution.
  */
-int Merge::index() const
+Merge::~Merge()
 {
+   // Add the debug header.
    EDEBUG_FUNC(this);
-   return _nextResult;
+
+   // Iterate through all merge threads, for each one asking it to stop, waiting
+   // until it is no longer running, and then deleting it.
+   for (auto thread: qAsConst(_threads))
+   {
+      thread->stop();
+      thread->wait();
+      delete thread;
+   }
 }
 
 
@@ -74,26 +87,24 @@ int Merge::index() const
 
 
 /*!
- * Implements the interface that is called to save the given result block to the
- * underlying analytic and it can be assumed that the index order is maintained
- * from least to greatest.
+ * Marks the chunk file of the given chunk index as finished and ready to be
+ * read by this manager, passing it to the merge thread that reads it if this
+ * manager has started.
  *
- * @param result The result block that is processed by this manager's abstract
- *               analytic.
+ * @param index The chunk index whose chunk run has finished writing its chunk
+ *              file.
  */
-void Merge::writeResult(std::unique_ptr<EAbstractAnalyticBlock>&& result)
+void Merge::chunkFinished(int index)
 {
    // Add the debug header.
-   EDEBUG_FUNC(this,result.get());
+   EDEBUG_FUNC(this,index);
 
-   // Write the given result block to this manager's analytic and increment the next
-   // result index. If this abstract input is finished with all results then emit the
-   // done signal and call this manager's finish slot.
-   AbstractManager::writeResult(std::move(result),_nextResult++);
-   if ( isFinished() )
+   // Mark the given chunk index as ready and pass it to its merge thread if there
+   // is one.
+   _ready[index] = true;
+   if ( !_threads.isEmpty() )
    {
-      emit done();
-      finish();
+      _threads.at(index%_threads.size())->setReady(index);
    }
 }
 
@@ -103,20 +114,15 @@ void Merge::writeResult(std::unique_ptr<EAbstractAnalyticBlock>&& result)
 
 
 /*!
- * Implements the interface that is called once to begin the analytic run for
- * this manager after all argument input has been set.
+ * Implements the interface that returns the next expected result block index to
+ * maintain order of result blocks.
+ *
+ * @return The next expected result block index to maintain order.
  */
-void Merge::start()
+int Merge::index() const
 {
-   // Add the debug header.
    EDEBUG_FUNC(this);
-
-   analytic()->initializeOutputs();
-
-   // Calculate the chunk size for this merge and schedule this object's process slot
-   // to be called.
-   _chunkSize  = analytic()->size()/_size + (analytic()->size()%_size ? 1 : 0);
-   QTimer::singleShot(0,this,&Merge::process);
+   return _nextResult;
 }
 
 
@@ -125,18 +131,26 @@ void Merge::start()
 
 
 /*!
- * Called to process all temporary chunk files, merging them all together by
- * sorting all result blocks and processing them with this manager's analytic.
+ * Implements the interface that is called to save the given result block to the
+ * underlying analytic and it can be assumed that the index order is maintained
+ * from least to greatest.
+ *
+ * @param result The result block that is processed by this manager's abstract
+ *               analytic.
  */
-void Merge::process()
+void Merge::writeResult(std::unique_ptr<EAbstractAnalyticBlock>&& result)
 {
    // Add the debug header.
-   EDEBUG_FUNC(this);
+   EDEBUG_FUNC(this,result.get());
 
-   // Iterate through all temporary chunk files, reading in each one.
-   for (int i = 0; i < _size ;++i)
+   // Write the given result block to this manager's analytic and increment the next
+   // result index. If this abstract input is finished with all results then emit the
+   // done signal and call this manager's finish slot.
+   AbstractManager::writeResult(std::move(result),_nextResult++);
+   if ( isFinished() )
    {
-      readChunk(i);
+      emit done();
+      finish();
    }
 }
 
@@ -146,55 +160,41 @@ void Merge::process()
 
 
 /*!
- * Reads in all result blocks from a chunk file produced by the given chunk
- * index, processing them in order with this manager's analytic. If an error
- * occurs with opening the file, reading , or the chunk file did not contain the
- * expected number of result blocks then an exception is thrown.
- *
- * @param index The chunk index whose temporary binary file of result blocks is
- *              read in.
+ * Implements the interface that is called once to begin the analytic run for
+ * this manager after all argument input has been set. This starts the merge
+ * threads, dividing the chunk files between them.
  */
-void Merge::readChunk(int index)
+void Merge::start()
 {
    // Add the debug header.
-   EDEBUG_FUNC(this,index);
-
-   // Determine the range of indexes this chunk file should contain.
-   int nextWork {index*_chunkSize};
-   int end {(index + 1)*_chunkSize};
-   if ( end > analytic()->size() )
-   {
-      end = analytic()->size();
-   }
+   EDEBUG_FUNC(this);
 
-   // Determine the file path for the chunk file with the given index and open it as
-   // read only. If opening fails then throw an exception, else go to the next step.
-   Settings& settings {Settings::instance()};
-   QString path
-   {
-      settings.chunkDir().append("/")
-                         .append(settings.chunkPrefix())
-                         .append(QString::number(index))
-                         .append(".")
-                         .append(settings.chunkExtension())
-   };
-   QFile file(path);
-   if ( !file.open(QIODevice::ReadOnly) )
-   {
-      E_MAKE_EXCEPTION(e);
-      e.setTitle(tr("Open Error"));
-      e.setDetails(tr("Failed opening temporary chunk file %1: %2")
-                   .arg(path)
-                   .arg(file.errorString()));
-      throw e;
-   }
+   analytic()->initializeOutputs();
 
-   // Create a qt data stream with the open file and read in the total number of
-   // expected result blocks.
-   QDataStream stream(&file);
-   while ( nextWork++ < end )
+   // Calculate the chunk size for this merge and the number of chunk files that
+   // contain result blocks.
+   int total {analytic()->size()};
+   _chunkSize  = total/_size + (total%_size ? 1 : 0);
+   int chunks {_chunkSize > 0 ? (total + _chunkSize - 1)/_chunkSize : 0};
+
+   // Create and start the merge threads, one per CPU thread but no more than there
+   // are chunk files, passing along any chunk indexes already marked ready. Connect
+   // each thread's blocks ready signal to this object's process slot.
+   int size {qMax(qMin(ThreadPoolRun::size(),chunks),1)};
+   _threads.resize(size);
+   for (int i = 0; i < size ;++i)
    {
-      readBlock(stream);
+      MergeThread* thread {new MergeThread(analytic(),analyticType(),runKey(),i,size,_chunkSize,_wait)};
+      _threads[i] = thread;
+      for (int j = i; j < _size ;j += size)
+      {
+         if ( _ready.at(j) )
+         {
+            thread->setReady(j);
+         }
+      }
+      connect(thread,&MergeThread::blocksReady,this,&Merge::process,Qt::QueuedConnection);
+      thread->start();
    }
 }
 
@@ -204,43 +204,28 @@ void Merge::readChunk(int index)
 
 
 /*!
- * Reads in a single result block from the given qt data stream, saving it to
- * this abstract input's hopper for sorting and processing.
- *
+ * Called when any merge thread has new result blocks. This takes every result
+ * block that is ready in chunk order, saving each one to this abstract input
+ * for sorting and processing, until the next merge thread in order has none.
  */
-void Merge::readBlock(QDataStream& stream)
+void Merge::process()
 {
    // Add the debug header.
-   EDEBUG_FUNC(this,&stream);
-
-   // Read in the next result block in byte array format from the data stream. If any
-   // read error occurs then throw an exception, else go to the next step.
-   int size;
-   stream >> size;
-   QByteArray data {stream.device()->read(size)};
-   if ( stream.status() != QDataStream::Ok )
-   {
-      E_MAKE_EXCEPTION(e);
-      e.setTitle(tr("Read Error"));
-      e.setDetails(tr("Failed reading temporary chunk file."));
-      throw e;
-   }
+   EDEBUG_FUNC(this);
 
-   // Create a blank result block from this manager's analytic. If creation of the
-   // result block fails then throw an exception, else go to the next step.
-   std::unique_ptr<EAbstractAnalyticBlock> result {analytic()->makeResult()};
-   if ( !result )
+   // Take result blocks from the merge thread of the chunk index the next result
+   // block belongs to until it has none or all result blocks have been taken.
+   while ( _nextRead < analytic()->size() )
    {
-      E_MAKE_EXCEPTION(e);
-      e.setTitle(tr("Logic Error"));
-      e.setDetails(tr("Analytic returned null result block pointer."));
-      throw e;
+      int chunk {_nextRead/_chunkSize};
+      std::unique_ptr<EAbstractAnalyticBlock> result {_threads.at(chunk%_threads.size())->take()};
+      if ( !result )
+      {
+         return;
+      }
+      ++_nextRead;
+      saveResult(std::move(result));
    }
-
-   // Load the blank result block with the byte array data and save it to this
-   // abstract input for sorting and processing.
-   result->fromBytes(data);
-   saveResult(std::move(result));
 }
 
 }
@@ -23,7 +23,12 @@ namespace Ace
        * This is the merge manager. This manager is used to take all the chunk files
        * produced by all the chunk run processes and merge them together finishing the
        * execution of the underlying analytic by having it process all result blocks
-       * stored in the temporary binary chunk files.
+       * stored in the temporary binary chunk files. Chunk files are read and decoded
+       * ahead of the merge by background merge threads, each holding a bounded queue
+       * of result blocks this manager takes from in chunk order. A chunk file is read
+       * as soon as it is finished, so the merge overlaps with chunk runs that are still
+       * executing. If this manager is made to wait then a chunk file is finished once
+       * it is marked as such, else once its complete chunk file exists.
        */
       class Merge : public AbstractManager, public AbstractInput
       {
@@ -31,16 +36,16 @@ namespace Ace
       public:
          virtual bool isFinished() const override final;
       public:
-         explicit Merge(quint16 type, int size);
+         explicit Merge(quint16 type, int size, bool wait = false);
+         virtual ~Merge() override final;
+      public slots:
+         void chunkFinished(int index);
       protected:
          virtual int index() const override final;
          virtual void writeResult(std::unique_ptr<EAbstractAnalyticBlock>&& result) override final;
       protected slots:
          virtual void start() override final;
          void process();
-      private:
-         void readChunk(int index);
-         void readBlock(QDataStream& stream);
       private:
          /*!
           * The chunk size used for this chunk run which this merge manager uses to
@@ -57,6 +62,27 @@ namespace Ace
           * The next result block index to be processed to maintain order.
           */
          int _nextResult {0};
+         /*!
+          * The number of result blocks taken from this manager's merge threads.
+          */
+         int _nextRead {0};
+         /*!
+          * True if this manager waits for each chunk file to be marked as finished
+          * before reading it or false if it waits for each complete chunk file to
+          * exist.
+          */
+         bool _wait;
+         /*!
+          * Flags for every chunk index that is true if its chunk file has been marked as
+          * finished or false otherwise. This is only used if this manager waits.
+          */
+         QVector<bool> _ready;
+         /*!
+          * Pointer list of this manager's merge threads that read and decode chunk
+          * files, where each chunk index is read by the thread at that index modulo
+          * the number of threads.
+          */
+         QVector<MergeThread*> _threads;
       };
    }
 }
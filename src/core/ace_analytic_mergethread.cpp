@@ -0,0 +1,432 @@
+#include "ace_analytic_mergethread.h"
+#include <QFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <algorithm>
+#include "ace_analytic_chunk.h"
+#include "ace_settings.h"
+#include "eabstractanalytic.h"
+#include "eabstractanalyticblock.h"
+#include "eexception.h"
+#include "edebug.h"
+
+
+
+namespace Ace
+{
+namespace Analytic
+{
+
+
+
+
+
+
+/*!
+ * Constructs a new merge thread with the given analytic, analytic type, run
+ * key, first chunk index, stride, chunk size, wait state, and optional parent.
+ *
+ * @param analytic Pointer to the analytic used to make blank result blocks.
+ *
+ * @param type The analytic type every chunk file must have been made with.
+ *
+ * @param key The run key every chunk file must have been made with.
+ *
+ * @param first The first chunk index this thread reads.
+ *
+ * @param stride The number of chunk indexes between each chunk index this
+ *               thread reads.
+ *
+ * @param chunkSize The number of result blocks every chunk file contains
+ *                  excluding the last one.
+ *
+ * @param wait True if this thread waits for each chunk to be marked ready or
+ *             false if it waits for each completed chunk file to exist.
+ *
+ * @param parent Optional parent of this new thread object.
+ */
+MergeThread::MergeThread(const EAbstractAnalytic* analytic, quint16 type, const QByteArray& key, int first, int stride, int chunkSize, bool wait, QObject* parent)
+   :
+   QThread(parent),
+   _analytic(analytic),
+   _type(type),
+   _key(key),
+   _first(first),
+   _stride(stride),
+   _chunkSize(chunkSize),
+   _total(analytic->size()),
+   _wait(wait),
+   _timeout(Settings::instance().mergeTimeout())
+{
+   EDEBUG_FUNC(this,analytic,type,key,first,stride,chunkSize,wait,parent);
+}
+
+
+
+
+
+
+/*!
+ * Deletes any result blocks or exception this thread still contains. This
+ * thread must be stopped and finished before it is deleted.
+ */
+MergeThread::~MergeThread()
+{
+   EDEBUG_FUNC(this);
+   qDeleteAll(_queue);
+   delete _exception;
+}
+
+
+
+
+
+
+/*!
+ * Takes the next result block from this thread's queue, waking this object's
+ * separate thread if it is waiting for room. This never blocks. If the queue
+ * is empty and this object's separate thread threw an exception then that
+ * exception is thrown again on the thread calling this method.
+ *
+ * @return The next decoded result block or a null pointer if there is none yet.
+ */
+std::unique_ptr<EAbstractAnalyticBlock> MergeThread::take()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // If the queue has a result block then take it, waking the separate thread because
+   // the queue now has room.
+   QMutexLocker locker(&_mutex);
+   if ( !_queue.isEmpty() )
+   {
+      std::unique_ptr<EAbstractAnalyticBlock> ret {_queue.dequeue()};
+      ret->setParent(nullptr);
+      _condition.wakeOne();
+      return ret;
+   }
+
+   // If this object has a saved exception from its separate thread then copy it and
+   // throw it on this thread, else there is no result block yet.
+   if ( _exception )
+   {
+      EException e(*_exception);
+      delete _exception;
+      _exception = nullptr;
+      throw e;
+   }
+   return nullptr;
+}
+
+
+
+
+
+
+/*!
+ * Marks the chunk with the given index as finished and ready to be read by
+ * this thread, waking its separate thread if it is waiting on it.
+ *
+ * @param index The chunk index that is ready.
+ */
+void MergeThread::setReady(int index)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,index);
+
+   // Add the chunk index to the ready set and wake the separate thread.
+   QMutexLocker locker(&_mutex);
+   _ready.insert(index);
+   _condition.wakeOne();
+}
+
+
+
+
+
+
+/*!
+ * Asks this object's separate thread to stop, waking it if it is waiting.
+ */
+void MergeThread::stop()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Set the stop flag and wake the separate thread.
+   QMutexLocker locker(&_mutex);
+   _stop = true;
+   _condition.wakeOne();
+}
+
+
+
+
+
+
+/*!
+ * Reads every chunk file this thread is given in order, waiting for each one
+ * to be finished. If any exception is thrown within this separate thread it
+ * is caught and saved. This returns once all chunk files are read, an error
+ * occurs, or the stop method has been called.
+ */
+void MergeThread::run()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Iterate through this thread's chunk indexes that contain result blocks, waiting
+   // for each one to finish and then reading it. If any ACE exception occurs then
+   // catch it, save it, and signal it is ready.
+   try
+   {
+      for (int i = _first; i*_chunkSize < _total ;i += _stride)
+      {
+         if ( !waitChunk(i) || !readChunk(i) )
+         {
+            return;
+         }
+      }
+   }
+   catch (EException e)
+   {
+      QMutexLocker locker(&_mutex);
+      _exception = new EException(e);
+      emit blocksReady();
+   }
+}
+
+
+
+
+
+
+/*!
+ * Sleeps until the chunk with the given index is finished or this thread is
+ * asked to stop. A chunk is finished once it is marked ready if this thread
+ * waits, else once its completed chunk file exists. A chunk whose run has not
+ * started yet is waited on as well. If this thread does not wait then an
+ * exception is thrown if the temporary chunk file disappears without the
+ * completed one appearing, or if the chunk has neither file for longer than
+ * the merge timeout setting when it is on.
+ *
+ * @param index The chunk index whose chunk file is waited on.
+ *
+ * @return True if the chunk is finished or false if this thread was asked to
+ *         stop.
+ */
+bool MergeThread::waitChunk(int index)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,index);
+
+   // Sleep until the chunk is ready or its file exists, checking for the file again
+   // after each poll wait.
+   const QString path {Chunk::path(index)};
+   const QString temporary {path + QStringLiteral(".tmp")};
+   bool started {false};
+   QElapsedTimer timer;
+   timer.start();
+   QMutexLocker locker(&_mutex);
+   while ( !_stop )
+   {
+      if ( _wait ? _ready.contains(index) : QFile::exists(path) )
+      {
+         return true;
+      }
+
+      // If this thread does not wait then check the temporary chunk file. If it exists
+      // then its chunk run has started. Else check for the completed file again in
+      // case it was renamed in between, and if it still does not exist then throw an
+      // exception if the chunk run had started or the merge timeout has passed.
+      if ( !_wait )
+      {
+         if ( QFile::exists(temporary) )
+         {
+            started = true;
+         }
+         else if ( QFile::exists(path) )
+         {
+            return true;
+         }
+         else if ( started )
+         {
+            E_MAKE_EXCEPTION(e);
+            e.setTitle(tr("Open Error"));
+            e.setDetails(tr("Temporary chunk file %1 was removed before its chunk run finished.")
+                         .arg(temporary));
+            throw e;
+         }
+         else if ( _timeout > 0 && timer.hasExpired(_timeout*1000ll) )
+         {
+            E_MAKE_EXCEPTION(e);
+            e.setTitle(tr("Open Error"));
+            e.setDetails(tr("Chunk file %1 was not started within the merge timeout of %2 seconds.")
+                         .arg(path)
+                         .arg(_timeout));
+            throw e;
+         }
+      }
+      _condition.wait(&_mutex,_pollWait);
+   }
+   return false;
+}
+
+
+
+
+
+
+/*!
+ * Reads in all result blocks from the chunk file of the given chunk index in
+ * block index order, decoding each one and adding it to this thread's queue.
+ * If an error occurs opening the file, its header does not match the run being
+ * merged, or it is incomplete or corrupt then an exception is thrown.
+ *
+ * @param index The chunk index whose chunk file is read.
+ *
+ * @return True if the whole chunk file was read or false if this thread was
+ *         asked to stop.
+ */
+bool MergeThread::readChunk(int index)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,index);
+
+   // Determine the range of block indexes this chunk file should contain.
+   int begin {index*_chunkSize};
+   int end {qMin(begin + _chunkSize,_total)};
+
+   // Open the chunk file with the given index as read only. If opening fails then
+   // throw an exception, else go to the next step.
+   QString path {Chunk::path(index)};
+   QFile file(path);
+   if ( !file.open(QIODevice::ReadOnly) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Open Error"));
+      e.setDetails(tr("Failed opening chunk file %1: %2")
+                   .arg(path)
+                   .arg(file.errorString()));
+      throw e;
+   }
+
+   // Make sure the chunk file header matches the run being merged. If it does not
+   // then throw an exception.
+   QDataStream stream(&file);
+   if ( !Chunk::readHeader(stream,_type,_key,index,begin,end) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Invalid Chunk"));
+      e.setDetails(tr("Chunk file %1 was not made by a chunk run of this analytic"
+                      " with the same options and size.")
+                   .arg(path));
+      throw e;
+   }
+
+   // Read the table of the chunk file and sort it by block index, making sure it has
+   // every block index of this chunk exactly once. If it does not then throw an
+   // exception.
+   QVector<Chunk::Entry> table;
+   bool valid {Chunk::readTable(stream,end - begin,table)};
+   std::sort(table.begin(),table.end());
+   for (int i = 0; valid && i < table.size() ;++i)
+   {
+      valid = table.at(i).first == begin + i;
+   }
+   if ( !valid )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Read Error"));
+      e.setDetails(tr("Chunk file %1 is incomplete or corrupt.").arg(path));
+      throw e;
+   }
+
+   // Iterate through all records in block index order, adding each result block to
+   // this thread's queue.
+   for (const auto& entry: qAsConst(table))
+   {
+      // Read in the record of the next result block. If any read error occurs or the
+      // record does not match its table entry then throw an exception, else go to the
+      // next step.
+      qint32 blockIndex;
+      QByteArray data;
+      if ( !file.seek(entry.second)
+           || !Chunk::readRecord(stream,blockIndex,data)
+           || blockIndex != entry.first )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("Read Error"));
+         e.setDetails(tr("Failed reading result block %1 from chunk file %2.")
+                      .arg(entry.first)
+                      .arg(path));
+         throw e;
+      }
+
+      // Create a blank result block from the analytic. If creation of the result block
+      // fails then throw an exception, else go to the next step.
+      std::unique_ptr<EAbstractAnalyticBlock> result {_analytic->makeResult()};
+      if ( !result )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("Logic Error"));
+         e.setDetails(tr("Analytic returned null result block pointer."));
+         throw e;
+      }
+
+      // Load the blank result block with the byte array data, transfer it to the thread
+      // of this object, and add it to the queue.
+      result->fromBytes(data);
+      result->moveToThread(thread());
+      if ( !push(std::move(result)) )
+      {
+         return false;
+      }
+   }
+
+   // The whole chunk file has been read.
+   return true;
+}
+
+
+
+
+
+
+/*!
+ * Adds the given result block to this thread's queue, sleeping while the queue
+ * is full. If the queue was empty then the blocks ready signal is emitted.
+ *
+ * @param block The decoded result block added to the queue.
+ *
+ * @return True if the result block was added or false if this thread was asked
+ *         to stop.
+ */
+bool MergeThread::push(std::unique_ptr<EAbstractAnalyticBlock>&& block)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,block.get());
+
+   // Sleep while the queue is full and this thread is not asked to stop.
+   QMutexLocker locker(&_mutex);
+   while ( _queue.size() >= _queueSize && !_stop )
+   {
+      _condition.wait(&_mutex);
+   }
+   if ( _stop )
+   {
+      return false;
+   }
+
+   // Add the result block to the queue, signaling if it was empty.
+   block->setParent(this);
+   _queue.enqueue(block.release());
+   if ( _queue.size() == 1 )
+   {
+      emit blocksReady();
+   }
+   return true;
+}
+
+}
+}
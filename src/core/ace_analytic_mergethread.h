@@ -0,0 +1,144 @@
+#ifndef ACE_ANALYTIC_MERGETHREAD_H
+#define ACE_ANALYTIC_MERGETHREAD_H
+#include <memory>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QSet>
+#include <QByteArray>
+#include "ace_analytic.h"
+#include "global.h"
+
+
+
+/*!
+ * This contains all private classes used internally by the ACE library and
+ * should never be accessed by a developer using this library.
+ */
+namespace Ace
+{
+   /*!
+    * This contains all classes related to running an analytic. This required its
+    * own name space because of the immense complexity required for ACE to provide
+    * an abstract interface for running analytic types in heterogeneous
+    * environments.
+    */
+   namespace Analytic
+   {
+      /*!
+       * This is a single thread of execution used by the merge manager to read and
+       * decode chunk files ahead of the merge. Each thread is given every chunk index
+       * starting at its first index and stepping by its stride, reading them in order.
+       * A chunk file is only read once it is finished, either by being marked ready or
+       * by its completed file existing. Chunks whose runs have not started yet are
+       * waited on as well, optionally up to the merge timeout setting. The header and
+       * table of every chunk file are checked against the run being merged and its
+       * records are read in block index order, testing each checksum. Decoded result
+       * blocks are added to a bounded queue that the merge manager takes from on its
+       * own thread, this thread sleeping while the queue is full.
+       */
+      class MergeThread : public QThread
+      {
+         Q_OBJECT
+      public:
+         explicit MergeThread(const EAbstractAnalytic* analytic, quint16 type, const QByteArray& key, int first, int stride, int chunkSize, bool wait, QObject* parent = nullptr);
+         virtual ~MergeThread() override final;
+         std::unique_ptr<EAbstractAnalyticBlock> take();
+         void setReady(int index);
+         void stop();
+      signals:
+         /*!
+          * Signals this thread has added a result block to its empty queue or saved an
+          * exception, so there is something new to take.
+          */
+         void blocksReady();
+      protected:
+         virtual void run() override final;
+      private:
+         bool waitChunk(int index);
+         bool readChunk(int index);
+         bool push(std::unique_ptr<EAbstractAnalyticBlock>&& block);
+         /*!
+          * The maximum number of decoded result blocks this thread holds in its queue
+          * before sleeping.
+          */
+         constexpr static int _queueSize {256};
+         /*!
+          * The time in milliseconds this thread sleeps between checks for a chunk file
+          * that is not yet finished.
+          */
+         constexpr static unsigned long _pollWait {1000};
+         /*!
+          * Mutex protecting the queue, ready chunk indexes, exception, and stop state of
+          * this thread.
+          */
+         QMutex _mutex;
+         /*!
+          * Wait condition this object's separate thread sleeps on until its queue has
+          * room, a chunk is ready, or it is asked to stop.
+          */
+         QWaitCondition _condition;
+         /*!
+          * Pointer to the analytic used to make blank result blocks.
+          */
+         const EAbstractAnalytic* _analytic;
+         /*!
+          * The analytic type every chunk file must have been made with.
+          */
+         quint16 _type;
+         /*!
+          * The run key every chunk file must have been made with.
+          */
+         QByteArray _key;
+         /*!
+          * The first chunk index this thread reads.
+          */
+         int _first;
+         /*!
+          * The number of chunk indexes between each chunk index this thread reads.
+          */
+         int _stride;
+         /*!
+          * The number of result blocks every chunk file contains excluding the last one.
+          */
+         int _chunkSize;
+         /*!
+          * The total number of result blocks of the analytic being merged.
+          */
+         int _total;
+         /*!
+          * True if this thread waits for each chunk to be marked ready or false if it
+          * waits for each completed chunk file to exist.
+          */
+         bool _wait;
+         /*!
+          * The time in seconds this thread waits for a chunk that has neither a
+          * completed nor a temporary chunk file before failing. If this is 0 then it
+          * waits forever.
+          */
+         int _timeout;
+         /*!
+          * The chunk indexes that have been marked ready.
+          */
+         QSet<int> _ready;
+         /*!
+          * Queue of decoded result blocks waiting to be taken in the order they were
+          * read.
+          */
+         QQueue<EAbstractAnalyticBlock*> _queue;
+         /*!
+          * True if this object's separate thread has been asked to stop or false
+          * otherwise.
+          */
+         bool _stop {false};
+         /*!
+          * Pointer to any exception that occurs on this object's separate thread while
+          * reading chunk files.
+          */
+         EException* _exception {nullptr};
+      };
+   }
+}
+
+#endif
@@ -1,7 +1,12 @@
 #include "ace_analytic_mpimaster.h"
+#include <algorithm>
+#include <QDataStream>
+#include <QFile>
+#include <QtMath>
 #include "ace_qmpi.h"
 #include "ace_settings.h"
 #include "edebug.h"
+#include "emetadata.h"
 #include "eabstractanalyticblock.h"
 
 
@@ -43,8 +48,38 @@ MPIMaster::MPIMaster(quint16 type)
    AbstractMPI(type),
    _mpi(QMPI::instance())
 {
+   // Add the debug header.
    EDEBUG_FUNC(this,type);
+
+   // Connect the MPI data received signal and initialize the dispatch state of all
+   // slave nodes.
    connect(&_mpi,&QMPI::dataReceived,this,&MPIMaster::dataReceived);
+   _slaves.resize(_mpi.size());
+   _clock.start();
+
+   // If the MPI timeout is set then check for lost slave nodes once a second.
+   _timeout = static_cast<qint64>(Settings::instance().timeout())*1000;
+   if ( _timeout > 0 )
+   {
+      connect(&_watchdog,&QTimer::timeout,this,&MPIMaster::checkTimeouts);
+      _watchdog.start(1000);
+   }
+
+   // If MPI reduction is enabled then count the slave nodes that send their result
+   // blocks through each local leader, which is every other node on a system that
+   // is not the one of this master node.
+   _reduce = Settings::instance().reductionEnabled();
+   if ( _reduce )
+   {
+      for (int i = 1; i < _mpi.size() ;++i)
+      {
+         int leader {_mpi.leader(i)};
+         if ( leader != i && leader != 0 )
+         {
+            ++_slaves[leader].followers;
+         }
+      }
+   }
 }
 
 
@@ -53,11 +88,13 @@ MPIMaster::MPIMaster(quint16 type)
 
 
 /*!
- * Properly shuts down the MPI system.
+ * Deletes the qt data stream used for the checkpoint file, if any, and properly
+ * shuts down the MPI system.
  */
 MPIMaster::~MPIMaster()
 {
    EDEBUG_FUNC(this);
+   delete _checkpointStream;
    QMPI::shutdown();
 }
 
@@ -95,12 +132,29 @@ void MPIMaster::writeResult(std::unique_ptr<EAbstractAnalyticBlock>&& result)
    // Add the debug header.
    EDEBUG_FUNC(this,result.get());
 
-   // Write the result block to this manager's underlying analytic. If this manager
-   // is finished with all result blocks then emit the done signal and call the
-   // manager's finish slot.
-   AbstractManager::writeResult(std::move(result),_nextResult++);
+   // If checkpoints are enabled then save the result block to the checkpoint file
+   // with the number of indexes it covers.
+   int span {_spans.contains(_nextResult) ? _spans.take(_nextResult) : 1};
+   if ( _checkpointStream )
+   {
+      *_checkpointStream << span << result->toBytes();
+   }
+
+   // Write the result block to this manager's underlying analytic, moving past all
+   // indexes it covers if it is a reduced result block. If this manager is finished
+   // with all result blocks then remove any checkpoint file, emit the done signal,
+   // and call the manager's finish slot.
+   AbstractManager::writeResult(std::move(result),_nextResult);
+   _nextResult += span;
    if ( isFinished() )
    {
+      if ( _checkpoint )
+      {
+         _checkpointTimer.stop();
+         delete _checkpointStream;
+         _checkpointStream = nullptr;
+         _checkpoint->remove();
+      }
       emit done();
       finish();
    }
@@ -111,6 +165,65 @@ void MPIMaster::writeResult(std::unique_ptr<EAbstractAnalyticBlock>&& result)
 
 
 
+/*!
+ * Implements the interface that is called once this master node's analytic
+ * outputs are initialized and before any slave node is started. This
+ * implementation opens the checkpoint file if checkpoints are enabled. If the
+ * checkpoint file is from a previous run of the same analytic with the same
+ * arguments then its saved result blocks are written again and this run
+ * continues from its last mark, else it is started over.
+ */
+void MPIMaster::mpiResume()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // If checkpoints are disabled then do nothing and exit, else go to the next step.
+   int interval {Settings::instance().checkpointInterval()};
+   if ( interval < 1 )
+   {
+      return;
+   }
+
+   // Open the checkpoint file for reading and writing, creating it if it does not
+   // exist. If opening fails then throw an exception, else go to the next step.
+   _checkpoint = new QFile(checkpointPath(),this);
+   if ( !_checkpoint->open(QIODevice::ReadWrite) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Open Error"));
+      e.setDetails(tr("Failed opening checkpoint file %1: %2")
+                   .arg(_checkpoint->fileName())
+                   .arg(_checkpoint->errorString()));
+      throw e;
+   }
+   _checkpointStream = new QDataStream(_checkpoint);
+
+   // If the checkpoint file cannot be resumed then truncate it and write a new header
+   // with a blank mark.
+   if ( !restoreCheckpoint() )
+   {
+      _checkpoint->resize(0);
+      _checkpoint->seek(0);
+      *_checkpointStream << qint32 {_checkpointVersion}
+                         << analyticType()
+                         << analytic()->size()
+                         << runKey();
+      _markOffset = _checkpoint->pos();
+      *_checkpointStream << qint32 {0} << qint64 {0};
+   }
+
+   // Mark the checkpoint file now and every checkpoint interval after.
+   connect(&_checkpointTimer,&QTimer::timeout,this,&MPIMaster::saveCheckpoint);
+   _checkpointTimer.start(interval*1000);
+   saveCheckpoint();
+}
+
+
+
+
+
+
 /*!
  * Called when new data has been received from one of the slave nodes. This
  * takes the data and processes it depending on what it is.
@@ -126,15 +239,17 @@ void MPIMaster::dataReceived(const QByteArray& data, int fromRank)
    EDEBUG_FUNC(this,data,fromRank);
 
    // Extract the index from the given data. If the index is less than 0 and a code
-   // then process it as a code, else process it as a result block.
+   // then process it as a code, else process it as a single result block and send
+   // the slave node more work.
    int index {EAbstractAnalyticBlock::extractIndex(data)};
    if ( index < 0 )
    {
-      processCode(index,fromRank);
+      processCode(index,data,fromRank);
    }
    else
    {
-      process(data,fromRank);
+      process(data);
+      dispatch(fromRank,1);
    }
 }
 
@@ -144,31 +259,134 @@ void MPIMaster::dataReceived(const QByteArray& data, int fromRank)
 
 
 /*!
- * Processes a special code sent to this master node by a slave node. The only
- * special codes processes are for the slave node signaling it is ready to
- * process blocks.
+ * Called periodically to check for lost slave nodes. A slave node is assumed
+ * lost if it has outstanding work blocks and has not sent any result blocks
+ * within the MPI timeout.
+ */
+void MPIMaster::checkTimeouts()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Iterate through all slave nodes, marking any that are lost.
+   qint64 now {_clock.elapsed()};
+   for (int i = 1; i < _slaves.size() ;++i)
+   {
+      const Slave& slave {_slaves.at(i)};
+      if ( !slave.lost && !slave.terminated && slave.outstanding > 0 && now - slave.last > _timeout )
+      {
+         markLost(i);
+      }
+   }
+}
+
+
+
+
+
+
+/*!
+ * Called periodically to mark the checkpoint file. All result blocks saved to
+ * the checkpoint file are flushed to it before the next result index and their
+ * end position are written to its mark, so a run resumed from it only writes
+ * result blocks that were completely saved. If writing fails then an exception
+ * is thrown.
+ */
+void MPIMaster::saveCheckpoint()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // If checkpoints are disabled then do nothing and exit, else go to the next step.
+   if ( !_checkpointStream )
+   {
+      return;
+   }
+
+   // Flush all saved result blocks, write the mark, and then return to the end of
+   // the checkpoint file. If any write error occurs then throw an exception.
+   qint64 end {_checkpoint->pos()};
+   _checkpoint->flush();
+   _checkpoint->seek(_markOffset);
+   *_checkpointStream << qint32 {_nextResult} << end;
+   _checkpoint->flush();
+   _checkpoint->seek(end);
+   if ( _checkpointStream->status() != QDataStream::Ok )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Write Error"));
+      e.setDetails(tr("Failed writing checkpoint file %1: %2")
+                   .arg(_checkpoint->fileName())
+                   .arg(_checkpoint->errorString()));
+      throw e;
+   }
+}
+
+
+
+
+
+
+/*!
+ * Processes a special code sent to this master node by a slave node. The
+ * special codes processed are for the slave node signaling it is ready to
+ * process blocks or sending a batch or gathered batch of result blocks.
  *
  * @param code The special code sent to this master node by a slave node.
  *
+ * @param data The data containing the special code and any arguments that
+ *             follow it.
+ *
  * @param fromRank The process rank of the slave node that sent the code.
  */
-void MPIMaster::processCode(int code, int fromRank)
+void MPIMaster::processCode(int code, const QByteArray& data, int fromRank)
 {
    // Add the debug header.
-   EDEBUG_FUNC(this,code,fromRank);
+   EDEBUG_FUNC(this,code,data,fromRank);
+
+   // If the code is a result batch then process it and exit, else go to the next
+   // step.
+   if ( code == ResultBatch )
+   {
+      processBatch(data,fromRank);
+      return;
+   }
+   if ( code == GatheredBatch )
+   {
+      processGathered(data);
+      return;
+   }
 
    // Initialize the amount of blocks to send using the global setting buffer size.
    Settings& settings {Settings::instance()};
    int amount {settings.bufferSize()};
 
    // Add to the amount of blocks to send to the slave node based off it being a
-   // serial or OpenCL type.
+   // serial, thread pool, or OpenCL type.
    switch (code)
    {
    case ReadyAsCUDA:
    case ReadyAsOpenCL:
       amount += settings.threadSize() + 1;
       break;
+   case ReadyAsThreadPool:
+      {
+         // Read the thread size of the slave node which follows the code block's header,
+         // making sure it worked.
+         int threads;
+         QDataStream stream(data);
+         stream.skipRawData(EAbstractAnalyticBlock::headerSize());
+         stream >> threads;
+         if ( stream.status() != QDataStream::Ok || threads < 1 )
+         {
+            E_MAKE_EXCEPTION(e);
+            e.setTitle(tr("Logic Error"));
+            e.setDetails(tr("Slave MPI node sent invalid thread pool size to master."));
+            throw e;
+         }
+         amount += threads;
+      }
+      break;
    case ReadyAsSerial:
       ++amount;
       break;
@@ -181,24 +399,112 @@ void MPIMaster::processCode(int code, int fromRank)
       }
    }
 
-   // If there is no more work blocks to be processed then send a terminate code to
-   // the slave node and exit, else go to the next step.
-   if ( _nextWork >= analytic()->size() )
+   // Save the amount as the capacity of the slave node, starting its throughput
+   // measurement, and send it its first batch of work blocks.
+   Slave& slave {_slaves[fromRank]};
+   slave.capacity = amount;
+   slave.last = _clock.elapsed();
+   dispatch(fromRank,0);
+}
+
+
+
+
+
+
+/*!
+ * Processes a batch of result blocks sent to this master node by a slave node,
+ * saving each one and then sending the slave node more work blocks.
+ *
+ * @param data The data containing the result batch code followed by each
+ *             result block.
+ *
+ * @param fromRank The process rank of the slave node that sent the result
+ *                 blocks.
+ */
+void MPIMaster::processBatch(const QByteArray& data, int fromRank)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,data,fromRank);
+
+   // Read and process each result block that follows the code block's header,
+   // making sure it worked.
+   QDataStream stream(data);
+   stream.skipRawData(EAbstractAnalyticBlock::headerSize());
+   int size {0};
+   while ( !stream.atEnd() )
    {
-      terminate(fromRank);
+      QByteArray block;
+      stream >> block;
+      if ( stream.status() != QDataStream::Ok )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("Logic Error"));
+         e.setDetails(tr("Slave MPI node sent corrupt result batch to master."));
+         throw e;
+      }
+      process(block);
+      ++size;
    }
 
-   // Else there are more work blocks to be processed.
-   else
+   // Send the slave node more work blocks.
+   dispatch(fromRank,size);
+}
+
+
+
+
+
+
+/*!
+ * Processes a gathered batch of result blocks sent to this master node by the
+ * local leader of a system, saving each one with the number of indexes it
+ * covers and then sending each slave node with finished work blocks more work
+ * blocks.
+ *
+ * @param data The data containing the gathered batch code followed by the
+ *             finished work blocks of each slave node and each result block.
+ */
+void MPIMaster::processGathered(const QByteArray& data)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,data);
+
+   // Read the rank and number of finished work blocks of each slave node that
+   // follows the code block's header, then read and process each result block with
+   // the number of indexes it covers, making sure it worked.
+   QDataStream stream(data);
+   stream.skipRawData(EAbstractAnalyticBlock::headerSize());
+   int size;
+   stream >> size;
+   QVector<QPair<int,int>> finished(qMax(size,0));
+   for (auto& slave: finished)
+   {
+      stream >> slave.first >> slave.second;
+   }
+   while ( stream.status() == QDataStream::Ok && !stream.atEnd() )
    {
-      // Send blocks in the amount determined or until there is no more work blocks to
-      // send.
-      while ( amount-- && _nextWork < analytic()->size() )
+      int span;
+      QByteArray block;
+      stream >> span >> block;
+      if ( stream.status() == QDataStream::Ok )
       {
-         std::unique_ptr<EAbstractAnalyticBlock> work {makeWork(_nextWork++)};
-         _mpi.sendData(fromRank,work->toBytes());
+         process(block,span);
       }
    }
+   if ( stream.status() != QDataStream::Ok || size < 0 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Logic Error"));
+      e.setDetails(tr("Slave MPI node sent corrupt gathered batch to master."));
+      throw e;
+   }
+
+   // Send each slave node with finished work blocks more work blocks.
+   for (auto& slave: finished)
+   {
+      dispatch(slave.first,slave.second);
+   }
 }
 
 
@@ -213,41 +519,354 @@ void MPIMaster::processCode(int code, int fromRank)
  * @param data The data containing a result block sent to this master node by a
  *             slave node.
  *
- * @param fromRank The process rank of the slave node that sent the result
- *                 block.
+ * @param span The number of indexes the result block covers, which is more than
+ *             one if it is a reduced result block.
  */
-void MPIMaster::process(const QByteArray& data, int fromRank)
+void MPIMaster::process(const QByteArray& data, int span)
 {
    // Add the debug header.
-   EDEBUG_FUNC(this,data,fromRank);
+   EDEBUG_FUNC(this,data,span);
 
-   // Make a blank result block from this manager's analytic and load the given data
-   // into it. If the analytic fails making a blank result block then throw an
-   // exception, else go to the next step.
-   std::unique_ptr<EAbstractAnalyticBlock> result {analytic()->makeResult()};
-   if ( !result )
+   // Make a result block from the given data. If its index is not waiting for a
+   // result then it is a duplicate from a slave node that was assumed lost so do
+   // nothing and exit, else go to the next step.
+   std::unique_ptr<EAbstractAnalyticBlock> result {makeResult(data)};
+   if ( !_owners.contains(result->index()) )
    {
-      E_MAKE_EXCEPTION(e);
-      e.setTitle(tr("Logic Error"));
-      e.setDetails(tr("Analytic returned null result block pointer."));
-      throw e;
+      return;
+   }
+
+   // If the result block covers more than one index then save its span, making sure
+   // it is valid.
+   if ( span != 1 )
+   {
+      if ( span < 1 || result->index() + span > analytic()->size() )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("Logic Error"));
+         e.setDetails(tr("Slave MPI node sent result block with invalid span %1.").arg(span));
+         throw e;
+      }
+      _spans.insert(result->index(),span);
+   }
+
+   // Remove all indexes the result block covers from the indexes waiting for a
+   // result.
+   for (int i = 0; i < span ;++i)
+   {
+      _owners.remove(result->index() + i);
    }
-   result->fromBytes(data);
 
    // Save the result block to this abstract input which will sort all result blocks
    // using its internal sorting hopper.
    saveResult(std::move(result));
+}
+
 
-   // If there are more work blocks to be processed then send the slave node a new
-   // work block to process, else send the terminate code to the slave node.
-   if ( _nextWork < analytic()->size() )
+
+
+
+
+/*!
+ * Updates the dispatch state of the slave node with the given rank after it
+ * finished the given number of work blocks and sends it a batch of work blocks
+ * with contiguous indexes. The slave node is kept sent its capacity plus the
+ * number of blocks it processes in the batch time at its measured throughput.
+ * If there are no more work blocks then the slave node is sent the terminate
+ * code once it has no outstanding work blocks, or every slave node is once all
+ * result blocks are received if the MPI timeout is set. Work blocks of lost
+ * slave nodes are sent first. If the analytic can make work blocks on any node
+ * then only the range of indexes of new work blocks is sent.
+ *
+ * @param rank Process rank of the slave node that is sent work blocks.
+ *
+ * @param finished The number of work blocks the slave node just finished.
+ */
+void MPIMaster::dispatch(int rank, int finished)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,rank,finished);
+
+   // Update the number of outstanding work blocks of the slave node. If it finished
+   // any then update its measured throughput with a running average.
+   Slave& slave {_slaves[rank]};
+   slave.outstanding = qMax(slave.outstanding - finished,0);
+   if ( finished > 0 )
+   {
+      qint64 now {_clock.elapsed()};
+      double rate {finished*1000.0/qMax<qint64>(now - slave.last,1)};
+      slave.rate = slave.rate > 0 ? (slave.rate + rate)/2 : rate;
+      slave.last = now;
+
+      // If the slave node was assumed lost then it is not, so count it again as a
+      // follower of its local leader.
+      if ( slave.lost )
+      {
+         slave.lost = false;
+         int leader {_mpi.leader(rank)};
+         if ( _reduce && leader != rank && leader != 0 )
+         {
+            ++_slaves[leader].followers;
+         }
+      }
+   }
+
+   // If there are no more new work blocks then drop any queued indexes of lost slave
+   // nodes that have since received a result block.
+   if ( _nextWork >= analytic()->size() )
+   {
+      _lost.erase(std::remove_if(_lost.begin()
+                                 ,_lost.end()
+                                 ,[this](int index){ return _owners.value(index,0) != -1; })
+                  ,_lost.end());
+   }
+
+   // If there are no more work blocks to be processed then send the terminate code to
+   // the slave node once it is idle, or to all slave nodes once every result block is
+   // received if the MPI timeout is set, and exit. Else if the slave node is lost
+   // then exit, else go to the next step.
+   if ( _nextWork >= analytic()->size() && _lost.isEmpty() )
+   {
+      if ( _timeout == 0 )
+      {
+         terminateIdle(rank);
+      }
+      else if ( _owners.isEmpty() )
+      {
+         terminateAll();
+      }
+      return;
+   }
+   if ( slave.lost )
+   {
+      return;
+   }
+
+   // Determine the amount of work blocks to send the slave node. If it already has
+   // enough then exit, else go to the next step.
+   int extra {qCeil(slave.rate*_batchTime)};
+   if ( extra > _maxBatch )
    {
-      std::unique_ptr<EAbstractAnalyticBlock> work {makeWork(_nextWork++)};
-      _mpi.sendData(fromRank,work->toBytes());
+      extra = _maxBatch;
+   }
+   int amount {qMin(slave.capacity + extra - slave.outstanding,analytic()->size() - _nextWork + _lost.size())};
+   if ( amount < 1 )
+   {
+      return;
+   }
+
+   // Send work blocks of lost slave nodes first. If there is nothing left of the
+   // amount or no new work blocks then exit, else go to the next step.
+   amount -= reassign(rank,amount);
+   amount = qMin(amount,analytic()->size() - _nextWork);
+   if ( amount < 1 )
+   {
+      return;
+   }
+
+   // If the analytic can make work blocks on any node then create a work range with
+   // the next indexes in the amount determined, else create a work batch with the
+   // next work blocks in the amount determined. Record the slave node as the owner of
+   // each index and send it to the slave node.
+   bool local {analytic()->isLocalWork()};
+   std::unique_ptr<EAbstractAnalyticBlock> code {new EAbstractAnalyticBlock(local ? WorkRange : WorkBatch)};
+   QByteArray data {code->toBytes()};
+   QDataStream stream(&data,QIODevice::WriteOnly|QIODevice::Append);
+   if ( local )
+   {
+      stream << _nextWork << amount;
+      for (int i = 0; i < amount ;++i)
+      {
+         _owners.insert(_nextWork++,rank);
+      }
    }
    else
    {
-      terminate(fromRank);
+      for (int i = 0; i < amount ;++i)
+      {
+         _owners.insert(_nextWork,rank);
+         std::unique_ptr<EAbstractAnalyticBlock> work {makeWork(_nextWork++)};
+         stream << work->toBytes();
+      }
+   }
+   slave.outstanding += amount;
+   _mpi.sendData(rank,data);
+}
+
+
+
+
+
+
+/*!
+ * Sends the work blocks of lost slave nodes still waiting for a result block to
+ * the slave node with the given rank as a work batch, up to the given amount.
+ * These are always sent as work blocks because their indexes are not
+ * contiguous.
+ *
+ * @param rank Process rank of the slave node that is sent work blocks.
+ *
+ * @param amount The maximum number of work blocks sent.
+ *
+ * @return Number of work blocks sent.
+ */
+int MPIMaster::reassign(int rank, int amount)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,rank,amount);
+
+   // If there are no work blocks of lost slave nodes then do nothing and exit, else
+   // go to the next step.
+   int ret {0};
+   if ( _lost.isEmpty() )
+   {
+      return ret;
+   }
+
+   // Add each index of a lost slave node that is still waiting for a result block to
+   // a work batch, recording the slave node as its new owner, until there are no
+   // more or the amount is reached.
+   std::unique_ptr<EAbstractAnalyticBlock> code {new EAbstractAnalyticBlock(WorkBatch)};
+   QByteArray data {code->toBytes()};
+   QDataStream stream(&data,QIODevice::WriteOnly|QIODevice::Append);
+   while ( ret < amount && !_lost.isEmpty() )
+   {
+      int index {_lost.dequeue()};
+      if ( _owners.value(index,0) == -1 )
+      {
+         _owners.insert(index,rank);
+         std::unique_ptr<EAbstractAnalyticBlock> work {makeWork(index)};
+         stream << work->toBytes();
+         ++ret;
+      }
+   }
+
+   // If any work blocks were added then send the work batch to the slave node.
+   if ( ret > 0 )
+   {
+      _slaves[rank].outstanding += ret;
+      _mpi.sendData(rank,data);
+   }
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * Marks the slave node with the given rank as lost, queueing all of its work
+ * blocks still waiting for a result block to be sent to other slave nodes and
+ * sending them to every other ready slave node with room. A lost slave node is
+ * not sent any more work blocks unless it sends result blocks again.
+ *
+ * @param rank Process rank of the slave node that is lost.
+ */
+void MPIMaster::markLost(int rank)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,rank);
+
+   // Mark the slave node as lost with no outstanding work blocks. If it sends its
+   // result blocks through a local leader then the local leader no longer waits for
+   // it.
+   Slave& slave {_slaves[rank]};
+   slave.lost = true;
+   slave.outstanding = 0;
+   int leader {_mpi.leader(rank)};
+   if ( _reduce && leader != rank && leader != 0 )
+   {
+      --_slaves[leader].followers;
+   }
+
+   // Queue all indexes owned by the slave node in order.
+   QVector<int> indexes;
+   for (auto i = _owners.begin(); i != _owners.end() ;++i)
+   {
+      if ( *i == rank )
+      {
+         *i = -1;
+         indexes << i.key();
+      }
+   }
+   std::sort(indexes.begin(),indexes.end());
+   for (auto index: indexes)
+   {
+      _lost.enqueue(index);
+   }
+
+   // Send the queued work blocks to all other ready slave nodes with room.
+   for (int i = 1; i < _slaves.size() ;++i)
+   {
+      const Slave& other {_slaves.at(i)};
+      if ( !other.lost && !other.terminated && other.capacity > 0 )
+      {
+         dispatch(i,0);
+      }
+   }
+}
+
+
+
+
+
+
+/*!
+ * Sends a terminate code to every idle slave node.
+ */
+void MPIMaster::terminateAll()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Iterate through all slave nodes, terminating each one if it is idle.
+   for (int i = 1; i < _slaves.size() ;++i)
+   {
+      terminateIdle(i);
+   }
+}
+
+
+
+
+
+
+/*!
+ * Sends a terminate code to the slave node with the given process rank if it
+ * has signaled it is ready, is not lost, has no outstanding work blocks, and no
+ * other slave nodes still send their result blocks through it. If the slave
+ * node sends its result blocks through a local leader then the local leader is
+ * checked again after it is terminated.
+ *
+ * @param rank Process rank of the slave node that is checked.
+ */
+void MPIMaster::terminateIdle(int rank)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,rank);
+
+   // If the slave node is not idle then do nothing and exit, else go to the next
+   // step.
+   Slave& slave {_slaves[rank]};
+   if ( slave.terminated
+        || slave.lost
+        || slave.capacity == 0
+        || slave.outstanding > 0
+        || slave.followers > 0 )
+   {
+      return;
+   }
+
+   // Send the terminate code to the slave node. If it sends its result blocks
+   // through a local leader then check the local leader again.
+   terminate(rank);
+   slave.terminated = true;
+   int leader {_mpi.leader(rank)};
+   if ( _reduce && leader != rank && leader != 0 )
+   {
+      --_slaves[leader].followers;
+      terminateIdle(leader);
    }
 }
 
@@ -272,5 +891,104 @@ void MPIMaster::terminate(int rank)
    _mpi.sendData(rank,code->toBytes());
 }
 
+
+
+
+
+
+/*!
+ * Reads the header of this manager's checkpoint file and, if it is from a
+ * previous run of the same analytic with the same arguments, writes every
+ * result block saved before its mark to this manager's analytic again. The
+ * result block that would finish this run is never written again, so a
+ * resumed run always finishes normally with its slave nodes. Anything saved
+ * after the last result block written again is removed from the checkpoint
+ * file.
+ *
+ * @return True if this run was resumed from the checkpoint file or false if it
+ *         must be started over.
+ */
+bool MPIMaster::restoreCheckpoint()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Read the header and mark of the checkpoint file. If they do not match this run
+   // then return false, else go to the next step.
+   QDataStream& stream {*_checkpointStream};
+   qint32 version;
+   quint16 type;
+   qint32 size;
+   QByteArray key;
+   qint32 mark;
+   qint64 end;
+   stream >> version >> type >> size >> key;
+   _markOffset = _checkpoint->pos();
+   stream >> mark >> end;
+   if ( stream.status() != QDataStream::Ok
+        || version != _checkpointVersion
+        || type != analyticType()
+        || size != analytic()->size()
+        || key != runKey()
+        || end > _checkpoint->size() )
+   {
+      stream.resetStatus();
+      return false;
+   }
+
+   // Read each saved result block with the number of indexes it covers, writing it
+   // to this manager's analytic, until the mark is reached, one cannot be read, or
+   // it would finish this run.
+   qint64 valid {_checkpoint->pos()};
+   while ( _nextResult < mark && valid < end )
+   {
+      int span;
+      QByteArray data;
+      stream >> span >> data;
+      if ( stream.status() != QDataStream::Ok
+           || span < 1
+           || _nextResult + span >= analytic()->size()
+           || EAbstractAnalyticBlock::extractIndex(data) != _nextResult )
+      {
+         break;
+      }
+      AbstractManager::writeResult(makeResult(data),_nextResult);
+      _nextResult += span;
+      valid = _checkpoint->pos();
+   }
+
+   // Remove anything in the checkpoint file after the last result block written,
+   // continue making work blocks from the next result index, and return true.
+   stream.resetStatus();
+   _checkpoint->resize(valid);
+   _checkpoint->seek(valid);
+   _nextWork = _nextResult;
+   return true;
+}
+
+
+
+
+
+
+/*!
+ * Returns the path of this manager's checkpoint file, which is in the chunk
+ * working directory with the chunk prefix and extension.
+ *
+ * @return Path of the checkpoint file.
+ */
+QString MPIMaster::checkpointPath()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Build and return the checkpoint file path from the global settings object.
+   Settings& settings {Settings::instance()};
+   return settings.chunkDir().append("/")
+                             .append(settings.chunkPrefix())
+                             .append("checkpoint.")
+                             .append(settings.chunkExtension());
+}
+
 }
 }
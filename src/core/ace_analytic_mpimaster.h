@@ -1,5 +1,9 @@
 #ifndef ACE_ANALYTIC_MPIMASTER_H
 #define ACE_ANALYTIC_MPIMASTER_H
+#include <QElapsedTimer>
+#include <QHash>
+#include <QQueue>
+#include <QTimer>
 #include "ace_analytic_abstractmpi.h"
 #include "ace_analytic_abstractinput.h"
 
@@ -28,6 +32,28 @@ namespace Ace
        * does not process blocks itself it has no abstract run object of its own. Also
        * this manager does not start giving out work blocks to slave nodes until they
        * signal they are ready to process them.
+       *
+       * Work blocks are sent to slave nodes in batches of contiguous indexes and
+       * result blocks are received in batches. The number of work blocks each slave
+       * node is given is sized from its measured throughput so fast and slow slave
+       * nodes both stay busy with few messages. If the analytic can make work blocks
+       * on any node then only ranges of indexes are sent and each slave node makes
+       * its own work blocks.
+       *
+       * If MPI reduction is enabled then slave nodes that share a system, other than
+       * the one of this master node, send their result blocks to their local leader
+       * which sends them here together as a gathered batch. A local leader is not sent
+       * the terminate code until every slave node that sends it result blocks has
+       * been.
+       *
+       * If the MPI timeout is set then a slave node with outstanding work blocks that
+       * sends no result blocks for that long is assumed lost and its work blocks are
+       * given to other slave nodes. No slave node is sent the terminate code until
+       * every result block is received, so there is always one to give them to. If
+       * the MPI checkpoint interval is set then every result block written is also
+       * saved to a checkpoint file which is marked that often, so a stopped run
+       * started again writes the saved result blocks and continues from its last
+       * mark.
        */
       class MPIMaster : public AbstractMPI, public AbstractInput
       {
@@ -40,12 +66,80 @@ namespace Ace
       protected:
          virtual int index() const override final;
          virtual void writeResult(std::unique_ptr<EAbstractAnalyticBlock>&& result) override final;
+         virtual void mpiResume() override final;
       private slots:
          void dataReceived(const QByteArray& data, int fromRank);
+         void checkTimeouts();
+         void saveCheckpoint();
       private:
-         void processCode(int code, int fromRank);
-         void process(const QByteArray& data, int fromRank);
+         /*!
+          * This holds the dispatch state of a single slave node.
+          */
+         struct Slave
+         {
+            /*!
+             * The number of work blocks this slave node can process at once plus its
+             * buffer, given when it signals it is ready.
+             */
+            int capacity {0};
+            /*!
+             * The number of work blocks sent to this slave node whose result blocks have
+             * not been received.
+             */
+            int outstanding {0};
+            /*!
+             * The measured throughput of this slave node in blocks per second, or 0 if
+             * it has not been measured.
+             */
+            double rate {0};
+            /*!
+             * The time, in milliseconds since this manager was created, this slave node
+             * last signaled it is ready or sent result blocks.
+             */
+            qint64 last {0};
+            /*!
+             * True if this slave node has been sent the terminate code or false
+             * otherwise.
+             */
+            bool terminated {false};
+            /*!
+             * The number of slave nodes that send their result blocks through this slave
+             * node that have not been sent the terminate code.
+             */
+            int followers {0};
+            /*!
+             * True if this slave node has been assumed lost because it sent no result
+             * blocks within the MPI timeout or false otherwise.
+             */
+            bool lost {false};
+         };
+      private:
+         /*!
+          * The time, in seconds, of processing by a slave node at its measured
+          * throughput that is kept sent to it beyond its capacity.
+          */
+         constexpr static double _batchTime {0.5};
+         /*!
+          * The maximum number of work blocks sent to a slave node beyond its capacity.
+          */
+         constexpr static int _maxBatch {4096};
+         /*!
+          * The version of the checkpoint file format written by this manager.
+          */
+         constexpr static qint32 _checkpointVersion {1};
+      private:
+         void processCode(int code, const QByteArray& data, int fromRank);
+         void processBatch(const QByteArray& data, int fromRank);
+         void processGathered(const QByteArray& data);
+         void process(const QByteArray& data, int span = 1);
+         void dispatch(int rank, int finished);
+         int reassign(int rank, int amount);
+         void markLost(int rank);
+         void terminateAll();
+         void terminateIdle(int rank);
          void terminate(int rank);
+         bool restoreCheckpoint();
+         QString checkpointPath();
       private:
          /*!
           * Reference to the singleton MPI object.
@@ -59,6 +153,60 @@ namespace Ace
           * Next result block index to be processed to maintain order.
           */
          int _nextResult {0};
+         /*!
+          * The dispatch state of each slave node indexed by its rank.
+          */
+         QVector<Slave> _slaves;
+         /*!
+          * The number of indexes covered by each reduced result block waiting in the
+          * hopper that covers more than one, indexed by its own index.
+          */
+         QHash<int,int> _spans;
+         /*!
+          * True if MPI reduction is enabled for this run or false otherwise.
+          */
+         bool _reduce;
+         /*!
+          * The rank of the slave node each work block index without a result block is
+          * sent to, or -1 if it is waiting to be sent again because its slave node was
+          * assumed lost.
+          */
+         QHash<int,int> _owners;
+         /*!
+          * Queue of work block indexes of lost slave nodes waiting to be sent to other
+          * slave nodes.
+          */
+         QQueue<int> _lost;
+         /*!
+          * The MPI timeout in milliseconds, or 0 if slave nodes are never assumed lost.
+          */
+         qint64 _timeout;
+         /*!
+          * Timer used to check for lost slave nodes.
+          */
+         QTimer _watchdog;
+         /*!
+          * Timer used to mark the checkpoint file.
+          */
+         QTimer _checkpointTimer;
+         /*!
+          * Pointer to the checkpoint file or null if checkpoints are disabled.
+          */
+         QFile* _checkpoint {nullptr};
+         /*!
+          * Pointer to the qt data stream used to write the checkpoint file or null if
+          * checkpoints are disabled.
+          */
+         QDataStream* _checkpointStream {nullptr};
+         /*!
+          * The position in the checkpoint file of its mark, which is the next result
+          * index followed by the position where its saved result blocks end.
+          */
+         qint64 _markOffset {0};
+         /*!
+          * Timer used to measure the throughput of slave nodes.
+          */
+         QElapsedTimer _clock;
       };
    }
 }
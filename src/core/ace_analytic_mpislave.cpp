@@ -1,6 +1,9 @@
 #include "ace_analytic_mpislave.h"
+#include <QDataStream>
+#include <QTimer>
 #include "ace_analytic_mpimaster.h"
 #include "ace_analytic_serialrun.h"
+#include "ace_analytic_threadpoolrun.h"
 #include "ace_analytic_openclrun.h"
 #include "ace_analytic_cudarun.h"
 #include "ace_qmpi.h"
@@ -54,8 +57,20 @@ MPISlave::MPISlave(quint16 type)
    AbstractMPI(type),
    _mpi(QMPI::instance())
 {
+   // Add the debug header.
    EDEBUG_FUNC(this,type);
+
+   // Connect the MPI data received signal. If MPI reduction is enabled and this node
+   // is not on the same system as the master node then determine if it gathers the
+   // result batches of its system as the local leader or sends its result batches to
+   // the local leader.
    connect(&_mpi,&QMPI::dataReceived,this,&MPISlave::dataReceived);
+   int leader {_mpi.leader(_mpi.rank())};
+   if ( Settings::instance().reductionEnabled() && leader != 0 )
+   {
+      _forward = leader != _mpi.rank();
+      _gather = !_forward && _mpi.localSize() > 1;
+   }
 }
 
 
@@ -98,10 +113,11 @@ void MPISlave::mpiStart(Type type, int platform, int device)
    // given resource type is serial or OpenCL, respectively. If initializing OpenCL
    // fails then fall back to initializing a serial run object.
    int code {ReadyAsSerial};
+   int threads {1};
    switch (type)
    {
    case Type::Serial:
-      setupSerial();
+      threads = setupSerial();
       break;
    case Type::OpenCL:
       if ( setupOpenCL(platform,device) )
@@ -110,7 +126,7 @@ void MPISlave::mpiStart(Type type, int platform, int device)
       }
       else
       {
-         setupSerial();
+         threads = setupSerial();
       }
       break;
    case Type::CUDA:
@@ -120,17 +136,31 @@ void MPISlave::mpiStart(Type type, int platform, int device)
       }
       else
       {
-         setupSerial();
+         threads = setupSerial();
       }
       break;
    }
 
+   // If the serial resource is running with more than one thread then signal the
+   // master node it is ready as a thread pool instead.
+   if ( code == ReadyAsSerial && threads > 1 )
+   {
+      code = ReadyAsThreadPool;
+   }
+
    // Connect the runner object finished signal to this abstract manager's finish
    // slot and send a special code to the master node signaling this slave node is
-   // ready to process work blocks with the resource type it was given.
+   // ready to process work blocks with the resource type it was given. If this is a
+   // thread pool then its thread size is appended after the code.
    connect(_runner,&AbstractRun::finished,this,&AbstractManager::finish);
    std::unique_ptr<EAbstractAnalyticBlock> block {new EAbstractAnalyticBlock(code)};
-   _mpi.sendData(0,block->toBytes());
+   QByteArray data {block->toBytes()};
+   if ( code == ReadyAsThreadPool )
+   {
+      QDataStream stream(&data,QIODevice::WriteOnly|QIODevice::Append);
+      stream << threads;
+   }
+   _mpi.sendData(0,data);
 }
 
 
@@ -190,8 +220,9 @@ Ace::DataObject* MPISlave::addOutputData(const QString& path, quint16 type, cons
 /*!
  * Implements the interface that saves the given result block to its underlying
  * analytic and assumes the order of indexes given is not sorted and random.
- * This implementation simply sends the given result block back to the master
- * node.
+ * This implementation adds the given result block to the result batch sent back
+ * to the master node, sending the batch once this slave node has finished at
+ * least as many work blocks as it has left.
  *
  * @param result The result block that is sent to the master node for saving.
  */
@@ -200,11 +231,31 @@ void MPISlave::saveResult(std::unique_ptr<EAbstractAnalyticBlock>&& result)
    // Add the debug header.
    EDEBUG_FUNC(this,result.get());
 
-   // Send the result block to the master node as byte data, deleting the result
+   // If the result batch is empty then start it with the result batch code.
+   if ( _results.isEmpty() )
+   {
+      std::unique_ptr<EAbstractAnalyticBlock> code {new EAbstractAnalyticBlock(ResultBatch)};
+      _results = code->toBytes();
+   }
+
+   // Add the result block to the result batch as byte data, deleting the result
    // block and decreasing this object's work size.
-   _mpi.sendData(0,result->toBytes());
+   QDataStream stream(&_results,QIODevice::WriteOnly|QIODevice::Append);
+   stream << result->toBytes();
    result.reset();
+   ++_resultSize;
    --_workSize;
+   --_runSize;
+
+   // If this slave node has finished at least as many work blocks as it has left
+   // then send the result batch to the master node.
+   if ( _resultSize >= _workSize )
+   {
+      sendResults();
+   }
+
+   // Make more work blocks from any remaining index ranges.
+   feed();
 }
 
 
@@ -241,7 +292,7 @@ void MPISlave::dataReceived(const QByteArray& data, int fromRank)
    int code {EAbstractAnalyticBlock::extractIndex(data)};
    if ( code < 0 )
    {
-      processCode(code);
+      processCode(code,data);
    }
    else
    {
@@ -255,16 +306,64 @@ void MPISlave::dataReceived(const QByteArray& data, int fromRank)
 
 
 /*!
- * Processes a special code sent to this slave node by the master node. The only
- * special code processed is to terminate signaling no more work blocks will be
- * sent.
+ * Processes a special code sent to this slave node by the master node. The
+ * special codes processed are a batch of work blocks, a range of work blocks to
+ * make, and to terminate signaling no more work blocks will be sent.
  *
  * @param code The special code sent to this slave node by the master node.
+ *
+ * @param data The data containing the special code and any arguments that
+ *             follow it.
  */
-void MPISlave::processCode(int code)
+void MPISlave::processCode(int code, const QByteArray& data)
 {
    // Add the debug header.
-   EDEBUG_FUNC(this,code);
+   EDEBUG_FUNC(this,code,data);
+
+   // If the special code is a work batch then process each work block that follows
+   // the code block's header, making sure it worked, and exit.
+   if ( code == MPIMaster::WorkBatch )
+   {
+      QDataStream stream(data);
+      stream.skipRawData(EAbstractAnalyticBlock::headerSize());
+      while ( !stream.atEnd() )
+      {
+         QByteArray block;
+         stream >> block;
+         if ( stream.status() != QDataStream::Ok )
+         {
+            E_MAKE_EXCEPTION(e);
+            e.setTitle(tr("Logic Error"));
+            e.setDetails(tr("Master MPI node sent corrupt work batch to slave."));
+            throw e;
+         }
+         process(block);
+      }
+      return;
+   }
+
+   // If the special code is a work range then read its first index and size, making
+   // sure it worked, add it to this object's index ranges, and make work blocks from
+   // it.
+   if ( code == MPIMaster::WorkRange )
+   {
+      int first;
+      int size;
+      QDataStream stream(data);
+      stream.skipRawData(EAbstractAnalyticBlock::headerSize());
+      stream >> first >> size;
+      if ( stream.status() != QDataStream::Ok || first < 0 || size < 1 )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("Logic Error"));
+         e.setDetails(tr("Master MPI node sent invalid work range to slave."));
+         throw e;
+      }
+      _ranges.enqueue(qMakePair(first,first + size));
+      _workSize += size;
+      feed();
+      return;
+   }
 
    // If the special code is to terminate then go to the next step, else throw an
    // exception.
@@ -321,6 +420,7 @@ void MPISlave::process(const QByteArray& data)
    // Increase this object's work size and add the work block to this object's
    // abstract run object.
    ++_workSize;
+   ++_runSize;
    _runner->addWork(std::move(work));
 }
 
@@ -329,6 +429,241 @@ void MPISlave::process(const QByteArray& data)
 
 
 
+/*!
+ * Sends the result batch of this slave node to the master node and clears it.
+ * If this slave node is a local leader then the result batch is gathered
+ * instead, and if it has a local leader then the result batch is sent to it.
+ */
+void MPISlave::sendResults()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Send the result batch to the master node, its local leader, or gather it
+   // depending on this slave node's role and start a new one.
+   if ( _gather )
+   {
+      gather(_results,_mpi.rank());
+   }
+   else if ( _forward )
+   {
+      _mpi.sendLocalData(0,_results);
+   }
+   else
+   {
+      _mpi.sendData(0,_results);
+   }
+   _results.clear();
+   _resultSize = 0;
+}
+
+
+
+
+
+
+/*!
+ * Implements the interface that is called when this node receives a result
+ * batch from another node on its system. This implementation gathers it with
+ * the result blocks sent to the master node.
+ *
+ * @param data The data containing the result batch.
+ *
+ * @param fromRank The local rank of the node that sent the result batch.
+ */
+void MPISlave::localResultsReceived(const QByteArray& data, int fromRank)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,data,fromRank);
+
+   // If this slave node does not gather result batches then throw an exception, else
+   // gather the result batch.
+   if ( !_gather )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Logic Error"));
+      e.setDetails(tr("Slave node that is not a local leader received result batch."));
+      throw e;
+   }
+   gather(data,_mpi.worldRank(fromRank));
+}
+
+
+
+
+
+
+/*!
+ * Adds the result blocks of the given result batch to this local leader's
+ * gathered result blocks. The gathered result blocks are sent once every node
+ * on this system has sent a result batch or shortly after the first one if
+ * they have not.
+ *
+ * @param data The data containing the result batch.
+ *
+ * @param rank The world rank of the node whose result batch it is.
+ */
+void MPISlave::gather(const QByteArray& data, int rank)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,data,rank);
+
+   // Read each result block that follows the code block's header, making sure it
+   // worked, and add it to the gathered result blocks.
+   int size {0};
+   QDataStream stream(data);
+   stream.skipRawData(EAbstractAnalyticBlock::headerSize());
+   while ( !stream.atEnd() )
+   {
+      QByteArray block;
+      stream >> block;
+      if ( stream.status() != QDataStream::Ok )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("Logic Error"));
+         e.setDetails(tr("Slave MPI node sent corrupt result batch to local leader."));
+         throw e;
+      }
+      _gathered.insert(EAbstractAnalyticBlock::extractIndex(block),block);
+      ++size;
+   }
+   _origins << qMakePair(rank,size);
+
+   // If every node on this system has sent a result batch then send the gathered
+   // result blocks now, else schedule sending them if that has not been done.
+   if ( _origins.size() >= _mpi.localSize() )
+   {
+      sendGathered();
+   }
+   else if ( !_scheduled )
+   {
+      _scheduled = true;
+      QTimer::singleShot(10,this,&MPISlave::sendGathered);
+   }
+}
+
+
+
+
+
+
+/*!
+ * Sends this local leader's gathered result blocks to the master node as one
+ * gathered batch and clears them. Each run of result blocks with adjacent
+ * indexes is reduced into one result block by this manager's analytic if it
+ * can. This does nothing if there are no gathered result blocks.
+ */
+void MPISlave::sendGathered()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // If there are no gathered result blocks then do nothing and exit, else go to the
+   // next step.
+   _scheduled = false;
+   if ( _origins.isEmpty() )
+   {
+      return;
+   }
+
+   // Start the gathered batch with its code and the world rank and number of result
+   // blocks of each node whose result batch it contains.
+   std::unique_ptr<EAbstractAnalyticBlock> code {new EAbstractAnalyticBlock(GatheredBatch)};
+   QByteArray data {code->toBytes()};
+   QDataStream stream(&data,QIODevice::WriteOnly|QIODevice::Append);
+   stream << _origins.size();
+   for (auto origin: _origins)
+   {
+      stream << origin.first << origin.second;
+   }
+
+   // Iterate through all gathered result blocks in order. If the next result block
+   // has the index directly after the current one then reduce them into one result
+   // block until the indexes are not adjacent or this manager's analytic refuses to.
+   // Add each result block to the gathered batch along with the number of indexes it
+   // covers.
+   auto i = _gathered.cbegin();
+   while ( i != _gathered.cend() )
+   {
+      int index {i.key()};
+      int span {1};
+      QByteArray bytes {*i++};
+      if ( _reducible && i != _gathered.cend() && i.key() == index + span )
+      {
+         std::unique_ptr<EAbstractAnalyticBlock> result {makeResult(bytes)};
+         while ( i != _gathered.cend() && i.key() == index + span )
+         {
+            std::unique_ptr<EAbstractAnalyticBlock> next {makeResult(*i)};
+            if ( !analytic()->reduce(result.get(),next.get()) )
+            {
+               _reducible = false;
+               break;
+            }
+            ++span;
+            ++i;
+         }
+         if ( span > 1 )
+         {
+            bytes = result->toBytes();
+         }
+      }
+      stream << span << bytes;
+   }
+
+   // Send the gathered batch to the master node and clear the gathered result
+   // blocks.
+   _mpi.sendData(0,data);
+   _gathered.clear();
+   _origins.clear();
+}
+
+
+
+
+
+
+/*!
+ * Makes work blocks from this object's index ranges and adds them to this
+ * object's abstract run object until it holds its capacity plus the buffer size
+ * or there are no more index ranges. This does nothing if it is already making
+ * work blocks, which happens when a serial run saves a result block while its
+ * work block is added.
+ */
+void MPISlave::feed()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // If this is already making work blocks then do nothing and exit, else go to the
+   // next step.
+   if ( _feeding )
+   {
+      return;
+   }
+   _feeding = true;
+
+   // Make work blocks from the first index range, removing it once it is empty, and
+   // add them to this object's abstract run object while it has room.
+   int limit {_runner->capacity() + Settings::instance().bufferSize()};
+   while ( !_ranges.isEmpty() && _runSize < limit )
+   {
+      QPair<int,int>& range {_ranges.head()};
+      std::unique_ptr<EAbstractAnalyticBlock> work {makeWork(range.first++)};
+      if ( range.first >= range.second )
+      {
+         _ranges.dequeue();
+      }
+      ++_runSize;
+      _runner->addWork(std::move(work));
+   }
+   _feeding = false;
+}
+
+
+
+
+
+
 /*!
  * Initializes a new CUDA run object for block processing of this slave node
  * manager, returning true if this was successful or false otherwise. If the
@@ -422,11 +757,15 @@ bool MPISlave::setupOpenCL(int platform, int device)
 
 
 /*!
- * Initializes a new serial run object for block processing of this slave node
- * manager. If this manager's analytic fails creating a valid abstract serial
+ * Initializes a new thread pool or serial run object for block processing of
+ * this slave node manager, returning the number of threads it uses. The CPU
+ * cores of this node are shared with all other processes of the same local
+ * rank. If this manager's analytic fails creating a valid abstract serial
  * object then an exception is thrown.
+ *
+ * @return Number of threads the new run object uses.
  */
-void MPISlave::setupSerial()
+int MPISlave::setupSerial()
 {
    // Add the debug header.
    EDEBUG_FUNC(this);
@@ -434,10 +773,21 @@ void MPISlave::setupSerial()
    // Create a new abstract serial object from this manager's analytic. If creating a
    // new abstract serial object fails then throw an exception, else go to the next
    // step.
+   int ret {1};
    if ( EAbstractAnalyticSerial* serial = analytic()->makeSerial() )
    {
-      // Create a new serial run object and set to as this object's runner.
-      _runner = new SerialRun(serial,this,this);
+      // Create a new thread pool run object if this node's share of CPU threads is
+      // more than one or a new serial run object otherwise and set it as this object's
+      // runner.
+      ret = ThreadPoolRun::size(_mpi.localSize());
+      if ( ret > 1 )
+      {
+         _runner = new ThreadPoolRun(analytic(),serial,ret,this,this);
+      }
+      else
+      {
+         _runner = new SerialRun(serial,this,this);
+      }
    }
    else
    {
@@ -446,6 +796,7 @@ void MPISlave::setupSerial()
       e.setDetails(tr("Cannot run simple analytic in MPI mode."));
       throw e;
    }
+   return ret;
 }
 
 }
@@ -1,5 +1,7 @@
 #ifndef ACE_ANALYTIC_MPISLAVE_H
 #define ACE_ANALYTIC_MPISLAVE_H
+#include <QQueue>
+#include <QMap>
 #include "ace_analytic_abstractmpi.h"
 #include "ace_analytic_abstractinput.h"
 #include "ace_analytic.h"
@@ -30,6 +32,22 @@ namespace Ace
        * This special signal to the master node is not sent until it is given the
        * resource type it will use by having the interface mpi start called from its
        * inherited abstract class.
+       *
+       * Work blocks are received in batches and result blocks are sent back in
+       * batches. A result batch is sent once this slave node has finished at least as
+       * many work blocks as it has left, which also asks the master node for more
+       * work before this slave node runs out.
+       *
+       * If the analytic can make work blocks on any node then this slave node is only
+       * sent ranges of indexes. Work blocks are made from them as this slave node's
+       * abstract run object has room, so only its capacity plus the buffer size of
+       * work blocks are held at once.
+       *
+       * If MPI reduction is enabled then slave nodes on a system other than the one of
+       * the master node send their result batches to their local leader instead. The
+       * local leader gathers the result blocks of every node on its system, reduces
+       * adjacent result blocks if its analytic can, and sends them all to the master
+       * node as one gathered batch.
        */
       class MPISlave : public AbstractMPI, public AbstractInput
       {
@@ -44,14 +62,19 @@ namespace Ace
          virtual QFile* addOutputFile(const QString& path) override final;
          virtual Ace::DataObject* addOutputData(const QString& path, quint16 type, const EMetadata& system) override final;
          virtual void saveResult(std::unique_ptr<EAbstractAnalyticBlock>&& result) override final;
+         virtual void localResultsReceived(const QByteArray& data, int fromRank) override final;
       private slots:
          void dataReceived(const QByteArray& data, int fromRank);
+         void sendGathered();
       private:
-         void processCode(int code);
+         void processCode(int code, const QByteArray& data);
          void process(const QByteArray& data);
+         void sendResults();
+         void gather(const QByteArray& data, int rank);
+         void feed();
          bool setupCUDA(int device);
          bool setupOpenCL(int platform, int device);
-         void setupSerial();
+         int setupSerial();
       private:
          /*!
           * Reference to the singleton MPI object.
@@ -65,11 +88,66 @@ namespace Ace
           * The total number of work blocks this slave node is currently processing.
           */
          int _workSize {0};
+         /*!
+          * The total number of work blocks that have been added to this object's
+          * abstract run object and whose result blocks have not been saved.
+          */
+         int _runSize {0};
+         /*!
+          * Queue of index ranges of work blocks this slave node must still make. Each
+          * range is its first index and its end index.
+          */
+         QQueue<QPair<int,int>> _ranges;
+         /*!
+          * True while this slave node is making work blocks from its index ranges or
+          * false otherwise. This keeps result blocks saved during that time from making
+          * more.
+          */
+         bool _feeding {false};
+         /*!
+          * The result batch of result blocks waiting to be sent to the master node, or
+          * empty if there are none.
+          */
+         QByteArray _results;
+         /*!
+          * The number of result blocks in the result batch waiting to be sent.
+          */
+         int _resultSize {0};
          /*!
           * True if this slave node has received the terminate signal from the master
           * node or false otherwise.
           */
          bool _finished {false};
+         /*!
+          * True if this slave node sends its result batches to its local leader or
+          * false otherwise.
+          */
+         bool _forward {false};
+         /*!
+          * True if this slave node is a local leader that gathers the result batches of
+          * its system or false otherwise.
+          */
+         bool _gather {false};
+         /*!
+          * True if this slave node still attempts to reduce gathered result blocks or
+          * false once its analytic has refused to.
+          */
+         bool _reducible {true};
+         /*!
+          * The gathered result blocks waiting to be sent to the master node as byte
+          * data, indexed by their index.
+          */
+         QMap<int,QByteArray> _gathered;
+         /*!
+          * The world rank of each node whose result batch is in the gathered result
+          * blocks along with the number of result blocks it contained.
+          */
+         QVector<QPair<int,int>> _origins;
+         /*!
+          * True if sending the gathered result blocks has been scheduled or false
+          * otherwise.
+          */
+         bool _scheduled {false};
       };
    }
 }
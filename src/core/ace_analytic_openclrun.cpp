@@ -24,9 +24,9 @@ namespace Analytic
 
 /*!
  * Implements the interface that is called to add a work block to be processed
- * by this abstract run. This implementation waits until a thread is idle and
- * then adding the given work block to the idle thread for execution. While this
- * waits it is blocking.
+ * by this abstract run. This implementation adds the given work block to an
+ * idle thread for execution if there is one, else it is queued until a thread
+ * finishes. This never blocks.
  *
  * @param block The work block that is processed.
  */
@@ -35,16 +35,34 @@ void OpenCLRun::addWork(std::unique_ptr<EAbstractAnalyticBlock>&& block)
    // Add the debug header.
    EDEBUG_FUNC(this,block.get());
 
-   // Wait until there is at least one idle thread, blocking execution until that is
-   // the case.
-   while ( _idle.isEmpty() )
+   // If there is an idle thread then add the given work block to it for execution in
+   // its own thread, else add the work block to this object's queue of waiting work.
+   if ( !_idle.isEmpty() )
    {
-      QCoreApplication::processEvents();
+      _idle.dequeue()->execute(std::move(block));
    }
+   else
+   {
+      _work.enqueue(block.release());
+   }
+}
+
+
 
-   // Add the given work block to the first idle thread for execution in its own
-   // thread.
-   _idle.dequeue()->execute(std::move(block));
+
+
+
+/*!
+ * Implements the interface that returns the number of work blocks this abstract
+ * run can process at the same time. This implementation returns the number of
+ * threads it contains.
+ *
+ * @return Number of work blocks this abstract run processes at once.
+ */
+int OpenCLRun::capacity() const
+{
+   EDEBUG_FUNC(this);
+   return _threads.size();
 }
 
 
@@ -115,14 +133,17 @@ OpenCLRun::~OpenCLRun()
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   // Iterate through all threads, for each one waiting until it is no longer running
-   // and then deleting it.
+   // Iterate through all threads, for each one asking it to stop, waiting until it
+   // is no longer running, and then deleting it.
    for (auto thread: _threads)
    {
-      thread->requestInterruption();
-      while ( thread->isRunning() );
+      thread->stop();
+      thread->wait();
       delete thread;
    }
+
+   // Delete any work blocks still waiting in this object's queue.
+   qDeleteAll(_work);
 }
 
 
@@ -141,10 +162,18 @@ void OpenCLRun::blockFinished(int index)
    EDEBUG_FUNC(this,index);
 
    // Get the result block from the thread that finished execution, saving it to this
-   // object's abstract input and adding the thread to this object's idle queue.
+   // object's abstract input. If there is queued work then give the next work block
+   // to the thread, else add the thread to this object's idle queue.
    OpenCLRunThread* thread {_threads.at(index)};
    _base->saveResult(thread->result());
-   _idle.enqueue(thread);
+   if ( !_work.isEmpty() )
+   {
+      thread->execute(std::unique_ptr<EAbstractAnalyticBlock>(_work.dequeue()));
+   }
+   else
+   {
+      _idle.enqueue(thread);
+   }
 
    // If this object's abstract input is finished then emit the finished signal.
    if ( _base->isFinished() )
@@ -37,6 +37,7 @@ namespace Ace
          Q_OBJECT
       public:
          virtual void addWork(std::unique_ptr<EAbstractAnalyticBlock>&& block) override final;
+         virtual int capacity() const override final;
       public:
          explicit OpenCLRun(EAbstractAnalyticOpenCL* opencl, OpenCL::Device* device, AbstractInput* base, QObject* parent = nullptr);
          virtual ~OpenCLRun() override final;
@@ -65,6 +66,10 @@ namespace Ace
           * Queue of idle threads ready to execute another work block.
           */
          QQueue<OpenCLRunThread*> _idle;
+         /*!
+          * Queue of work blocks waiting for an idle thread.
+          */
+         QQueue<EAbstractAnalyticBlock*> _work;
       };
    }
 }
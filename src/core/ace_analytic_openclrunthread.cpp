@@ -1,5 +1,4 @@
 #include "ace_analytic_openclrunthread.h"
-#include "eexception.h"
 #include "edebug.h"
 #include "eabstractanalyticblock.h"
 #include "eabstractanalyticopenclworker.h"
@@ -27,7 +26,7 @@ namespace Analytic
  */
 OpenCLRunThread::OpenCLRunThread(std::unique_ptr<EAbstractAnalyticOpenCLWorker>&& worker, QObject* parent)
    :
-   QThread(parent),
+   RunThread(parent),
    _worker(worker.release())
 {
    EDEBUG_FUNC(this,worker.get(),parent);
@@ -40,126 +39,18 @@ OpenCLRunThread::OpenCLRunThread(std::unique_ptr<EAbstractAnalyticOpenCLWorker>&
 
 
 /*!
- * Executes the processing of the given work block on a separate thread from the
- * one called this method. This returns immediately after starting the separate
- * thread. If this thread already contains a result block then an exception is
- * thrown.
+ * Implements the interface that processes the given work block into a result
+ * block on this object's separate thread, using this object's abstract OpenCL
+ * worker.
  *
- * @param block The work block that is processed on a separate thread.
- */
-void OpenCLRunThread::execute(std::unique_ptr<EAbstractAnalyticBlock>&& block)
-{
-   // Add the debug header.
-   EDEBUG_FUNC(this,block.get());
-
-   // If this thread already contains a result block then throw an exception, else go
-   // to the next step.
-   if ( _result )
-   {
-      E_MAKE_EXCEPTION(e);
-      e.setTitle(tr("Logic Error"));
-      e.setDetails(tr("Cannot execute OpenCL engine piston that contains a result."));
-      throw e;
-   }
-
-   // Delete any previous work block this object contains, set the given work block
-   // as this objects new work block and then start its separate thread.
-   delete _work;
-   _work = block.release();
-   _work->setParent(this);
-   ++_switch;
-}
-
-
-
-
-
-
-/*!
- * Returns the result block produces on this object's separate thread after
- * finishing. If the separate thread threw an exception that exception is thrown
- * again on the thread calling this method. If there is not result block an
- * exception is also thrown.
+ * @param block The work block that is processed.
  *
- * @return Result block produced by this object's separate thread execution.
- */
-std::unique_ptr<EAbstractAnalyticBlock> OpenCLRunThread::result()
-{
-   // Add the debug header.
-   EDEBUG_FUNC(this);
-
-   // If this object has a saved exception from its separate thread then copy it and
-   // throw it on this thread, else go to the next step.
-   if ( _exception )
-   {
-      EException e(*_exception);
-      delete _exception;
-      _exception = nullptr;
-      throw e;
-   }
-
-   // If this object does not contain a result block then throw an exception, else go
-   // the next step.
-   if ( !_result )
-   {
-      E_MAKE_EXCEPTION(e);
-      e.setTitle(tr("Logic Error"));
-      e.setDetails(tr("Cannot get result from OpenCL engine piston that contains none."));
-      throw e;
-   }
-
-   // Release this object's saved result block from its ownership and return it.
-   _result->setParent(nullptr);
-   std::unique_ptr<EAbstractAnalyticBlock> ret {_result};
-   _result = nullptr;
-   return ret;
-}
-
-
-
-
-
-
-/*!
- * Executes this object's saved work block on its separate thread, saving the
- * result block. If any exception is thrown within this separate thread it is
- * caught and saved.
+ * @return The result block of the given work block.
  */
-void OpenCLRunThread::run()
+std::unique_ptr<EAbstractAnalyticBlock> OpenCLRunThread::execute(const EAbstractAnalyticBlock* block)
 {
-   // Add the debug header.
-   EDEBUG_FUNC(this);
-
-   while (true)
-   {
-      if ( _switch == 1 )
-      {
-         // Process this object's saved work block, saving the result block and
-         // transferring it to this object's main thread. If any ACE exception occurs then
-         // catch it and save it.
-         try
-         {
-            _result = _worker->execute(_work).release();
-            _result->moveToThread(thread());
-            _result->setParent(this);
-         }
-         catch (EException e)
-         {
-            _exception = new EException(e);
-         }
-         --_switch;
-         emit blockFinished();
-      }
-      else if ( isInterruptionRequested() )
-      {
-         return;
-      }
-      usleep(10);
-      if ( _switch == 0 )
-      {
-         msleep(10);
-      }
-   }
+   EDEBUG_FUNC(this,block);
+   return _worker->execute(block);
 }
 
 }
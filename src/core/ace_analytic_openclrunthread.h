@@ -1,6 +1,6 @@
 #ifndef ACE_ANALYTIC_OPENCLRUNTHREAD_H
 #define ACE_ANALYTIC_OPENCLRUNTHREAD_H
-#include <QThread>
+#include "ace_analytic_runthread.h"
 #include "ace_analytic_openclrun.h"
 #include "global.h"
 
@@ -26,42 +26,20 @@ namespace Ace
        * separate thread to enhance speed. An abstract OpenCL worker object is used
        * for actual processing using an OpenCL device for acceleration.
        */
-      class OpenCLRunThread : public QThread
+      class OpenCLRunThread : public RunThread
       {
          Q_OBJECT
       public:
          explicit OpenCLRunThread(std::unique_ptr<EAbstractAnalyticOpenCLWorker>&& worker, QObject* parent = nullptr);
-         void execute(std::unique_ptr<EAbstractAnalyticBlock>&& block);
-         std::unique_ptr<EAbstractAnalyticBlock> result();
-      signals:
-         /*!
-          */
-         void blockFinished();
+         using RunThread::execute;
       protected:
-         virtual void run() override final;
+         virtual std::unique_ptr<EAbstractAnalyticBlock> execute(const EAbstractAnalyticBlock* block) override final;
       private:
-         /*!
-          */
-         QAtomicInteger<int> _switch {0};
          /*!
           * Pointer to the abstract OpenCL worker object used to process work blocks into
           * result blocks using OpenCL acceleration.
           */
          EAbstractAnalyticOpenCLWorker* _worker;
-         /*!
-          * Pointer to saved work block, if any, passed along to the separate thread for
-          * processing.
-          */
-         EAbstractAnalyticBlock* _work {nullptr};
-         /*!
-          * Pointer to result block, if any, saved by this object's separate thread.
-          */
-         EAbstractAnalyticBlock* _result {nullptr};
-         /*!
-          * Pointer to any exception that occurs on this object's separate thread while
-          * processing a work block.
-          */
-         EException* _exception {nullptr};
       };
    }
 }
@@ -0,0 +1,212 @@
+#include "ace_analytic_runthread.h"
+#include "eexception.h"
+#include "edebug.h"
+#include "eabstractanalyticblock.h"
+
+
+
+namespace Ace
+{
+namespace Analytic
+{
+
+
+
+
+
+
+/*!
+ * Constructs a new thread object with the given optional parent.
+ *
+ * @param parent Optional parent of this new thread object.
+ */
+RunThread::RunThread(QObject* parent)
+   :
+   QThread(parent)
+{
+   EDEBUG_FUNC(this,parent);
+}
+
+
+
+
+
+
+/*!
+ * Executes the processing of the given work block on a separate thread from the
+ * one called this method. This returns immediately after waking the separate
+ * thread. If this thread already contains a result block then an exception is
+ * thrown.
+ *
+ * @param block The work block that is processed on a separate thread.
+ */
+void RunThread::execute(std::unique_ptr<EAbstractAnalyticBlock>&& block)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,block.get());
+
+   // If this thread already contains a result block then throw an exception, else go
+   // to the next step.
+   QMutexLocker locker(&_mutex);
+   if ( _result || _pending )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Logic Error"));
+      e.setDetails(tr("Cannot execute run thread that contains a result."));
+      throw e;
+   }
+
+   // Delete any previous work block this object contains, set the given work block
+   // as this objects new work block and then wake its separate thread.
+   delete _work;
+   _work = block.release();
+   _work->setParent(this);
+   _pending = true;
+   _condition.wakeOne();
+}
+
+
+
+
+
+
+/*!
+ * Returns the result block produces on this object's separate thread after
+ * finishing. If the separate thread threw an exception that exception is thrown
+ * again on the thread calling this method. If there is not result block an
+ * exception is also thrown.
+ *
+ * @return Result block produced by this object's separate thread execution.
+ */
+std::unique_ptr<EAbstractAnalyticBlock> RunThread::result()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // If this object has a saved exception from its separate thread then copy it and
+   // throw it on this thread, else go to the next step.
+   QMutexLocker locker(&_mutex);
+   if ( _exception )
+   {
+      EException e(*_exception);
+      delete _exception;
+      _exception = nullptr;
+      throw e;
+   }
+
+   // If this object does not contain a result block then throw an exception, else go
+   // the next step.
+   if ( !_result )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Logic Error"));
+      e.setDetails(tr("Cannot get result from run thread that contains none."));
+      throw e;
+   }
+
+   // Release this object's saved result block from its ownership and return it.
+   _result->setParent(nullptr);
+   std::unique_ptr<EAbstractAnalyticBlock> ret {_result};
+   _result = nullptr;
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * Asks this object's separate thread to stop, waking it if it is waiting for
+ * work. Any work block currently being processed is finished first.
+ */
+void RunThread::stop()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Set the stop flag and wake the separate thread.
+   QMutexLocker locker(&_mutex);
+   _stop = true;
+   _condition.wakeOne();
+}
+
+
+
+
+
+
+/*!
+ * Waits for work blocks given to this object, executing each one on this
+ * object's separate thread and saving the result block. If any exception is
+ * thrown within this separate thread it is caught and saved. This returns once
+ * the stop method has been called.
+ */
+void RunThread::run()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Prepare this object's separate thread before it processes any work block.
+   initialize();
+
+   QMutexLocker locker(&_mutex);
+   while (true)
+   {
+      // Sleep until there is a pending work block or this thread is asked to stop.
+      while ( !_pending && !_stop )
+      {
+         _condition.wait(&_mutex);
+      }
+      if ( _stop )
+      {
+         return;
+      }
+
+      // Process this object's saved work block without holding the mutex, saving the
+      // result block and transferring it to this object's main thread. If any ACE
+      // exception occurs then catch it and save it.
+      const EAbstractAnalyticBlock* work {_work};
+      locker.unlock();
+      EAbstractAnalyticBlock* result {nullptr};
+      EException* exception {nullptr};
+      try
+      {
+         result = execute(work).release();
+         result->moveToThread(thread());
+      }
+      catch (EException e)
+      {
+         exception = new EException(e);
+      }
+      locker.relock();
+
+      // Save the result block or exception, clear the pending state, and signal the
+      // work block is finished.
+      if ( result )
+      {
+         result->setParent(this);
+      }
+      _result = result;
+      _exception = exception;
+      _pending = false;
+      emit blockFinished();
+   }
+}
+
+
+
+
+
+
+/*!
+ * Prepares this object's separate thread once it starts, before it processes
+ * any work block. The default implementation does nothing.
+ */
+void RunThread::initialize()
+{
+   EDEBUG_FUNC(this);
+}
+
+}
+}
@@ -0,0 +1,100 @@
+#ifndef ACE_ANALYTIC_RUNTHREAD_H
+#define ACE_ANALYTIC_RUNTHREAD_H
+#include <memory>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include "ace_analytic.h"
+#include "global.h"
+
+
+
+/*!
+ * This contains all private classes used internally by the ACE library and
+ * should never be accessed by a developer using this library.
+ */
+namespace Ace
+{
+   /*!
+    * This contains all classes related to running an analytic. This required its
+    * own name space because of the immense complexity required for ACE to provide
+    * an abstract interface for running analytic types in heterogeneous
+    * environments.
+    */
+   namespace Analytic
+   {
+      /*!
+       * This is a single thread of execution used by a run class to process work
+       * blocks into result blocks. The thread sleeps on a wait condition until it is
+       * given a work block or asked to stop, so an idle thread uses no CPU time. Work
+       * blocks are handed to this thread and result blocks or exceptions are handed
+       * back under its mutex, while the actual processing is done by the execute
+       * interface of an implementation without holding it.
+       */
+      class RunThread : public QThread
+      {
+         Q_OBJECT
+      public:
+         void execute(std::unique_ptr<EAbstractAnalyticBlock>&& block);
+         std::unique_ptr<EAbstractAnalyticBlock> result();
+         void stop();
+      signals:
+         /*!
+          * Signals this thread has finished processing its work block and contains a
+          * result block or exception.
+          */
+         void blockFinished();
+      protected:
+         explicit RunThread(QObject* parent = nullptr);
+         virtual void run() override final;
+         virtual void initialize();
+         /*!
+          * This interface processes the given work block into a result block on this
+          * object's separate thread. Any ACE exception thrown is handed back to the
+          * thread that gets the result.
+          *
+          * @param block The work block that is processed.
+          *
+          * @return The result block of the given work block.
+          */
+         virtual std::unique_ptr<EAbstractAnalyticBlock> execute(const EAbstractAnalyticBlock* block) = 0;
+      private:
+         /*!
+          * Mutex protecting the work block, result block, exception, and stop state of
+          * this thread.
+          */
+         QMutex _mutex;
+         /*!
+          * Wait condition this object's separate thread sleeps on until it is given a
+          * work block or asked to stop.
+          */
+         QWaitCondition _condition;
+         /*!
+          * True if this object's saved work block is waiting to be processed by the
+          * separate thread or false otherwise.
+          */
+         bool _pending {false};
+         /*!
+          * True if this object's separate thread has been asked to stop or false
+          * otherwise.
+          */
+         bool _stop {false};
+         /*!
+          * Pointer to saved work block, if any, passed along to the separate thread for
+          * processing.
+          */
+         EAbstractAnalyticBlock* _work {nullptr};
+         /*!
+          * Pointer to result block, if any, saved by this object's separate thread.
+          */
+         EAbstractAnalyticBlock* _result {nullptr};
+         /*!
+          * Pointer to any exception that occurs on this object's separate thread while
+          * processing a work block.
+          */
+         EException* _exception {nullptr};
+      };
+   }
+}
+
+#endif
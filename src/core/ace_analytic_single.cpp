@@ -2,6 +2,7 @@
 #include <QTimer>
 #include "ace_analytic_simplerun.h"
 #include "ace_analytic_serialrun.h"
+#include "ace_analytic_threadpoolrun.h"
 #include "ace_analytic_openclrun.h"
 #include "ace_analytic_cudarun.h"
 #include "ace_settings.h"
@@ -90,6 +91,15 @@ void Single::writeResult(std::unique_ptr<EAbstractAnalyticBlock>&& result)
    {
       emit done();
    }
+
+   // Else if there is more work to add then schedule this object's process slot to
+   // be called if it is not already, since writing this result made room in this
+   // manager's window of blocks in flight.
+   else if ( !_scheduled && _nextWork < analytic()->size() )
+   {
+      _scheduled = true;
+      QTimer::singleShot(0,this,&Single::process);
+   }
 }
 
 
@@ -116,7 +126,10 @@ void Single::start()
    setupSerial();
    connect(_runner,&AbstractRun::finished,this,&AbstractManager::finish);
 
-   // Initialize analytic processing by calling this object's process slot.
+   // Initialize the window of blocks in flight from this object's abstract run and
+   // initialize analytic processing by calling this object's process slot.
+   _window = _runner->windowSize();
+   _scheduled = true;
    QTimer::singleShot(0,this,&Single::process);
 }
 
@@ -126,17 +139,22 @@ void Single::start()
 
 
 /*!
- * Called to add all work, blocks or none if in simple mode, to this manager's
- * abstract run object.
+ * Called to add work, blocks or none if in simple mode, to this manager's
+ * abstract run object until this manager's window of blocks in flight is full.
+ * This is called again each time a result is written and there is more work to
+ * add, so the number of blocks that exist at once does not depend on the size
+ * of the analytic.
  */
 void Single::process()
 {
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   // While the next work index is less than the size of this object's analytic do
-   // the following steps.
-   while ( _nextWork < analytic()->size() )
+   // While the next work index is less than the size of this object's analytic and
+   // the number of blocks in flight is less than this manager's window do the
+   // following steps.
+   _scheduled = false;
+   while ( _nextWork < analytic()->size() && _nextWork - _nextResult < _window )
    {
       // If this object has a simple run object then add work with a null pointer, else
       // add work with the next work block generated from this object's analytic.
@@ -244,12 +262,21 @@ void Single::setupSerial()
    }
 
    // If this manager's analytic creates a valid abstract serial object then create a
-   // new serial run object and set it to this manager's abstract run object, else
-   // create a new simple run object and set it to this manager's abstract run
+   // new thread pool run object if more than one CPU thread is available or a new
+   // serial run object otherwise and set it to this manager's abstract run object,
+   // else create a new simple run object and set it to this manager's abstract run
    // object.
    if ( EAbstractAnalyticSerial* serial = analytic()->makeSerial() )
    {
-      _runner = new SerialRun(serial,this,this);
+      int size {ThreadPoolRun::size()};
+      if ( size > 1 )
+      {
+         _runner = new ThreadPoolRun(analytic(),serial,size,this,this);
+      }
+      else
+      {
+         _runner = new SerialRun(serial,this,this);
+      }
    }
    else
    {
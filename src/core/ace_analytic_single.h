@@ -25,9 +25,9 @@ namespace Ace
        * this program is being run normally with no MPI support or using multiple
        * chunk processes that cannot communicate. This manager will simply run through
        * all work blocks provided by the abstract analytic from beginning to end. This
-       * manager uses OpenCL run, or serial run if OpenCL is not available, or as a
-       * last resort simple run. This is the only manager type that can use the simple
-       * run type.
+       * manager uses OpenCL run, or thread pool or serial run if OpenCL is not
+       * available, or as a last resort simple run. This is the only manager type
+       * that can use the simple run type.
        */
       class Single : public AbstractManager, public AbstractInput
       {
@@ -63,6 +63,16 @@ namespace Ace
           * Next result block index to be processed to maintain order.
           */
          int _nextResult {0};
+         /*!
+          * The maximum number of blocks this manager keeps in flight, counting work
+          * blocks not yet executed and result blocks waiting to be written in order.
+          */
+         int _window {1};
+         /*!
+          * True if this manager's process slot has been scheduled to be called or false
+          * otherwise.
+          */
+         bool _scheduled {false};
       };
    }
 }
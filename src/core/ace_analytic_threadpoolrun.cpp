@@ -0,0 +1,226 @@
+#include "ace_analytic_threadpoolrun.h"
+#include "ace_analytic_threadpoolrunthread.h"
+#include "ace_analytic_abstractinput.h"
+#include "ace_settings.h"
+#include "eexception.h"
+#include "edebug.h"
+#include "eabstractanalyticblock.h"
+#include "eabstractanalyticserial.h"
+
+
+
+namespace Ace
+{
+namespace Analytic
+{
+
+
+
+
+
+
+/*!
+ * Returns the number of threads a thread pool run should use from the global
+ * CPU thread size setting. If the setting is automatic then the ideal thread
+ * count of this system is divided evenly between the given number of processes
+ * sharing it. The returned value is never less than one.
+ *
+ * @param share The number of processes on this system that share its CPU cores
+ *              and are expected to each run their own thread pool.
+ *
+ * @return Number of threads a thread pool run should use.
+ */
+int ThreadPoolRun::size(int share)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(share);
+
+   // Use the CPU thread size setting if it is set, else divide the ideal thread
+   // count between the given number of processes.
+   int ret {Settings::instance().cpuThreadSize()};
+   if ( ret < 1 )
+   {
+      ret = QThread::idealThreadCount()/qMax(share,1);
+   }
+   return qMax(ret,1);
+}
+
+
+
+
+
+
+/*!
+ * Implements the interface that is called to add a work block to be processed
+ * by this abstract run. This implementation adds the given work block to an
+ * idle thread for execution if there is one, else it is queued until a thread
+ * finishes. This never blocks.
+ *
+ * @param block The work block that is processed.
+ */
+void ThreadPoolRun::addWork(std::unique_ptr<EAbstractAnalyticBlock>&& block)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,block.get());
+
+   // If there is an idle thread then add the given work block to it for execution in
+   // its own thread, else add the work block to this object's queue of waiting work.
+   if ( !_idle.isEmpty() )
+   {
+      _idle.dequeue()->execute(std::move(block));
+   }
+   else
+   {
+      _work.enqueue(block.release());
+   }
+}
+
+
+
+
+
+
+/*!
+ * Implements the interface that returns the number of work blocks this abstract
+ * run can process at the same time. This implementation returns the number of
+ * threads it contains.
+ *
+ * @return Number of work blocks this abstract run processes at once.
+ */
+int ThreadPoolRun::capacity() const
+{
+   EDEBUG_FUNC(this);
+   return _threads.size();
+}
+
+
+
+
+
+
+/*!
+ * Constructs a new thread pool run object with the given analytic, abstract
+ * serial object, thread size, abstract input object, and optional parent. The
+ * given serial object is used by the first thread and a new serial object is
+ * made from the analytic for every other thread.
+ *
+ * @param analytic Pointer to the analytic used to make additional abstract
+ *                 serial objects.
+ *
+ * @param serial Pointer to the abstract serial object already made by the
+ *               analytic that is being ran.
+ *
+ * @param size The number of threads this new run object uses.
+ *
+ * @param base Pointer to the abstract input object used to save results.
+ *
+ * @param parent Optional parent for this new thread pool run.
+ */
+ThreadPoolRun::ThreadPoolRun(EAbstractAnalytic* analytic, EAbstractAnalyticSerial* serial, int size, AbstractInput* base, QObject* parent)
+   :
+   AbstractRun(parent),
+   _base(base),
+   _threads(qMax(size,1))
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,analytic,serial,size,base,parent);
+
+   // Iterate through the number of threads this run object contains, initializing
+   // each one with its own abstract serial object. Add all threads to the idle queue
+   // and connect their finished signal with this object's block finished slot using
+   // their index.
+   for (int i = 0; i < _threads.size() ;++i)
+   {
+      // Make a new abstract serial object for every thread besides the first. If the
+      // analytic fails making one then throw an exception.
+      EAbstractAnalyticSerial* threadSerial {serial};
+      if ( i > 0 )
+      {
+         threadSerial = analytic->makeSerial();
+         if ( !threadSerial )
+         {
+            E_MAKE_EXCEPTION(e);
+            e.setTitle(tr("Logic Error"));
+            e.setDetails(tr("Analytic returned null serial pointer."));
+            throw e;
+         }
+      }
+      ThreadPoolRunThread* thread {new ThreadPoolRunThread(threadSerial)};
+      _threads[i] = thread;
+      _idle << thread;
+      connect(thread
+              ,&ThreadPoolRunThread::blockFinished
+              ,this
+              ,[this,i]{ blockFinished(i); }
+              ,Qt::QueuedConnection);
+      thread->start();
+   }
+}
+
+
+
+
+
+
+/*!
+ * This stops and deletes all threads this thread pool run contains. The threads
+ * are not deleted until their thread has finished execution, blocking until
+ * that is the case.
+ */
+ThreadPoolRun::~ThreadPoolRun()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Iterate through all threads, for each one asking it to stop, waiting until it
+   // is no longer running, and then deleting it.
+   for (auto thread: _threads)
+   {
+      thread->stop();
+      thread->wait();
+      delete thread;
+   }
+
+   // Delete any work blocks still waiting in this object's queue.
+   qDeleteAll(_work);
+}
+
+
+
+
+
+
+/*!
+ * Called when one of this object's threads has finished execution and contains
+ * a result block.
+ *
+ * @param index The index of the thread that finished execution.
+ */
+void ThreadPoolRun::blockFinished(int index)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,index);
+
+   // Get the result block from the thread that finished execution, saving it to this
+   // object's abstract input. If there is queued work then give the next work block
+   // to the thread, else add the thread to this object's idle queue.
+   ThreadPoolRunThread* thread {_threads.at(index)};
+   _base->saveResult(thread->result());
+   if ( !_work.isEmpty() )
+   {
+      thread->execute(std::unique_ptr<EAbstractAnalyticBlock>(_work.dequeue()));
+   }
+   else
+   {
+      _idle.enqueue(thread);
+   }
+
+   // If this object's abstract input is finished then emit the finished signal.
+   if ( _base->isFinished() )
+   {
+      emit finished();
+   }
+}
+
+}
+}
@@ -0,0 +1,69 @@
+#ifndef ACE_ANALYTIC_THREADPOOLRUN_H
+#define ACE_ANALYTIC_THREADPOOLRUN_H
+#include <memory>
+#include <QVector>
+#include <QQueue>
+#include "ace_analytic_abstractrun.h"
+#include "ace_analytic.h"
+#include "eabstractanalytic.h"
+
+
+
+/*!
+ * This contains all private classes used internally by the ACE library and
+ * should never be accessed by a developer using this library.
+ */
+namespace Ace
+{
+   /*!
+    * This contains all classes related to running an analytic. This required its
+    * own name space because of the immense complexity required for ACE to provide
+    * an abstract interface for running analytic types in heterogeneous
+    * environments.
+    */
+   namespace Analytic
+   {
+      /*!
+       * This is a thread pool analytic run that processes the blocks of an analytic
+       * using the traditional CPU and host memory with multiple threads processing
+       * work blocks at once. Each thread is given its own abstract serial object made
+       * from the analytic so no serial object is ever shared between threads. Result
+       * blocks are saved on the thread this object lives in so the abstract input's
+       * hopper restores their order.
+       */
+      class ThreadPoolRun : public AbstractRun
+      {
+         Q_OBJECT
+      public:
+         static int size(int share = 1);
+      public:
+         virtual void addWork(std::unique_ptr<EAbstractAnalyticBlock>&& block) override final;
+         virtual int capacity() const override final;
+      public:
+         explicit ThreadPoolRun(EAbstractAnalytic* analytic, EAbstractAnalyticSerial* serial, int size, AbstractInput* base, QObject* parent = nullptr);
+         virtual ~ThreadPoolRun() override final;
+      private slots:
+         void blockFinished(int index);
+      private:
+         /*!
+          * Pointer to the abstract input object used to save results.
+          */
+         AbstractInput* _base;
+         /*!
+          * Pointer list to all threads this object contains for processing work blocks
+          * into result blocks.
+          */
+         QVector<ThreadPoolRunThread*> _threads;
+         /*!
+          * Queue of idle threads ready to execute another work block.
+          */
+         QQueue<ThreadPoolRunThread*> _idle;
+         /*!
+          * Queue of work blocks waiting for an idle thread.
+          */
+         QQueue<EAbstractAnalyticBlock*> _work;
+      };
+   }
+}
+
+#endif
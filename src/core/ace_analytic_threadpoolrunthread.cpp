@@ -0,0 +1,57 @@
+#include "ace_analytic_threadpoolrunthread.h"
+#include "edebug.h"
+#include "eabstractanalyticblock.h"
+#include "eabstractanalyticserial.h"
+
+
+
+namespace Ace
+{
+namespace Analytic
+{
+
+
+
+
+
+
+/*!
+ * Constructs a new thread object with the given abstract serial object and
+ * optional parent.
+ *
+ * @param serial An abstract serial object used to do the actual processing of
+ *               work blocks into result blocks. This must not be used by any
+ *               other thread.
+ *
+ * @param parent Optional parent of this new thread object.
+ */
+ThreadPoolRunThread::ThreadPoolRunThread(EAbstractAnalyticSerial* serial, QObject* parent)
+   :
+   RunThread(parent),
+   _serial(serial)
+{
+   EDEBUG_FUNC(this,serial,parent);
+}
+
+
+
+
+
+
+/*!
+ * Implements the interface that processes the given work block into a result
+ * block on this object's separate thread, using this object's abstract serial
+ * object.
+ *
+ * @param block The work block that is processed.
+ *
+ * @return The result block of the given work block.
+ */
+std::unique_ptr<EAbstractAnalyticBlock> ThreadPoolRunThread::execute(const EAbstractAnalyticBlock* block)
+{
+   EDEBUG_FUNC(this,block);
+   return _serial->execute(block);
+}
+
+}
+}
@@ -0,0 +1,46 @@
+#ifndef ACE_ANALYTIC_THREADPOOLRUNTHREAD_H
+#define ACE_ANALYTIC_THREADPOOLRUNTHREAD_H
+#include "ace_analytic_runthread.h"
+#include "ace_analytic_threadpoolrun.h"
+#include "global.h"
+
+
+
+/*!
+ * This contains all private classes used internally by the ACE library and
+ * should never be accessed by a developer using this library.
+ */
+namespace Ace
+{
+   /*!
+    * This contains all classes related to running an analytic. This required its
+    * own name space because of the immense complexity required for ACE to provide
+    * an abstract interface for running analytic types in heterogeneous
+    * environments.
+    */
+   namespace Analytic
+   {
+      /*!
+       * This is a single thread of execution used by the thread pool run class to
+       * process work blocks into result blocks. An abstract serial object owned by
+       * this thread alone is used for the actual processing.
+       */
+      class ThreadPoolRunThread : public RunThread
+      {
+         Q_OBJECT
+      public:
+         explicit ThreadPoolRunThread(EAbstractAnalyticSerial* serial, QObject* parent = nullptr);
+         using RunThread::execute;
+      protected:
+         virtual std::unique_ptr<EAbstractAnalyticBlock> execute(const EAbstractAnalyticBlock* block) override final;
+      private:
+         /*!
+          * Pointer to the abstract serial object used to process work blocks into result
+          * blocks. This is only ever used by this object's separate thread.
+          */
+         EAbstractAnalyticSerial* _serial;
+      };
+   }
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "ace_dataobject.h"
+#include <cstring>
 #include "ace_datamanager.h"
 #include "eabstractdata.h"
 #include "edatastream.h"
@@ -34,15 +35,17 @@ DataObject::DataObject(const QString& path, QObject* parent)
    // Add the debug header.
    EDEBUG_FUNC(this,path,parent);
 
-   // Open the data object file, read in the header data, and call the read data
-   // interface of this object's abstract data object.
+   // Open the data object file, read in the header data, call the read data
+   // interface of this object's abstract data object, and then memory map its data
+   // section if possible.
    try
    {
       openObject(false);
       readHeader();
       _data->readData();
+      map();
       seek(_data->dataEnd());
-      stream() >> _userMeta;
+      readMeta(_userMeta);
       seek(0);
    }
 
@@ -180,6 +183,41 @@ quint16 DataObject::type() const
 
 
 
+/*!
+ * Returns the format version of this data object's file. Version 0 is the
+ * legacy format.
+ *
+ * @return Format version of this data object.
+ */
+quint8 DataObject::version() const
+{
+   EDEBUG_FUNC(this);
+   return _version;
+}
+
+
+
+
+
+
+/*!
+ * Returns the byte order of this data object's data and user metadata. Legacy
+ * data objects are big endian, though their floating point values are stored
+ * in the byte order of the machine that wrote them.
+ *
+ * @return Byte order of this data object.
+ */
+QSysInfo::Endian DataObject::byteOrder() const
+{
+   EDEBUG_FUNC(this);
+   return _byteOrder;
+}
+
+
+
+
+
+
 /*!
  * Returns the current size of this data object in bytes. This does not include
  * the hidden header portion of the file of this data object.
@@ -255,6 +293,14 @@ void DataObject::seek(qint64 index) const
       throw e;
    }
 
+   // If this data object is memory mapped then simply set its cursor position since
+   // the file is only seeked when reading outside of the mapping.
+   if ( _map )
+   {
+      _cursor = index;
+      return;
+   }
+
    // Call the qt file device seek function using the given index in addition to this
    // data object's header offset. If the seek call fails then throw an exception.
    if ( !_file->seek(index + _headerOffset) )
@@ -271,6 +317,72 @@ void DataObject::seek(qint64 index) const
 
 
 
+/*!
+ * Tests if this data object's data section is memory mapped.
+ *
+ * @return True if this data object is memory mapped or false otherwise.
+ */
+bool DataObject::isMapped() const
+{
+   EDEBUG_FUNC(this);
+   return _map != nullptr;
+}
+
+
+
+
+
+
+/*!
+ * Returns a read only pointer to the given region of this data object's memory
+ * mapped data section. The region must lie entirely within the data section,
+ * which ends at the data end of this object's abstract data. If this data
+ * object is not memory mapped or the given region is out of range then an
+ * exception is thrown. The returned pointer is valid as long as this data
+ * object exists.
+ *
+ * @param index The index of the first byte of the region, not including the
+ *              header of this data object.
+ *
+ * @param size The size in bytes of the region.
+ *
+ * @return Read only pointer to the given region of the mapped data section.
+ */
+const char* DataObject::span(qint64 index, qint64 size) const
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,index,size);
+
+   // If this data object is not memory mapped then throw an exception, else go to the
+   // next step.
+   if ( !_map )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Logical Error"));
+      e.setDetails(tr("Cannot get span of data object file that is not memory mapped."));
+      throw e;
+   }
+
+   // If the given region is not within the mapped data section then throw an
+   // exception, else return a pointer to it.
+   if ( index < 0 || size < 0 || index + size > _mapSize )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Invalid Argument"));
+      e.setDetails(tr("Span (%1,%2) is outside of mapped data section of size %3.")
+                   .arg(index)
+                   .arg(size)
+                   .arg(_mapSize));
+      throw e;
+   }
+   return reinterpret_cast<const char*>(_map + index);
+}
+
+
+
+
+
+
 /*!
  * Returns a read only reference to the data stream for this data object.
  *
@@ -406,7 +518,7 @@ void DataObject::finalize()
 
    // Write the user metadata to the end of this new data object file.
    seek(_data->dataEnd());
-   stream() << _userMeta;
+   writeMeta(_userMeta);
 }
 
 
@@ -440,6 +552,28 @@ void DataObject::read(char* data, qint64 size) const
       throw e;
    }
 
+   // If this data object is memory mapped then copy the given number of bytes
+   // directly from the mapping if they are within it, else seek the file to this
+   // object's cursor position and fall through to reading the file. Advance the
+   // cursor position either way.
+   if ( _map )
+   {
+      qint64 index {_cursor};
+      _cursor += size;
+      if ( index + size <= _mapSize )
+      {
+         memcpy(data,_map + index,static_cast<size_t>(size));
+         return;
+      }
+      if ( !_file->seek(index + _headerOffset) )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("System Error"));
+         e.setDetails(tr("Failed seeking in data object file: %1").arg(_file->errorString()));
+         throw e;
+      }
+   }
+
    // Read the given number of bytes from this data object at the current cursor
    // position to the given character array. If reading failed then throw an
    // exception.
@@ -582,14 +716,33 @@ void DataObject::readHeader()
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   // Read in this data object's special value, type, name, extension, and system
-   // metadata of this data object's file. If the special value is incorrect then
-   // throw an exception, else go to the next step.
+   // Read in this data object's special value. If it is the versioned special value
+   // then read in the format version and byte order that follow it, else if it is
+   // the legacy special value then this uses the legacy format, else throw an
+   // exception.
    qint64 value;
-   QString name;
-   QString extension;
-   stream() >> value >> _type >> name >> extension >> _system;
-   if ( value != _specialValue )
+   stream() >> value;
+   if ( value == _versionedValue )
+   {
+      quint8 order;
+      stream() >> _version >> order;
+      if ( _version > _formatVersion || _version == 0 )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("Read Error"));
+         e.setDetails(tr("Failed reading in file %1: unsupported data object format version %2.")
+                      .arg(_rawPath)
+                      .arg(_version));
+         throw e;
+      }
+      _byteOrder = order ? QSysInfo::LittleEndian : QSysInfo::BigEndian;
+   }
+   else if ( value == _specialValue )
+   {
+      _version = 0;
+      _byteOrder = QSysInfo::BigEndian;
+   }
+   else
    {
       E_MAKE_EXCEPTION(e);
       e.setTitle(tr("Read Error"));
@@ -597,14 +750,25 @@ void DataObject::readHeader()
       throw e;
    }
 
+   // Read in this data object's type, name, extension, and system metadata.
+   QString name;
+   QString extension;
+   stream() >> _type >> name >> extension;
+   readMeta(_system);
+
    // Create a new abstract data object for this data object and set this data
    // object's header offset to the current cursor position of this data object's
    // file.
    makeData(name,extension);
    _headerOffset = _file->pos();
 
-   // Set this data object's header as read.
+   // Set this data object's header as read and, if this is not a legacy data object,
+   // set the byte order of its data stream for everything after the header.
    _headerRead = true;
+   if ( _version > 0 )
+   {
+      _stream->setByteOrder(_byteOrder);
+   }
 }
 
 
@@ -648,19 +812,119 @@ void DataObject::writeHeader()
       throw e;
    }
 
-   // Write out this data object's special value, type, name, extension, and system
-   // metadata to this data object's file.
-   stream() << _specialValue
+   // Write out this data object's versioned special value, format version, byte
+   // order, type, name, extension, and system metadata to this data object's file.
+   stream() << _versionedValue
+            << _formatVersion
+            << static_cast<quint8>(_byteOrder == QSysInfo::LittleEndian)
             << _type << factory.name(_type)
-            << factory.fileExtension(_type)
-            << _system;
+            << factory.fileExtension(_type);
+   writeMeta(_system);
 
    // Set this data object's header offset to the current cursor position of this
    // data object's file.
    _headerOffset = _file->pos();
 
-   // Set this data object's header as read and its user metadata as not written.
+   // Set this data object's header as read and the byte order of its data stream for
+   // everything after the header.
    _headerRead = true;
+   _stream->setByteOrder(_byteOrder);
+}
+
+
+
+
+
+
+/*!
+ * Memory maps the data section of this existing data object's file, which ends
+ * at the data end of this object's abstract data. If the data section is empty
+ * or the system fails mapping it then this object is left unmapped and all
+ * reading is done through its file.
+ */
+void DataObject::map()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // If the data section is empty or extends past the end of the file then do
+   // nothing and exit, else go to the next step.
+   qint64 size {_data->dataEnd()};
+   if ( size <= 0 || _headerOffset + size > _file->size() )
+   {
+      return;
+   }
+
+   // Map the data section of this object's file. If mapping was successful then set
+   // the cursor position to this object's current file position.
+   _map = _file->map(_headerOffset,size);
+   if ( _map )
+   {
+      _mapSize = size;
+      _cursor = _file->pos() - _headerOffset;
+   }
+}
+
+
+
+
+
+
+/*!
+ * Reads in metadata from this data object at its current cursor position. If
+ * this data object's format version stores metadata in the compact encoding
+ * then it is read in as a single byte array and only its top level is decoded,
+ * else it is read in as tagged values.
+ *
+ * @param meta The metadata object that is overwritten with the metadata read
+ *             from this data object.
+ */
+void DataObject::readMeta(EMetadata& meta) const
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,&meta);
+
+   // Read in the encoded metadata and decode it if this data object uses the compact
+   // encoding, else read it in as tagged values.
+   if ( _version >= _encodedMetaVersion )
+   {
+      QByteArray bytes;
+      stream() >> bytes;
+      meta = EMetadata::decode(bytes);
+   }
+   else
+   {
+      stream() >> meta;
+   }
+}
+
+
+
+
+
+
+/*!
+ * Writes out the given metadata to this data object at its current cursor
+ * position, using the compact encoding if this data object's format version
+ * stores metadata that way or else as tagged values.
+ *
+ * @param meta The metadata that is written to this data object.
+ */
+void DataObject::writeMeta(const EMetadata& meta)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,&meta);
+
+   // Write out the metadata encoded if this data object uses the compact encoding,
+   // else write it out as tagged values.
+   if ( _version >= _encodedMetaVersion )
+   {
+      stream() << meta.encode();
+   }
+   else
+   {
+      stream() << meta;
+   }
 }
 
 
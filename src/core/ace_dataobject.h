@@ -21,6 +21,22 @@ namespace Ace
     * such as seeking and reading functions are declared constant. This is because
     * ACE is made towards big data where it is impossible to just read an entire
     * file into system memory.
+    *
+    * An existing data object opened for reading has its data section memory mapped
+    * if the system allows it. All reads within the data section are then copied
+    * directly from the mapping instead of the file, and read only spans of the
+    * data section can be accessed without any copying at all.
+    *
+    * The header of a data object records its format version and the byte order
+    * of its data and user metadata. New data objects are always little endian,
+    * storing their values as raw memory on little endian machines. Data objects
+    * written before the format version was added are read with the legacy big
+    * endian format.
+    *
+    * Starting with format version 2 the system and user metadata are stored in
+    * the compact metadata encoding, so opening a data object only decodes the
+    * top level of its metadata and each array or object within it is decoded the
+    * first time it is accessed.
     */
    class DataObject : public QObject
    {
@@ -33,10 +49,14 @@ namespace Ace
       QString path() const;
       QString fileName() const;
       quint16 type() const;
+      quint8 version() const;
+      QSysInfo::Endian byteOrder() const;
       qint64 size() const;
       const EMetadata& systemMeta() const;
       const EMetadata& userMeta() const;
       void seek(qint64 index) const;
+      bool isMapped() const;
+      const char* span(qint64 index, qint64 size) const;
       const EDataStream& stream() const;
       void allocate(qint64 size);
       EDataStream& stream();
@@ -60,10 +80,30 @@ namespace Ace
        * identify it as an ACE data object file.
        */
       constexpr static qint64 _specialValue {584};
+      /*!
+       * A special value that is written to the beginning of all data object files
+       * that record their format version and byte order, which directly follow it.
+       */
+      constexpr static qint64 _versionedValue {585};
+      /*!
+       * The format version written to all new data object files. Version 0 is the
+       * legacy format that has no version recorded in its header. Version 1 stores
+       * metadata as tagged values and version 2 stores it in the compact metadata
+       * encoding.
+       */
+      constexpr static quint8 _formatVersion {2};
+      /*!
+       * The first format version that stores metadata in the compact metadata
+       * encoding.
+       */
+      constexpr static quint8 _encodedMetaVersion {2};
    private:
       void openObject(bool overwrite);
       void readHeader();
       void writeHeader();
+      void map();
+      void readMeta(EMetadata& meta) const;
+      void writeMeta(const EMetadata& meta);
       void makeData(const QString& name, const QString& extension);
    private:
       /*!
@@ -74,6 +114,14 @@ namespace Ace
        * The data object type for this data object.
        */
       quint16 _type;
+      /*!
+       * The format version of this data object's file.
+       */
+      quint8 _version {_formatVersion};
+      /*!
+       * The byte order of this data object's data and user metadata.
+       */
+      QSysInfo::Endian _byteOrder {QSysInfo::LittleEndian};
       /*!
        * The absolute canonical path for this data object's file.
        */
@@ -116,6 +164,20 @@ namespace Ace
        * The user metadata for this data object.
        */
       EMetadata _userMeta {EMetadata::Object};
+      /*!
+       * Pointer to the memory mapping of this data object's data section or null if
+       * it is not mapped.
+       */
+      uchar* _map {nullptr};
+      /*!
+       * The size in bytes of this data object's memory mapped data section.
+       */
+      qint64 _mapSize {0};
+      /*!
+       * The cursor position of this data object, not including the header, used
+       * instead of the file's position if this data object is memory mapped.
+       */
+      mutable qint64 _cursor {0};
    };
 }
 
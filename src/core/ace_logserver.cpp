@@ -2,6 +2,7 @@
 #include <QHostInfo>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QElapsedTimer>
 #include "eexception.h"
 #include "ace_qmpi.h"
 #include "ace_settings.h"
@@ -95,7 +96,25 @@ void LogServer::wait()
 
 
 /*!
- * Writes out the given message to all connected clients.
+ * Blocks execution until all messages broadcast before this call have been
+ * written to all connected clients, giving up after a few seconds if a client
+ * is not keeping up. This should be called before the application exits so
+ * its last messages are not lost.
+ */
+void LogServer::flush()
+{
+   _server->flush();
+}
+
+
+
+
+
+
+/*!
+ * Writes out the given message to all connected clients. This only queues the
+ * message for this server's internal thread and never blocks. If the queue is
+ * full then the message is dropped.
  *
  * @param type The message type being broadcast to all clients.
  *
@@ -114,18 +133,10 @@ LogServer& LogServer::broadcast(Type type, int thread, const QByteArray& data)
       return *this;
    }
 
-   // Construct the message that will be broadcast to all connected clients.
-   QByteArray message;
-   QDataStream stream(&message,QIODevice::WriteOnly);
-   stream << static_cast<qint8>(type)
-          << static_cast<qint32>(thread)
-          << static_cast<qint32>(data.size());
-   stream.writeRawData(data.data(),data.size());
-
    // Pass the broadcast message to this server's internal low level TCP server which
    // in turn broadcasts it to all connected clients, returning a reference to this
    // object.
-   _server->broadcast(message);
+   _server->broadcast(packet(type,thread,data));
    return *this;
 }
 
@@ -134,6 +145,35 @@ LogServer& LogServer::broadcast(Type type, int thread, const QByteArray& data)
 
 
 
+/*!
+ * Constructs the packet of a message that is written to clients, made of its
+ * type, thread ID, and size followed by its data.
+ *
+ * @param type The message type.
+ *
+ * @param thread The thread ID where the message is coming from.
+ *
+ * @param data The data of the message.
+ *
+ * @return Packet of the given message.
+ */
+QByteArray LogServer::packet(Type type, int thread, const QByteArray& data)
+{
+   // Construct and return the packet of the given message.
+   QByteArray ret;
+   QDataStream stream(&ret,QIODevice::WriteOnly);
+   stream << static_cast<qint8>(type)
+          << static_cast<qint32>(thread)
+          << static_cast<qint32>(data.size());
+   stream.writeRawData(data.data(),data.size());
+   return ret;
+}
+
+
+
+
+
+
 /*!
  * Constructs a new thread instance with the given listening port and optional
  * parent. This does NOT start the TCP server.
@@ -148,6 +188,12 @@ LogServer::Thread::Thread(int port, QObject* parent)
    QThread(parent),
    _port(port)
 {
+   // Set the sequence of every slot of the ring buffer to its index, marking it as
+   // free for the first lap.
+   for (quint32 i = 0; i < _capacity ;++i)
+   {
+      _slots[i].sequence.store(i);
+   }
 }
 
 
@@ -170,27 +216,76 @@ void LogServer::Thread::wait()
 
 
 /*!
- * Writes out the given message to all connected clients on this thread's
- * internal TCP server.
- *
- * @param data Any optional data that is appended to the message.
+ * Blocks execution of the calling thread until all messages added to the ring
+ * buffer before this call have been written to all connected clients or the
+ * flush timeout has passed. If this thread is not running then this does
+ * nothing.
  */
-void LogServer::Thread::broadcast(const QByteArray& data)
+void LogServer::Thread::flush()
 {
-   // Lock this thread's mutex.
-   _lock.lock();
+   // If this thread is not running then return because nothing will be written.
+   if ( !isRunning() )
+   {
+      return;
+   }
+
+   // Sleep until this thread has written every message up to the current position of
+   // the ring buffer or the timeout has passed.
+   quint32 target {_enqueue.load()};
+   QElapsedTimer timer;
+   timer.start();
+   while ( static_cast<qint32>(_written.loadAcquire() - target) < 0
+           && timer.elapsed() < _flushTimeout )
+   {
+      msleep(1);
+   }
+}
 
-   // Set this thread's data pointer to the given byte array and increment the switch
-   // atomic integer, signaling that data is ready to be broadcast.
-   _data = &data;
-   ++_switch;
 
-   // Wait until the switch has been lowered, signaling the data was broadcast to all
-   // clients.
-   while ( _switch == 1 );
 
-   // Unlock this thread's mutex.
-   _lock.unlock();
+
+
+
+/*!
+ * Adds the given message to the ring buffer to be written to all connected
+ * clients by this object's separate thread. This is lock free and never
+ * blocks. If the ring buffer is full then the message is dropped and counted.
+ *
+ * @param data The message packet that is taken and added to the ring buffer.
+ */
+void LogServer::Thread::broadcast(QByteArray&& data)
+{
+   // Claim the next position of the ring buffer. If the slot at that position still
+   // holds a message from the last lap then the ring buffer is full so count the
+   // message as dropped and return, else if another thread claimed the position first
+   // then try again with the next one.
+   quint32 position {_enqueue.load()};
+   Slot* slot;
+   while ( true )
+   {
+      slot = &_slots[position & (_capacity - 1)];
+      qint32 difference {static_cast<qint32>(slot->sequence.loadAcquire() - position)};
+      if ( difference == 0 )
+      {
+         if ( _enqueue.testAndSetRelaxed(position,position + 1,position) )
+         {
+            break;
+         }
+      }
+      else if ( difference < 0 )
+      {
+         ++_dropped;
+         return;
+      }
+      else
+      {
+         position = _enqueue.load();
+      }
+   }
+
+   // Move the message into the claimed slot and mark it as ready to be taken.
+   slot->data = std::move(data);
+   slot->sequence.storeRelease(position + 1);
 }
 
 
@@ -215,8 +310,10 @@ void LogServer::Thread::run()
       return;
    }
 
-   // Initialize the list of connected clients.
+   // Initialize the list of connected clients and the batch of messages written to
+   // them.
    QVector<QTcpSocket*> clients;
+   QByteArray batch;
 
    // Begin the infinite loop that processing all TCP events.
    while (true)
@@ -258,27 +355,47 @@ void LogServer::Thread::run()
          }
       }
 
-      // Check to see if a data packet is waiting to be broadcast.
-      if ( _switch == 1 )
+      // Take all messages waiting in the ring buffer as a single batch. If any messages
+      // were dropped since the last batch then add a message reporting it.
+      int size {drain(batch)};
+      int dropped {_dropped.fetchAndStoreRelaxed(0)};
+      if ( dropped > 0 )
       {
-         // Iterate through all connected clients.
-         for (auto client: clients)
+         batch += packet(Log,-1,tr("%1 log messages were dropped because the log server fell behind.")
+                                .arg(dropped)
+                                .toUtf8());
+      }
+
+      // Write the batch to every client, dropping it for any client that is too far
+      // behind. Then write as much as possible to every client without blocking and, if
+      // nothing is left waiting, mark every message taken as written.
+      bool done {true};
+      for (auto client: qAsConst(clients))
+      {
+         if ( !batch.isEmpty() )
          {
-            // Send the data message to the client, waiting until they send a confirmation
-            // back.
-            client->write(*_data);
-            client->waitForReadyRead(-1);
-            client->read(client->bytesAvailable());
+            if ( client->bytesToWrite() > _clientBufferSize )
+            {
+               _dropped += size;
+            }
+            else
+            {
+               client->write(batch);
+            }
          }
-
-         // Decrement the switch signaling the data packet has been broadcast.
-         --_switch;
+         client->flush();
+         done = done && client->bytesToWrite() == 0;
+      }
+      batch.clear();
+      if ( done )
+      {
+         _written.storeRelease(_dequeue);
       }
 
-      // Sleep for a very short amount of time, check to see if a data packet is
-      // waiting, and sleep a much longer period of time if none is waiting.
+      // Sleep for a very short amount of time and sleep a much longer period of time if
+      // no messages were waiting.
       usleep(10);
-      if ( _switch == 0 )
+      if ( size == 0 )
       {
          msleep(10);
       }
@@ -290,6 +407,41 @@ void LogServer::Thread::run()
 
 
 
+/*!
+ * Takes all messages that are ready in the ring buffer, appending them to the
+ * given batch in order and freeing their slots for the next lap. This must only
+ * be called by this object's separate thread.
+ *
+ * @param batch The batch the taken messages are appended to.
+ *
+ * @return The number of messages taken.
+ */
+int LogServer::Thread::drain(QByteArray& batch)
+{
+   // Take messages from the ring buffer in order until the next slot does not hold a
+   // ready message, marking each slot free for the next lap once it is taken.
+   int ret {0};
+   while ( true )
+   {
+      Slot& slot {_slots[_dequeue & (_capacity - 1)]};
+      if ( static_cast<qint32>(slot.sequence.loadAcquire() - (_dequeue + 1)) < 0 )
+      {
+         break;
+      }
+      batch += slot.data;
+      slot.data.clear();
+      slot.sequence.storeRelease(_dequeue + _capacity);
+      ++_dequeue;
+      ++ret;
+   }
+   return ret;
+}
+
+
+
+
+
+
 /*!
  * Creates a new log server instance with the given port number.
  *
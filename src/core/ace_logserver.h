@@ -1,7 +1,8 @@
 #ifndef ACE_LOGSERVER_H
 #define ACE_LOGSERVER_H
 #include <QThread>
-#include <QMutex>
+#include <QAtomicInteger>
+#include <QByteArray>
 
 
 
@@ -16,9 +17,10 @@ namespace Ace
     * to all connected logging clients. This is a very low level class and only
     * outputs byte arrays. This class is thread safe, using an internal thread and
     * runs all TCP operations exclusively inside its own thread. This class acts as
-    * a TCP server, relaying all byte arrays streamed to it. This also provides
-    * static functions for initializing the log server and then accessing its
-    * instance.
+    * a TCP server, relaying all byte arrays streamed to it. Broadcasting a message
+    * only queues it for the internal thread and never waits on the network. This
+    * also provides static functions for initializing the log server and then
+    * accessing its instance.
     */
    class LogServer : public QObject
    {
@@ -44,24 +46,63 @@ namespace Ace
       static QString host();
    public:
       void wait();
+      void flush();
       LogServer& broadcast(Type type, int thread, const QByteArray& data);
    private:
+      static QByteArray packet(Type type, int thread, const QByteArray& data);
       /*!
        * This is the internal TCP server that is used by the log server. This is a qt
        * thread that runs a TCP server inside its own thread since a Qt server and its
-       * sockets must all run on the same thread. To communicate with this thread a
-       * mutex and atomic integer switches are used. WARNING: the TCP server is not
-       * initialized and started until the thread is started.
+       * sockets must all run on the same thread. Messages are passed to this thread
+       * through a bounded lock free ring buffer that any number of threads can add to
+       * without ever blocking. This thread drains the ring buffer, writing all messages
+       * it takes as a single batch to each connected client. If the ring buffer is
+       * full then new messages are dropped and counted, this thread reporting the
+       * number dropped to all clients. A client that falls too far behind has batches
+       * dropped in the same way. WARNING: the TCP server is not initialized and started
+       * until the thread is started.
        */
       class Thread : public QThread
       {
       public:
          Thread(int port, QObject* parent = nullptr);
          void wait();
-         void broadcast(const QByteArray& data);
+         void flush();
+         void broadcast(QByteArray&& data);
       protected:
          virtual void run() override final;
       private:
+         int drain(QByteArray& batch);
+         /*!
+          * A single slot of the ring buffer.
+          */
+         struct Slot
+         {
+            /*!
+             * The sequence number of this slot, which tells producers and the consumer
+             * whether this slot is free for the next lap of the ring buffer or holds a
+             * message ready to be taken.
+             */
+            QAtomicInteger<quint32> sequence;
+            /*!
+             * The message this slot holds.
+             */
+            QByteArray data;
+         };
+         /*!
+          * The number of slots in the ring buffer, which must be a power of 2.
+          */
+         constexpr static quint32 _capacity {65536};
+         /*!
+          * The maximum number of bytes waiting to be written to a single client before
+          * any new batches for it are dropped.
+          */
+         constexpr static qint64 _clientBufferSize {64*1024*1024};
+         /*!
+          * The time in milliseconds the flush method waits for all messages to be
+          * written before giving up.
+          */
+         constexpr static int _flushTimeout {5000};
          /*!
           * The port number this thread's internal TCP server listens for new
           * connections.
@@ -72,19 +113,26 @@ namespace Ace
           */
          QAtomicInteger<int> _ready {0};
          /*!
-          * Lock mutex used for only allowing one thread at a time broadcast a message.
+          * The slots of the ring buffer.
+          */
+         Slot _slots[_capacity];
+         /*!
+          * The position of the next slot producers add a message to.
+          */
+         QAtomicInteger<quint32> _enqueue {0};
+         /*!
+          * The position of the next slot this thread takes a message from. This is only
+          * used by this object's separate thread.
           */
-         QMutex _lock;
+         quint32 _dequeue {0};
          /*!
-          * Switch used to signal that a data packet is ready to be broadcast at 1 and
-          * switched back to 0 when it has been broadcast.
+          * The position up to which all messages have been written to every client.
           */
-         QAtomicInteger<int> _switch {0};
+         QAtomicInteger<quint32> _written {0};
          /*!
-          * Pointer to data message packet that will be broadcast once the switch atomic
-          * integer is incremented.
+          * The number of messages dropped since this thread last reported it.
           */
-         const QByteArray* _data;
+         QAtomicInteger<int> _dropped {0};
       };
    private:
       /*!
@@ -1,4 +1,7 @@
 #include "ace_qmpi.h"
+#include <cstring>
+#include <new>
+#include <QtEndian>
 #include "eexception.h"
 #include "edebug.h"
 
@@ -169,6 +172,43 @@ int QMPI::localRank() const
 
 
 
+/*!
+ * Returns the world rank of the node with local rank 0 on the same system as
+ * the node with the given world rank.
+ *
+ * @param rank The world rank of the node whose local leader is returned.
+ *
+ * @return World rank of the local leader of the given node.
+ */
+int QMPI::leader(int rank) const
+{
+   EDEBUG_FUNC(this,rank);
+   return _leaders.at(rank);
+}
+
+
+
+
+
+
+/*!
+ * Returns the world rank of the node with the given local rank.
+ *
+ * @param localRank The local rank of the node whose world rank is returned.
+ *
+ * @return World rank of the given local node.
+ */
+int QMPI::worldRank(int localRank) const
+{
+   EDEBUG_FUNC(this,localRank);
+   return _worldRanks.at(localRank);
+}
+
+
+
+
+
+
 /*!
  * Enables listening to incoming MPI messages and emitting signals when they are
  * received.
@@ -176,7 +216,7 @@ int QMPI::localRank() const
 void QMPI::start()
 {
    EDEBUG_FUNC(this);
-   _ignore = false;
+   _ignore.storeRelease(0);
 }
 
 
@@ -191,7 +231,7 @@ void QMPI::start()
 void QMPI::stop()
 {
    EDEBUG_FUNC(this);
-   _ignore = true;
+   _ignore.storeRelease(1);
 }
 
 
@@ -209,8 +249,20 @@ void QMPI::stop()
  */
 void QMPI::sendData(int toRank, const QByteArray& data)
 {
+   // Add the debug header.
    EDEBUG_FUNC(this,toRank,data);
-   sendData(MPI_COMM_WORLD,toRank,data);
+
+   // If there is a progress thread then queue the given data for it to send, else
+   // post the data now.
+   Message message {data,toRank,false,false};
+   if ( _thread )
+   {
+      _sends.push(std::move(message));
+   }
+   else
+   {
+      post(std::move(message));
+   }
 }
 
 
@@ -228,8 +280,20 @@ void QMPI::sendData(int toRank, const QByteArray& data)
  */
 void QMPI::sendLocalData(int toRank, const QByteArray& data)
 {
+   // Add the debug header.
    EDEBUG_FUNC(this,toRank,data);
-   sendData(_local,toRank,data);
+
+   // If there is a progress thread then queue the given data for it to send, else
+   // post the data now.
+   Message message {data,toRank,true,false};
+   if ( _thread )
+   {
+      _sends.push(std::move(message));
+   }
+   else
+   {
+      post(std::move(message));
+   }
 }
 
 
@@ -239,25 +303,67 @@ void QMPI::sendLocalData(int toRank, const QByteArray& data)
 
 /*!
  * Implements the QObject interface that is called whenever the timer event is
- * fired. This function is used to poll for new data from the MPI system without
- * blocking and firing signals for any new data received.
+ * fired. This function is only used if there is no progress thread, polling for
+ * new data from the MPI system without blocking and firing signals for any new
+ * data received.
  *
  * @param event Ignored Qt event data since this class only has a single timer
  *              event active.
  */
 void QMPI::timerEvent(QTimerEvent* event)
 {
-   if ( _ignore ) return;
-   // Iterate through all ranks, probing for new data received from the world and
-   // local MPI comm channels for each rank.
+   // Make progress until there is no more activity and then signal all received
+   // data.
    Q_UNUSED(event)
-   for (int i = 0; i < _size ;++i)
+   while ( progress() );
+   deliver();
+}
+
+
+
+
+
+
+/*!
+ * Emits a data received or local data received signal for all data in the
+ * received queue. If the progress thread saved an exception then it is thrown
+ * on this object's thread instead.
+ */
+void QMPI::deliver()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // If the progress thread saved an exception then copy it and throw it on this
+   // thread, else go to the next step.
    {
-      probe(MPI_COMM_WORLD,i);
+      QMutexLocker locker(&_mutex);
+      if ( _exception )
+      {
+         EException e(*_exception);
+         delete _exception;
+         _exception = nullptr;
+         throw e;
+      }
    }
-   for (int i = 0; i < _localSize ;++i)
+
+   // Clear the delivering switch before emptying the received queue so any data
+   // received after this point queues another call.
+   _delivering.storeRelease(0);
+
+   // Pop all data from the received queue, emitting a local data received or data
+   // received signal for each one depending on the comm it was received from.
+   Message message;
+   while ( _received.pop(message) )
    {
-      probe(_local,i);
+      if ( message.local )
+      {
+         emit localDataReceived(message.data,message.rank);
+      }
+      else
+      {
+         emit dataReceived(message.data,message.rank);
+      }
    }
 }
 
@@ -274,23 +380,41 @@ QMPI::QMPI()
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   // Initialize the MPI system. If it failed then set this object to a single
-   // process state and exit, else go to the next step.
-   if ( MPI_Init(nullptr,nullptr) )
+   // Initialize the MPI system, asking for support of MPI calls from one thread at
+   // a time. If it failed then set this object to a single process state and exit,
+   // else go to the next step.
+   int provided;
+   if ( MPI_Init_thread(nullptr,nullptr,MPI_THREAD_SERIALIZED,&provided) )
    {
       _failed = true;
       _size = 1;
       _rank = 0;
       _localSize = 1;
       _localRank = 0;
+      _leaders.fill(0,1);
+      _worldRanks.fill(0,1);
+      _localRanks.fill(0,1);
       return;
    }
 
-   // Setup the world and local MPI comm channels and then start this object's qt
-   // object timer for data received polling.
+   // Setup the world and local MPI comm channels and the shared memory window. If
+   // the MPI system supports calls from a thread other than the one that initialized
+   // it then start the progress thread, else start this object's qt object timer for
+   // data received polling.
    setupWorld();
    setupLocal();
-   startTimer(_timerPeriod);
+   setupShared();
+   _outstanding.fill(0,_size + _localSize);
+   _waiting.resize(_size + _localSize);
+   if ( provided >= MPI_THREAD_SERIALIZED )
+   {
+      _thread = new Thread(*this);
+      _thread->start();
+   }
+   else
+   {
+      startTimer(_timerPeriod);
+   }
 }
 
 
@@ -306,10 +430,29 @@ QMPI::~QMPI()
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   // If MPI initialization did not fail for this object then free the local MPI comm
-   // and call the MPI finalize function.
+   // If there is a progress thread then ask it to stop, which sends all queued data
+   // first, and wait for it to finish.
+   if ( _thread )
+   {
+      _thread->stop();
+      _thread->wait();
+      delete _thread;
+   }
+   else if ( !_failed )
+   {
+      flush();
+   }
+   delete _exception;
+
+   // If MPI initialization did not fail for this object then free the shared memory
+   // window and local MPI comm and call the MPI finalize function.
    if ( !_failed )
    {
+      if ( _window != MPI_WIN_NULL )
+      {
+         MPI_Win_unlock_all(_window);
+         MPI_Win_free(&_window);
+      }
       MPI_Comm_free(&_local);
       MPI_Finalize();
    }
@@ -321,63 +464,430 @@ QMPI::~QMPI()
 
 
 /*!
- * Probe the given MPI comm for any received data from the node with the given
- * rank, emitting a data received signal if data is found. This does not block
- * and returns immediately if there is no pending data to receive.
+ * Makes one round of progress with the MPI system, completing sends in flight,
+ * posting all queued data, retrying data waiting for room in a ring buffer, and
+ * then probing the world and local comms for received data if listening is
+ * enabled. This is called on the progress thread, or on this object's thread if
+ * there is no progress thread.
  *
- * @param comm The MPI comm that is proved. This is either the world or local
+ * @return True if any data was sent or received or false otherwise.
+ */
+bool QMPI::progress()
+{
+   // Complete any finished sends and then post all queued data.
+   bool ret {complete(false)};
+   Message message;
+   while ( _sends.pop(message) )
+   {
+      post(std::move(message));
+      ret = true;
+   }
+
+   // Start data waiting for each local node while it has room in its ring buffer,
+   // since other nodes release room without notice.
+   if ( _window != MPI_WIN_NULL )
+   {
+      for (int i = 0; i < _localSize ;++i)
+      {
+         for (auto index: {_worldRanks.at(i),_size + i})
+         {
+            QQueue<Message>& waiting {_waiting[index]};
+            while ( !waiting.isEmpty() && _outstanding.at(index) < _sendBudget && share(waiting.head()) )
+            {
+               start(waiting.dequeue());
+               ret = true;
+            }
+         }
+      }
+   }
+
+   // If listening is enabled then receive all pending data from the world and local
+   // MPI comms.
+   if ( !_ignore.loadAcquire() )
+   {
+      while ( probe(MPI_COMM_WORLD) || probe(_local) )
+      {
+         ret = true;
+      }
+   }
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * Sends all data still waiting to be sent, blocking until every send has
+ * completed. This is called before MPI is shutdown so no data is lost. While
+ * flushing, data for nodes on this system is sent inline instead of through
+ * their ring buffer, since they may no longer be reading it.
+ */
+void QMPI::flush()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Send all data inline from now on and post all queued data.
+   _flushing = true;
+   Message message;
+   while ( _sends.pop(message) )
+   {
+      post(std::move(message));
+   }
+
+   // Start all waiting data each node has room for in its send budget and then wait
+   // for sends to complete, until there are no sends in flight. Data can only still
+   // be waiting while its node has sends in flight.
+   while ( true )
+   {
+      for (int i = 0; i < _waiting.size() ;++i)
+      {
+         QQueue<Message>& waiting {_waiting[i]};
+         while ( !waiting.isEmpty() && _outstanding.at(i) < _sendBudget && share(waiting.head()) )
+         {
+            start(waiting.dequeue());
+         }
+      }
+      if ( _requests.isEmpty() )
+      {
+         break;
+      }
+      complete(true);
+   }
+   _flushing = false;
+}
+
+
+
+
+
+
+/*!
+ * Probe the given MPI comm for received data from any node, receiving it if
+ * found. The matched probe and receive calls are used so the message probed is
+ * the one received. This does not block and returns immediately if there is no
+ * pending data to receive.
+ *
+ * @param comm The MPI comm that is probed. This is either the world or local
  *             comm.
  *
- * @param rank The from rank that is checked for new data received.
+ * @return True if data was received or false otherwise.
  */
-void QMPI::probe(MPI_Comm comm, int rank)
+bool QMPI::probe(MPI_Comm comm)
 {
-   // Probe to see if there is pending data for the given MPI comm from the given
-   // rank. If probing fails then throw an exception, else if there is no pending
-   // data then do nothing and exit, else go to the next step.
+   // Probe to see if there is pending data for the given MPI comm from any rank. If
+   // probing fails then throw an exception, else if there is no pending data then
+   // return false, else go to the next step.
    int flag;
+   MPI_Message handle;
    MPI_Status status;
-   if ( MPI_Iprobe(rank,0,comm,&flag,&status) )
+   if ( MPI_Improbe(MPI_ANY_SOURCE,MPI_ANY_TAG,comm,&flag,&handle,&status) )
    {
       E_MAKE_EXCEPTION(e);
       e.setTitle(tr("MPI Failed"));
-      e.setDetails(tr("MPI_Iprobe failed."));
+      e.setDetails(tr("MPI_Improbe failed."));
       throw e;
    }
-   if ( flag )
+   if ( !flag )
    {
-      // Get the size of the pending data that is assumed to be of type MPI_CHAR and
-      // then get the data itself. If getting the size of the data or getting the data
-      // fails then throw an exception, else go to the next step.
-      int count;
-      if ( MPI_Get_count(&status,MPI_CHAR,&count) )
+      return false;
+   }
+
+   // Get the size of the pending data that is assumed to be of type MPI_CHAR and
+   // then get the data itself. If getting the size of the data or getting the data
+   // fails then throw an exception, else go to the next step.
+   int count;
+   if ( MPI_Get_count(&status,MPI_CHAR,&count) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("MPI Failed"));
+      e.setDetails(tr("MPI_Get_count failed."));
+      throw e;
+   }
+   Message message {QByteArray(count,Qt::Uninitialized),status.MPI_SOURCE,comm == _local,false};
+   if ( MPI_Mrecv(message.data.data(),count,MPI_CHAR,&handle,MPI_STATUS_IGNORE) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("MPI Failed"));
+      e.setDetails(tr("MPI_Mrecv failed."));
+      throw e;
+   }
+
+   // If the received data is a shared memory notification then replace it with the
+   // data it refers to and pass it to this object's thread.
+   if ( status.MPI_TAG == _sharedTag )
+   {
+      unshare(message);
+   }
+   receive(std::move(message));
+   return true;
+}
+
+
+
+
+
+
+/*!
+ * Adds the given received message to the received queue. If there is a progress
+ * thread and a call to deliver received data is not already queued on this
+ * object's thread then one is queued.
+ *
+ * @param message The message received from another node.
+ */
+void QMPI::receive(Message&& message)
+{
+   _received.push(std::move(message));
+   if ( _thread && _delivering.testAndSetOrdered(0,1) )
+   {
+      QMetaObject::invokeMethod(this,"deliver",Qt::QueuedConnection);
+   }
+}
+
+
+
+
+
+
+/*!
+ * Posts the given message to be sent. If its node has room in its send budget,
+ * room in its ring buffer if it is on this system, and no older data waiting
+ * then the send is started now, else the message waits in order behind the
+ * other data for its node.
+ *
+ * @param message The message that is sent.
+ */
+void QMPI::post(Message&& message)
+{
+   int index {slot(message)};
+   if ( _outstanding.at(index) < _sendBudget && _waiting.at(index).isEmpty() && share(message) )
+   {
+      start(std::move(message));
+   }
+   else
+   {
+      _waiting[index].enqueue(std::move(message));
+   }
+}
+
+
+
+
+
+
+/*!
+ * Starts a non blocking send of the given message to its rank or local rank,
+ * depending on if it uses the world or local comm. A shared memory notification
+ * is always sent through the local comm with its own tag. The message is kept
+ * in the list of sends in flight until its send completes.
+ *
+ * @param message The message that is sent.
+ */
+void QMPI::start(Message&& message)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,message.rank,message.local);
+
+   // Determine the comm, rank, and tag the given data is sent with.
+   MPI_Comm comm {message.local ? _local : MPI_COMM_WORLD};
+   int rank {message.rank};
+   int tag {0};
+   if ( message.shared )
+   {
+      comm = _local;
+      rank = message.local ? message.rank : _localRanks.at(message.rank);
+      tag = _sharedTag;
+   }
+
+   // Start sending the given data. If starting the send fails then throw an
+   // exception.
+   MPI_Request request;
+   if ( MPI_Isend(message.data.constData(),message.data.size(),MPI_CHAR,rank,tag,comm,&request) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("MPI Failed"));
+      e.setDetails(tr("MPI_Isend failed."));
+      throw e;
+   }
+
+   // Track the request and the message keeping its data alive.
+   ++_outstanding[slot(message)];
+   _requests << request;
+   _inFlight << std::move(message);
+}
+
+
+
+
+
+
+/*!
+ * Completes any sends in flight that have finished, releasing their data and
+ * starting any waiting data their nodes now have room for.
+ *
+ * @param block True to block until at least one send completes or false to
+ *              return immediately.
+ *
+ * @return True if any send completed or false otherwise.
+ */
+bool QMPI::complete(bool block)
+{
+   // If there are no sends in flight then there is nothing to complete.
+   if ( _requests.isEmpty() )
+   {
+      return false;
+   }
+
+   // Test or wait for finished sends. If this fails then throw an exception.
+   int count;
+   QVector<int> indexes(_requests.size());
+   int failed {block ? MPI_Waitsome(_requests.size(),_requests.data(),&count,indexes.data(),MPI_STATUSES_IGNORE)
+                     : MPI_Testsome(_requests.size(),_requests.data(),&count,indexes.data(),MPI_STATUSES_IGNORE)};
+   if ( failed )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("MPI Failed"));
+      e.setDetails(block ? tr("MPI_Waitsome failed.") : tr("MPI_Testsome failed."));
+      throw e;
+   }
+   if ( count == MPI_UNDEFINED || count == 0 )
+   {
+      return false;
+   }
+
+   // Release the budget of each finished send's node, saving the node indexes.
+   QVector<int> nodes(count);
+   for (int i = 0; i < count ;++i)
+   {
+      nodes[i] = slot(_inFlight.at(indexes.at(i)));
+      --_outstanding[nodes.at(i)];
+   }
+
+   // Remove all finished sends, whose requests were set to null, from the lists of
+   // requests and messages in flight.
+   int size {0};
+   for (int i = 0; i < _requests.size() ;++i)
+   {
+      if ( _requests.at(i) != MPI_REQUEST_NULL )
       {
-         E_MAKE_EXCEPTION(e);
-         e.setTitle(tr("MPI Failed"));
-         e.setDetails(tr("MPI_Get_count failed."));
-         throw e;
+         if ( size != i )
+         {
+            _requests[size] = _requests.at(i);
+            _inFlight[size] = std::move(_inFlight[i]);
+         }
+         ++size;
       }
-      QByteArray data;
-      data.resize(count);
-      if ( MPI_Recv(data.data(),count,MPI_CHAR,rank,0,comm,MPI_STATUS_IGNORE) )
+   }
+   _requests.resize(size);
+   _inFlight.resize(size);
+
+   // Start waiting data for each node that finished a send while it has room.
+   for (auto index: nodes)
+   {
+      while ( !_waiting.at(index).isEmpty()
+              && _outstanding.at(index) < _sendBudget
+              && share(_waiting[index].head()) )
       {
-         E_MAKE_EXCEPTION(e);
-         e.setTitle(tr("MPI Failed"));
-         e.setDetails(tr("MPI_Recv failed."));
-         throw e;
+         start(_waiting[index].dequeue());
       }
+   }
+   return true;
+}
+
+
+
 
-      // Emit a local data received or data received signal, depending on if the given
-      // comm is the world or local one.
-      if ( comm == _local )
+
+
+/*!
+ * Returns the index of the given message's node used for the send budget and
+ * waiting queue of each node.
+ *
+ * @param message The message whose node index is returned.
+ *
+ * @return Index of the given message's node.
+ */
+int QMPI::slot(const Message& message) const
+{
+   return message.local ? _size + message.rank : message.rank;
+}
+
+
+
+
+
+
+/*!
+ * Replaces the data of the given message with a shared memory notification if
+ * its node is on this system. The data is copied into the ring buffer this node
+ * owns for that node, or kept inline after the notification if it is larger
+ * than a ring buffer or this object is flushing. A notification is the total
+ * number of bytes written to the ring buffer after the data, the size of the
+ * data, and if the message uses the local comm. If the ring buffer does not have
+ * room for the data yet then the message is left alone.
+ *
+ * @param message The message whose data is replaced.
+ *
+ * @return True if the message can be sent now or false if it must wait for room
+ *         in its ring buffer.
+ */
+bool QMPI::share(Message& message)
+{
+   // If there is no shared memory window, the message is already a notification, or
+   // its node is not on this system then do nothing and return true, else go to the
+   // next step.
+   if ( _window == MPI_WIN_NULL || message.shared )
+   {
+      return true;
+   }
+   int peer {message.local ? message.rank : _localRanks.at(message.rank)};
+   if ( peer < 0 || peer == _localRank )
+   {
+      return true;
+   }
+
+   // If the data fits in a ring buffer and this object is not flushing then find
+   // where it is written, wrapping to the beginning if it does not fit before the
+   // end. If the ring buffer does not
+   // have room then return false, else go to the next step.
+   qint64 size {message.data.size()};
+   qint64 end {-1};
+   if ( size <= _ringSize && !_flushing )
+   {
+      qint64 begin {_written.at(peer)};
+      qint64 position {begin%_ringSize};
+      if ( position + size > _ringSize )
       {
-         emit localDataReceived(data,rank);
+         begin += _ringSize - position;
       }
-      else
+      end = begin + size;
+      if ( end - released(_localRank,peer)->loadAcquire() > _ringSize )
       {
-         emit dataReceived(data,rank);
+         return false;
       }
+
+      // Copy the data into the ring buffer and make it visible to other nodes before
+      // the notification is sent.
+      memcpy(ring(_localRank,peer) + begin%_ringSize,message.data.constData(),size);
+      _written[peer] = end;
+      MPI_Win_sync(_window);
+   }
+
+   // Build the notification, appending the data if it was not written to the ring
+   // buffer, and replace the message's data with it.
+   QByteArray notification(3*sizeof(qint64) + ( end < 0 ? size : 0 ),Qt::Uninitialized);
+   qToBigEndian<qint64>(end,notification.data());
+   qToBigEndian<qint64>(size,notification.data() + sizeof(qint64));
+   qToBigEndian<qint64>(message.local,notification.data() + 2*sizeof(qint64));
+   if ( end < 0 )
+   {
+      memcpy(notification.data() + 3*sizeof(qint64),message.data.constData(),size);
    }
+   message.data = notification;
+   message.shared = true;
+   return true;
 }
 
 
@@ -386,32 +896,88 @@ void QMPI::probe(MPI_Comm comm, int rank)
 
 
 /*!
- * Send the given data to the given rank or local rank, depending on the given
- * comm being world or local. This is asynchronous and returns immediately.
- *
- * @param comm The MPI comm used to send the data. This is either world or
- *             local.
+ * Replaces the shared memory notification of the given message, received from
+ * a node on this system through the local comm, with the data it refers to.
+ * Data in a ring buffer is copied out of it and then released to its owner.
  *
- * @param toRank The rank or local rank, depending on if the given comm is world
- *               or local respectively, of the node to send this data to.
- *
- * @param data The data that is sent to the node with the given rank or local
- *             rank.
+ * @param message The message whose notification is replaced.
  */
-void QMPI::sendData(MPI_Comm comm, int toRank, const QByteArray& data)
+void QMPI::unshare(Message& message)
 {
-   // Add the debug header.
-   EDEBUG_FUNC(this,&comm,toRank,&data);
-
-   // Send the given data to the node with the given rank using the given MPI comm.
-   // If sending fails then throw an exception.
-   if ( MPI_Send(data.data(),data.size(),MPI_CHAR,toRank,0,comm) )
+   // If the notification is malformed then throw an exception, else read it.
+   const QByteArray& notification {message.data};
+   if ( _window == MPI_WIN_NULL || notification.size() < static_cast<int>(3*sizeof(qint64)) )
    {
       E_MAKE_EXCEPTION(e);
       e.setTitle(tr("MPI Failed"));
-      e.setDetails(tr("MPI_Send failed."));
+      e.setDetails(tr("Received invalid shared memory notification."));
       throw e;
    }
+   qint64 end {qFromBigEndian<qint64>(notification.constData())};
+   qint64 size {qFromBigEndian<qint64>(notification.constData() + sizeof(qint64))};
+   bool local {qFromBigEndian<qint64>(notification.constData() + 2*sizeof(qint64)) != 0};
+
+   // If the data follows the notification inline then take it, else copy it out of
+   // the ring buffer the sending node owns for this node and release it.
+   int peer {message.rank};
+   if ( end < 0 )
+   {
+      message.data = notification.mid(3*sizeof(qint64));
+   }
+   else
+   {
+      MPI_Win_sync(_window);
+      message.data = QByteArray(ring(peer,_localRank) + (end - size)%_ringSize,size);
+      released(peer,_localRank)->storeRelease(end);
+   }
+
+   // Set the message to the comm and rank it was originally sent with.
+   message.local = local;
+   message.rank = local ? peer : _worldRanks.at(peer);
+}
+
+
+
+
+
+
+/*!
+ * Returns a pointer to the ring buffer the local node with the given local rank
+ * owns for sending data to the other given local node.
+ *
+ * @param from The local rank of the node that sends data and owns the ring
+ *             buffer.
+ *
+ * @param to The local rank of the node that receives data.
+ *
+ * @return Pointer to the ring buffer.
+ */
+char* QMPI::ring(int from, int to) const
+{
+   return _segments.at(from) + to*(_lineSize + _ringSize) + _lineSize;
+}
+
+
+
+
+
+
+/*!
+ * Returns a pointer to the release counter of the ring buffer the local node
+ * with the given local rank owns for sending data to the other given local
+ * node. The counter is the total number of bytes written to the ring buffer
+ * that the receiving node has copied out of it.
+ *
+ * @param from The local rank of the node that sends data and owns the ring
+ *             buffer.
+ *
+ * @param to The local rank of the node that receives data.
+ *
+ * @return Pointer to the release counter.
+ */
+QAtomicInteger<qint64>* QMPI::released(int from, int to) const
+{
+   return reinterpret_cast<QAtomicInteger<qint64>*>(_segments.at(from) + to*(_lineSize + _ringSize));
 }
 
 
@@ -454,6 +1020,8 @@ void QMPI::setupWorld()
 /*!
  * Sets up the local MPI comm which is determined by all nodes that share local
  * resources, getting the local size and this node's local rank rank from it.
+ * The world ranks of all local nodes and the local leader of every node are
+ * also gathered.
  */
 void QMPI::setupLocal()
 {
@@ -484,6 +1052,262 @@ void QMPI::setupLocal()
       e.setDetails(tr("MPI_Comm_rank failed."));
       throw e;
    }
+
+   // Gather the world rank of every local node and then the world rank of local rank
+   // 0 of every node. If any MPI call fails then throw an exception.
+   _worldRanks.resize(_localSize);
+   if ( MPI_Allgather(&_rank,1,MPI_INT,_worldRanks.data(),1,MPI_INT,_local) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("MPI Failed"));
+      e.setDetails(tr("MPI_Allgather failed."));
+      throw e;
+   }
+   int leader {_worldRanks.at(0)};
+   _leaders.resize(_size);
+   if ( MPI_Allgather(&leader,1,MPI_INT,_leaders.data(),1,MPI_INT,MPI_COMM_WORLD) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("MPI Failed"));
+      e.setDetails(tr("MPI_Allgather failed."));
+      throw e;
+   }
+
+   // Build the local rank of every world rank from the world ranks of local nodes.
+   _localRanks.fill(-1,_size);
+   for (int i = 0; i < _localSize ;++i)
+   {
+      _localRanks[_worldRanks.at(i)] = i;
+   }
+}
+
+
+
+
+
+
+/*!
+ * Sets up the MPI shared memory window used to send data between nodes on the
+ * same system. Each local node allocates a segment holding one ring buffer with
+ * a release counter for every local node. If there are no other local nodes or
+ * the MPI system cannot allocate the window then shared memory is not used.
+ */
+void QMPI::setupShared()
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // If there are no other local nodes then do nothing and exit, else go to the next
+   // step.
+   if ( _localSize < 2 )
+   {
+      return;
+   }
+
+   // Determine the size of each ring buffer, keeping them aligned to cache lines,
+   // and allocate this node's segment of the shared memory window. If allocation
+   // fails then do not use shared memory and exit, else go to the next step.
+   _ringSize = (_sharedSize/_localSize - _lineSize)/_lineSize*_lineSize;
+   char* base;
+   if ( _ringSize < _lineSize
+        || MPI_Win_allocate_shared(_localSize*(_lineSize + _ringSize)
+                                   ,1
+                                   ,MPI_INFO_NULL
+                                   ,_local
+                                   ,&base
+                                   ,&_window) )
+   {
+      _window = MPI_WIN_NULL;
+      return;
+   }
+
+   // Get the address of every local node's segment. If any MPI call fails then throw
+   // an exception.
+   _segments.resize(_localSize);
+   for (int i = 0; i < _localSize ;++i)
+   {
+      MPI_Aint size;
+      int unit;
+      if ( MPI_Win_shared_query(_window,i,&size,&unit,&_segments[i]) )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("MPI Failed"));
+         e.setDetails(tr("MPI_Win_shared_query failed."));
+         throw e;
+      }
+   }
+
+   // Initialize the release counters of this node's ring buffers, begin a passive
+   // access epoch to the window, and wait for all local nodes to do the same.
+   for (int i = 0; i < _localSize ;++i)
+   {
+      new(released(_localRank,i)) QAtomicInteger<qint64>(0);
+   }
+   _written.fill(0,_localSize);
+   if ( MPI_Win_lock_all(MPI_MODE_NOCHECK,_window) || MPI_Barrier(_local) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("MPI Failed"));
+      e.setDetails(tr("Failed starting shared memory window access."));
+      throw e;
+   }
+}
+
+
+
+
+
+
+/*!
+ * Constructs a new empty queue.
+ */
+QMPI::Queue::Queue()
+   :
+   _last(new Node),
+   _first(_last.load())
+{}
+
+
+
+
+
+
+/*!
+ * Deletes all nodes still in this queue.
+ */
+QMPI::Queue::~Queue()
+{
+   while ( _first )
+   {
+      Node* next {_first->next.load()};
+      delete _first;
+      _first = next;
+   }
+}
+
+
+
+
+
+
+/*!
+ * Pushes the given message to the end of this queue. This can be called from
+ * any thread and never blocks.
+ *
+ * @param message The message that is moved into this queue.
+ */
+void QMPI::Queue::push(Message&& message)
+{
+   // Make a new node with the given message, swap it in as the last node, and then
+   // link the previous last node to it.
+   Node* node {new Node};
+   node->message = std::move(message);
+   Node* previous {_last.fetchAndStoreOrdered(node)};
+   previous->next.storeRelease(node);
+}
+
+
+
+
+
+
+/*!
+ * Pops the first message of this queue if there is one. This must only be
+ * called from one thread at a time.
+ *
+ * @param message The message that is moved out of this queue if there is one.
+ *
+ * @return True if a message was popped or false if this queue is empty.
+ */
+bool QMPI::Queue::pop(Message& message)
+{
+   // If the node popped last has no next node then this queue is empty, else move
+   // the message out of the next node, delete the node popped last, and make the
+   // next node the one popped last.
+   Node* next {_first->next.loadAcquire()};
+   if ( !next )
+   {
+      return false;
+   }
+   message = std::move(next->message);
+   delete _first;
+   _first = next;
+   return true;
+}
+
+
+
+
+
+
+/*!
+ * Constructs a new progress thread for the given QMPI object.
+ *
+ * @param mpi The QMPI object this thread does communication for.
+ */
+QMPI::Thread::Thread(QMPI& mpi)
+   :
+   _mpi(mpi)
+{}
+
+
+
+
+
+
+/*!
+ * Asks this thread to stop. All queued data is sent before it stops.
+ */
+void QMPI::Thread::stop()
+{
+   _stop.storeRelease(1);
+}
+
+
+
+
+
+
+/*!
+ * Implements _QThread::run_. This makes progress with the MPI system until it
+ * is asked to stop, sleeping while there is no activity. If an exception occurs
+ * it is saved and this thread stops making progress.
+ */
+void QMPI::Thread::run()
+{
+   try
+   {
+      // Make progress until asked to stop. Each time there is no activity the sleep
+      // time doubles up to its limit, and any activity resets it.
+      unsigned long wait {0};
+      while ( !_stop.loadAcquire() )
+      {
+         if ( _mpi.progress() )
+         {
+            wait = 0;
+         }
+         else
+         {
+            wait = wait ? wait*2 : 1;
+            if ( wait > _maxIdleWait )
+            {
+               wait = _maxIdleWait;
+            }
+            usleep(wait);
+         }
+      }
+
+      // Send any data queued before this thread was asked to stop.
+      _mpi.flush();
+   }
+   catch (EException e)
+   {
+      // Save the exception and queue a call to throw it on the QMPI object's thread.
+      QMutexLocker locker(&_mpi._mutex);
+      delete _mpi._exception;
+      _mpi._exception = new EException(e);
+      QMetaObject::invokeMethod(&_mpi,"deliver",Qt::QueuedConnection);
+   }
 }
 
 }
@@ -2,7 +2,11 @@
 #define ACE_QMPI_H
 #include <QObject>
 #include <QVector>
+#include <QThread>
+#include <QMutex>
+#include <QQueue>
 #include <mpi.h>
+#include "global.h"
 
 
 
@@ -25,6 +29,24 @@ namespace Ace
     *
     * Listening for incoming MPI messages can also be enabled or disabled, and is
     * disabled by default.
+    *
+    * All MPI communication after initialization is done by an internal progress
+    * thread. The progress thread probes each comm for messages from any source,
+    * so the cost of checking for messages does not grow with the number of nodes.
+    * Received messages are passed to the thread this object lives in through a
+    * lock free queue and data sent by this object is passed to the progress
+    * thread through another. Data is sent without blocking and kept alive until
+    * the MPI system is done with it, with a limit on the number of sends in flight
+    * to each node. If the MPI system does not support the threading
+    * required then this object falls back to polling on its own thread with a Qt
+    * timer.
+    *
+    * Data sent to another node on the same system, through either comm, is copied
+    * into a ring buffer in an MPI shared memory window and only a small
+    * notification is sent through the local comm. Each node owns one ring buffer
+    * for every other local node it sends to, which that node copies received data
+    * out of and releases in order. Data too large for a ring buffer is sent inline
+    * with its notification so data between two nodes is never reordered.
     */
    class QMPI : public QObject
    {
@@ -38,6 +60,8 @@ namespace Ace
       int rank() const;
       int localSize() const;
       int localRank() const;
+      int leader(int rank) const;
+      int worldRank(int localRank) const;
       void start();
       void stop();
    signals:
@@ -63,12 +87,127 @@ namespace Ace
       void sendLocalData(int toRank, const QByteArray& data);
    protected:
       virtual void timerEvent(QTimerEvent* event) override final;
+   private slots:
+      void deliver();
+   private:
+      /*!
+       * This holds a single message received from or waiting to be sent to another
+       * node.
+       */
+      struct Message
+      {
+         /*!
+          * The data of this message.
+          */
+         QByteArray data;
+         /*!
+          * The rank or local rank of the node that sent or receives this message.
+          */
+         int rank;
+         /*!
+          * True if this message uses the local comm or false if it uses the world
+          * comm.
+          */
+         bool local;
+         /*!
+          * True if the data of this message has been replaced with a shared memory
+          * notification or false otherwise.
+          */
+         bool shared;
+      };
+      /*!
+       * This is an unbounded lock free queue of messages that any number of threads
+       * can push to and a single thread pops from. Each message is held in its own
+       * node and the last node popped is kept as the head of the queue, so pushing
+       * never has to wait for the popping thread.
+       */
+      class Queue
+      {
+      public:
+         Queue();
+         ~Queue();
+         void push(Message&& message);
+         bool pop(Message& message);
+      private:
+         /*!
+          * This holds a single message in a queue along with a pointer to the next
+          * node.
+          */
+         struct Node
+         {
+            /*!
+             * The message of this node.
+             */
+            Message message;
+            /*!
+             * Pointer to the next node in the queue or null if this is the last one.
+             */
+            QAtomicPointer<Node> next {nullptr};
+         };
+         /*!
+          * Pointer to the last node pushed to this queue, which is only changed by an
+          * atomic exchange.
+          */
+         QAtomicPointer<Node> _last;
+         /*!
+          * Pointer to the node whose message was popped last, which is only used by the
+          * popping thread.
+          */
+         Node* _first;
+      };
+      /*!
+       * This is the progress thread that does all MPI communication after
+       * initialization. It repeatedly sends queued data and probes for received
+       * data, sleeping for a short time that grows up to a limit while there is no
+       * activity.
+       */
+      class Thread : public QThread
+      {
+      public:
+         Thread(QMPI& mpi);
+         void stop();
+      protected:
+         virtual void run() override final;
+      private:
+         /*!
+          * The maximum time, in microseconds, this thread sleeps between checks while
+          * there is no activity.
+          */
+         constexpr static unsigned long _maxIdleWait {1000};
+         /*!
+          * Reference to the QMPI object this thread does communication for.
+          */
+         QMPI& _mpi;
+         /*!
+          * Atomic switch set to 1 when this thread is asked to stop.
+          */
+         QAtomicInteger<int> _stop {0};
+      };
    private:
       /*!
        * The period, in milliseconds, between each time this class checks for new data
-       * received from the MPI system.
+       * received from the MPI system if there is no progress thread.
        */
       constexpr static int _timerPeriod {50};
+      /*!
+       * The maximum number of sends in flight to any one node. Any more data sent to
+       * that node waits in order until one of its sends completes.
+       */
+      constexpr static int _sendBudget {16};
+      /*!
+       * The size, in bytes, of the shared memory window segment of each node which is
+       * divided between its ring buffers.
+       */
+      constexpr static qint64 _sharedSize {1 << 25};
+      /*!
+       * The size, in bytes, of the header of each ring buffer holding its release
+       * counter, which is one cache line.
+       */
+      constexpr static qint64 _lineSize {64};
+      /*!
+       * The MPI tag used for shared memory notifications on the local comm.
+       */
+      constexpr static int _sharedTag {1};
       /*!
        * True if an instance of this class has already been deleted or false
        * otherwise. This is used to make sure a second class is never deleted.
@@ -82,10 +221,21 @@ namespace Ace
       explicit QMPI();
       virtual ~QMPI() override final;
    private:
-      void probe(MPI_Comm comm, int rank);
-      void sendData(MPI_Comm comm, int toRank, const QByteArray& data);
+      bool progress();
+      void flush();
+      bool probe(MPI_Comm comm);
+      void receive(Message&& message);
+      void post(Message&& message);
+      void start(Message&& message);
+      bool complete(bool block);
+      int slot(const Message& message) const;
+      bool share(Message& message);
+      void unshare(Message& message);
+      char* ring(int from, int to) const;
+      QAtomicInteger<qint64>* released(int from, int to) const;
       void setupWorld();
       void setupLocal();
+      void setupShared();
    private:
       /*!
        * The total number of nodes of the MPI run.
@@ -108,16 +258,102 @@ namespace Ace
        * The local rank of this node that identifies if within the local MPI comm.
        */
       int _localRank;
+      /*!
+       * The world rank of the node with local rank 0 on the same system as each node,
+       * indexed by world rank.
+       */
+      QVector<int> _leaders;
+      /*!
+       * The world rank of each node in the local MPI comm, indexed by local rank.
+       */
+      QVector<int> _worldRanks;
+      /*!
+       * The local rank of each node indexed by world rank, or -1 for nodes on other
+       * systems.
+       */
+      QVector<int> _localRanks;
+      /*!
+       * The MPI shared memory window of all local nodes, or null if shared memory is
+       * not used.
+       */
+      MPI_Win _window {MPI_WIN_NULL};
+      /*!
+       * Pointer to the shared memory window segment of each local node, indexed by
+       * local rank.
+       */
+      QVector<char*> _segments;
+      /*!
+       * The size, in bytes, of each ring buffer.
+       */
+      qint64 _ringSize {0};
+      /*!
+       * The total number of bytes written to each ring buffer of this node, indexed
+       * by the local rank it sends to.
+       */
+      QVector<qint64> _written;
       /*!
        * True if initialization of MPI failed and was set to a default null state or
        * false otherwise.
        */
       bool _failed {false};
       /*!
-       * True to ignore all incoming MPI messages or false to read them in and emit
-       * signals.
+       * Atomic switch that is 1 to ignore all incoming MPI messages or 0 to read them
+       * in and emit signals.
+       */
+      QAtomicInteger<int> _ignore {1};
+      /*!
+       * Pointer to the progress thread of this object or null if the MPI system does
+       * not support it.
+       */
+      Thread* _thread {nullptr};
+      /*!
+       * Queue of data waiting to be sent by the progress thread.
+       */
+      Queue _sends;
+      /*!
+       * List of MPI requests of all sends in flight.
+       */
+      QVector<MPI_Request> _requests;
+      /*!
+       * List of messages of all sends in flight, matching the list of requests. Each
+       * message keeps its data alive until its send completes.
+       */
+      QVector<Message> _inFlight;
+      /*!
+       * The number of sends in flight to each node, indexed first by world rank and
+       * then by local rank after all world ranks.
+       */
+      QVector<int> _outstanding;
+      /*!
+       * Queues of messages waiting for a send in flight to complete or room in their
+       * ring buffer, one for each node using the same index as the number of sends in
+       * flight.
+       */
+      QVector<QQueue<Message>> _waiting;
+      /*!
+       * True if all data is being flushed before shutdown, which sends data to nodes
+       * on this system inline instead of waiting for room in their ring buffer.
+       */
+      bool _flushing {false};
+      /*!
+       * Queue of data received by the progress thread waiting to be signaled on this
+       * object's thread.
+       */
+      Queue _received;
+      /*!
+       * Atomic switch set to 1 when a call to deliver received data is already
+       * queued on this object's thread.
+       */
+      QAtomicInteger<int> _delivering {0};
+      /*!
+       * Mutex protecting the exception pointer.
+       */
+      QMutex _mutex;
+      /*!
+       * Pointer to any exception that occurs on the progress thread, which is thrown
+       * again on this object's thread.
        */
-      bool _ignore {true};
+      EException* _exception {nullptr};
    };
 }
 
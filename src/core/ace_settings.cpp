@@ -43,6 +43,11 @@ const char* Settings::_chunkPrefixDefault {"chunk"};
  * The default chunk file extension value.
  */
 const char* Settings::_chunkExtensionDefault {"abd"};
+/*!
+ * The default metadata history directory value, where an empty path means the
+ * history store is disabled.
+ */
+const char* Settings::_historyDirDefault {""};
 /*!
  */
 const bool Settings::_loggingEnabledDefault {false};
@@ -65,10 +70,32 @@ const char* Settings::_openCLDeviceKey {"opencl.device"};
  * The qt settings key used to persistently store the thread size value.
  */
 const char* Settings::_threadSizeKey {"opencl.thread.size"};
+/*!
+ * The qt settings key used to persistently store the CPU thread size value.
+ */
+const char* Settings::_cpuThreadSizeKey {"cpu.thread.size"};
 /*!
  * The qt settings key used to persistently store the buffer size value.
  */
 const char* Settings::_bufferSizeKey {"mpi.buffersize"};
+/*!
+ * The qt settings key used to persistently store the MPI reduction enabled
+ * state.
+ */
+const char* Settings::_reductionEnabledKey {"mpi.reduction"};
+/*!
+ * The qt settings key used to persistently store the MPI timeout value.
+ */
+const char* Settings::_timeoutKey {"mpi.timeout"};
+/*!
+ * The qt settings key used to persistently store the MPI checkpoint interval
+ * value.
+ */
+const char* Settings::_checkpointIntervalKey {"mpi.checkpoint"};
+/*!
+ * The qt settings key used to persistently store the window size value.
+ */
+const char* Settings::_windowSizeKey {"run.window.size"};
 /*!
  * The qt settings key used to persistently store the chunk working directory
  * value.
@@ -83,6 +110,15 @@ const char* Settings::_chunkPrefixKey {"chunk.prefix"};
  * value.
  */
 const char* Settings::_chunkExtensionKey {"chunk.extension"};
+/*!
+ * The qt settings key used to persistently store the merge timeout value.
+ */
+const char* Settings::_mergeTimeoutKey {"chunk.merge.timeout"};
+/*!
+ * The qt settings key used to persistently store the metadata history directory
+ * value.
+ */
+const char* Settings::_historyDirKey {"history.directory"};
 /*!
  */
 const char* Settings::_loggingEnabledKey {"logging.enabled"};
@@ -384,6 +420,23 @@ int Settings::threadSize() const
 
 
 
+/*!
+ * Returns the thread size for CPU runs that do not use an accelerated device.
+ * A value of 0 means the thread size is determined automatically from the
+ * number of CPU cores available.
+ *
+ * @return Thread size for CPU runs.
+ */
+int Settings::cpuThreadSize() const
+{
+   return _cpuThreadSize;
+}
+
+
+
+
+
+
 /*!
  * Returns the MPI buffer size used to determine the number of blocks are
  * buffered for input to each slave node.
@@ -400,6 +453,73 @@ int Settings::bufferSize() const
 
 
 
+/*!
+ * Returns the MPI reduction enabled state. If enabled then the result blocks of
+ * slave nodes in MPI runs are gathered and reduced by one node on each system
+ * before they are sent to the master node.
+ *
+ * @return MPI reduction enabled state.
+ */
+bool Settings::reductionEnabled() const
+{
+   return _reductionEnabled;
+}
+
+
+
+
+
+
+/*!
+ * Returns the MPI timeout in seconds. The master node of an MPI run gives the
+ * work blocks of a slave node to other slave nodes if it has not sent results
+ * for this long. If this is 0 then the master node waits forever.
+ *
+ * @return MPI timeout in seconds.
+ */
+int Settings::timeout() const
+{
+   return _timeout;
+}
+
+
+
+
+
+
+/*!
+ * Returns the MPI checkpoint interval in seconds. The master node of an MPI run
+ * saves a checkpoint it can resume from this often. If this is 0 then no
+ * checkpoints are saved.
+ *
+ * @return MPI checkpoint interval in seconds.
+ */
+int Settings::checkpointInterval() const
+{
+   return _checkpointInterval;
+}
+
+
+
+
+
+
+/*!
+ * Returns the maximum number of blocks single and chunk runs keep in flight. A
+ * value of 0 means the window size is determined automatically.
+ *
+ * @return Window size for single and chunk runs.
+ */
+int Settings::windowSize() const
+{
+   return _windowSize;
+}
+
+
+
+
+
+
 /*!
  * Returns the working directory path for chunk runs.
  *
@@ -445,6 +565,41 @@ QString Settings::chunkExtension() const
 
 
 
+/*!
+ * Returns the merge timeout in seconds. A merge that is not made to wait for
+ * chunk runs to signal they are finished fails if a chunk has had neither a
+ * complete nor a temporary chunk file for this long. If this is 0 then the
+ * merge waits forever.
+ *
+ * @return Merge timeout in seconds.
+ */
+int Settings::mergeTimeout() const
+{
+   return _mergeTimeout;
+}
+
+
+
+
+
+
+/*!
+ * Returns the directory of the metadata history store. Runs that write new data
+ * objects save the full metadata of every input data object in this directory.
+ * If this is empty then the history store is disabled.
+ *
+ * @return Metadata history directory path.
+ */
+QString Settings::historyDir() const
+{
+   return _historyDir;
+}
+
+
+
+
+
+
 /*!
  * Returns the logging enabled state.
  *
@@ -570,6 +725,39 @@ void Settings::setThreadSize(int size)
 
 
 
+/*!
+ * Sets the thread size for CPU runs that do not use an accelerated device. The
+ * size must be zero or greater or an exception is thrown, where zero means the
+ * thread size is determined automatically.
+ *
+ * @param size Thread size for CPU runs.
+ */
+void Settings::setCPUThreadSize(int size)
+{
+   // If the new given thread size is less than zero then throw an exception, else go
+   // to the next step.
+   if ( size < 0 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid Argument"));
+      e.setDetails(QObject::tr("Cannot set CPU thread size to %1 (0 is smallest allowed).").arg(size));
+      throw e;
+   }
+
+   // If the new given thread size is different from the current thread size then set
+   // it to the new one and set the value in persistent storage.
+   if ( size != _cpuThreadSize )
+   {
+      _cpuThreadSize = size;
+      setValue(_cpuThreadSizeKey,_cpuThreadSize);
+   }
+}
+
+
+
+
+
+
 /*!
  * Sets the MPI buffer size used to determine the number of blocks are buffered
  * for input to each slave node.
@@ -602,6 +790,122 @@ void Settings::setBufferSize(int size)
 
 
 
+/*!
+ * Sets the MPI reduction enabled state.
+ *
+ * @param state New MPI reduction enabled state.
+ */
+void Settings::setReductionEnabled(int state)
+{
+   // If the new value is different from the current value then set it to the new one
+   // and set the value in persistent storage.
+   if ( state != _reductionEnabled )
+   {
+      _reductionEnabled = state;
+      setValue(_reductionEnabledKey,_reductionEnabled);
+   }
+}
+
+
+
+
+
+
+/*!
+ * Sets the MPI timeout in seconds, where 0 means never.
+ *
+ * @param seconds New MPI timeout in seconds.
+ */
+void Settings::setTimeout(int seconds)
+{
+   // If the new given timeout is less than zero then throw an exception, else go to
+   // the next step.
+   if ( seconds < 0 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid Argument"));
+      e.setDetails(QObject::tr("Cannot set timeout to %1 (0 is smallest allowed).").arg(seconds));
+      throw e;
+   }
+
+   // If the new given timeout is different from the current timeout then set it to
+   // the new one and set the value in persistent storage.
+   if ( seconds != _timeout )
+   {
+      _timeout = seconds;
+      setValue(_timeoutKey,_timeout);
+   }
+}
+
+
+
+
+
+
+/*!
+ * Sets the MPI checkpoint interval in seconds, where 0 means disabled.
+ *
+ * @param seconds New MPI checkpoint interval in seconds.
+ */
+void Settings::setCheckpointInterval(int seconds)
+{
+   // If the new given checkpoint interval is less than zero then throw an exception,
+   // else go to the next step.
+   if ( seconds < 0 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid Argument"));
+      e.setDetails(QObject::tr("Cannot set checkpoint interval to %1 (0 is smallest allowed).").arg(seconds));
+      throw e;
+   }
+
+   // If the new given checkpoint interval is different from the current one then set
+   // it to the new one and set the value in persistent storage.
+   if ( seconds != _checkpointInterval )
+   {
+      _checkpointInterval = seconds;
+      setValue(_checkpointIntervalKey,_checkpointInterval);
+   }
+}
+
+
+
+
+
+
+/*!
+ * Sets the maximum number of blocks single and chunk runs keep in flight. The
+ * size must be zero or greater or an exception is thrown, where zero means the
+ * window size is determined automatically.
+ *
+ * @param size New window size.
+ */
+void Settings::setWindowSize(int size)
+{
+   // If the new given window size is less than zero then throw an exception, else go
+   // to the next step.
+   if ( size < 0 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid Argument"));
+      e.setDetails(QObject::tr("Cannot set window size to %1 (0 is smallest allowed).").arg(size));
+      throw e;
+   }
+
+   // If the new given window size is different from the current window size then set
+   // it to the new one and set the value in persistent storage.
+   if ( size != _windowSize )
+   {
+      _windowSize = size;
+      setValue(_windowSizeKey,_windowSize);
+   }
+}
+
+
+
+
+
+
 /*!
  * Sets the working directory for chunk runs.
  *
@@ -666,6 +970,60 @@ void Settings::setChunkExtension(const QString& extension)
 
 
 
+/*!
+ * Sets the merge timeout in seconds, where 0 means never.
+ *
+ * @param seconds New merge timeout in seconds.
+ */
+void Settings::setMergeTimeout(int seconds)
+{
+   // If the new given merge timeout is less than zero then throw an exception, else
+   // go to the next step.
+   if ( seconds < 0 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Invalid Argument"));
+      e.setDetails(QObject::tr("Cannot set merge timeout to %1 (0 is smallest allowed).").arg(seconds));
+      throw e;
+   }
+
+   // If the new given merge timeout is different from the current merge timeout then
+   // set it to the new one and set the value in persistent storage.
+   if ( seconds != _mergeTimeout )
+   {
+      _mergeTimeout = seconds;
+      setValue(_mergeTimeoutKey,_mergeTimeout);
+   }
+}
+
+
+
+
+
+
+/*!
+ * Sets the directory of the metadata history store, where an empty path
+ * disables it.
+ *
+ * @param path New metadata history directory path.
+ */
+void Settings::setHistoryDir(const QString& path)
+{
+   // If the new given history directory path is different from the current history
+   // directory path then set it to the new one and set the value in persistent
+   // storage.
+   if ( path != _historyDir )
+   {
+      _historyDir = path;
+      setValue(_historyDirKey,_historyDir);
+   }
+}
+
+
+
+
+
+
 /*!
  * Set the logging enabled state.
  *
@@ -720,10 +1078,17 @@ Settings::Settings()
    _openCLPlatform = settings.value(_openCLPlatformKey,_openCLPlatformDefault).toInt();
    _openCLDevice = settings.value(_openCLDeviceKey,_openCLDeviceDefault).toInt();
    _threadSize = settings.value(_threadSizeKey,_threadSizeDefault).toInt();
+   _cpuThreadSize = settings.value(_cpuThreadSizeKey,_cpuThreadSizeDefault).toInt();
    _bufferSize = settings.value(_bufferSizeKey,_bufferSizeDefault).toInt();
+   _reductionEnabled = settings.value(_reductionEnabledKey,_reductionEnabledDefault).toBool();
+   _timeout = settings.value(_timeoutKey,_timeoutDefault).toInt();
+   _checkpointInterval = settings.value(_checkpointIntervalKey,_checkpointIntervalDefault).toInt();
+   _windowSize = settings.value(_windowSizeKey,_windowSizeDefault).toInt();
    _chunkDir = settings.value(_chunkDirKey,_chunkDirDefault).toString();
    _chunkPrefix = settings.value(_chunkPrefixKey,_chunkPrefixDefault).toString();
    _chunkExtension = settings.value(_chunkExtensionKey,_chunkExtensionDefault).toString();
+   _mergeTimeout = settings.value(_mergeTimeoutKey,_mergeTimeoutDefault).toInt();
+   _historyDir = settings.value(_historyDirKey,_historyDirDefault).toString();
    _loggingEnabled = settings.value(_loggingEnabledKey,_loggingEnabledDefault).toBool();
    _loggingPort = settings.value(_loggingPortKey,_loggingPortDefault).toInt();
 }
@@ -54,20 +54,34 @@ namespace Ace
       int openCLDevice() const;
       OpenCL::Device* openCLDevicePointer() const;
       int threadSize() const;
+      int cpuThreadSize() const;
       int bufferSize() const;
+      bool reductionEnabled() const;
+      int timeout() const;
+      int checkpointInterval() const;
+      int windowSize() const;
       QString chunkDir() const;
       QString chunkPrefix() const;
       QString chunkExtension() const;
+      int mergeTimeout() const;
+      QString historyDir() const;
       bool loggingEnabled() const;
       int loggingPort() const;
       void setCUDADevice(int index);
       void setOpenCLPlatform(int index);
       void setOpenCLDevice(int index);
       void setThreadSize(int size);
+      void setCPUThreadSize(int size);
       void setBufferSize(int size);
+      void setReductionEnabled(int state);
+      void setTimeout(int seconds);
+      void setCheckpointInterval(int seconds);
+      void setWindowSize(int size);
       void setChunkDir(const QString& path);
       void setChunkPrefix(const QString& prefix);
       void setChunkExtension(const QString& extension);
+      void setMergeTimeout(int seconds);
+      void setHistoryDir(const QString& path);
       void setLoggingEnabled(int state);
       void setLoggingPort(int port);
    private:
@@ -107,10 +121,30 @@ namespace Ace
        * The default thread size value.
        */
       constexpr static int _threadSizeDefault {4};
+      /*!
+       * The default CPU thread size value, where 0 means automatic.
+       */
+      constexpr static int _cpuThreadSizeDefault {0};
       /*!
        * The default buffer size value.
        */
       constexpr static int _bufferSizeDefault {4};
+      /*!
+       * The default MPI reduction enabled state.
+       */
+      constexpr static bool _reductionEnabledDefault {false};
+      /*!
+       * The default MPI timeout value in seconds, where 0 means never.
+       */
+      constexpr static int _timeoutDefault {600};
+      /*!
+       * The default MPI checkpoint interval in seconds, where 0 means disabled.
+       */
+      constexpr static int _checkpointIntervalDefault {0};
+      /*!
+       * The default window size value, where 0 means automatic.
+       */
+      constexpr static int _windowSizeDefault {0};
       /*!
        * The default chunk working directory value.
        */
@@ -123,6 +157,15 @@ namespace Ace
        * The default chunk file extension value.
        */
       static const char* _chunkExtensionDefault;
+      /*!
+       * The default merge timeout value in seconds, where 0 means never.
+       */
+      constexpr static int _mergeTimeoutDefault {0};
+      /*!
+       * The default metadata history directory value, where an empty path means the
+       * history store is disabled.
+       */
+      static const char* _historyDirDefault;
       /*!
        */
       static const bool _loggingEnabledDefault;
@@ -145,10 +188,32 @@ namespace Ace
        * The qt settings key used to persistently store the thread size value.
        */
       static const char* _threadSizeKey;
+      /*!
+       * The qt settings key used to persistently store the CPU thread size value.
+       */
+      static const char* _cpuThreadSizeKey;
       /*!
        * The qt settings key used to persistently store the buffer size value.
        */
       static const char* _bufferSizeKey;
+      /*!
+       * The qt settings key used to persistently store the MPI reduction enabled
+       * state.
+       */
+      static const char* _reductionEnabledKey;
+      /*!
+       * The qt settings key used to persistently store the MPI timeout value.
+       */
+      static const char* _timeoutKey;
+      /*!
+       * The qt settings key used to persistently store the MPI checkpoint interval
+       * value.
+       */
+      static const char* _checkpointIntervalKey;
+      /*!
+       * The qt settings key used to persistently store the window size value.
+       */
+      static const char* _windowSizeKey;
       /*!
        * The qt settings key used to persistently store the chunk working directory
        * value.
@@ -163,6 +228,15 @@ namespace Ace
        * value.
        */
       static const char* _chunkExtensionKey;
+      /*!
+       * The qt settings key used to persistently store the merge timeout value.
+       */
+      static const char* _mergeTimeoutKey;
+      /*!
+       * The qt settings key used to persistently store the metadata history directory
+       * value.
+       */
+      static const char* _historyDirKey;
       /*!
        */
       static const char* _loggingEnabledKey;
@@ -194,11 +268,38 @@ namespace Ace
        * The thread size used for accelerated analytic runs.
        */
       int _threadSize;
+      /*!
+       * The thread size used for CPU analytic runs without an accelerated device. If
+       * this is 0 then the thread size is determined automatically.
+       */
+      int _cpuThreadSize;
       /*!
        * The buffer size used for the number of blocks each slave node is buffered
        * with in MPI runs.
        */
       int _bufferSize;
+      /*!
+       * True if result blocks of slave nodes in MPI runs are gathered and reduced by
+       * one node on each system before they are sent to the master node or false
+       * otherwise.
+       */
+      bool _reductionEnabled;
+      /*!
+       * The time in seconds the master node of an MPI run waits for results from a
+       * slave node before its work blocks are given to other slave nodes. If this is 0
+       * then the master node waits forever.
+       */
+      int _timeout;
+      /*!
+       * The time in seconds between checkpoints of the master node of an MPI run. If
+       * this is 0 then no checkpoints are saved.
+       */
+      int _checkpointInterval;
+      /*!
+       * The maximum number of blocks in flight for single and chunk runs. If this is 0
+       * then the window size is determined automatically.
+       */
+      int _windowSize;
       /*!
        * The working directory for chunk runs.
        */
@@ -211,6 +312,16 @@ namespace Ace
        * The extension for temporary chunk files.
        */
       QString _chunkExtension;
+      /*!
+       * The time in seconds a merge waits for a chunk whose chunk run has not started
+       * before failing. If this is 0 then the merge waits forever.
+       */
+      int _mergeTimeout;
+      /*!
+       * The directory of the metadata history store. If this is empty then the history
+       * store is disabled.
+       */
+      QString _historyDir;
       /*!
        */
       bool _loggingEnabled;
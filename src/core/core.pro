@@ -39,16 +39,20 @@ SOURCES += \
     opencl_kernel.cpp \
     ace_analytic_simplerun.cpp \
     ace_analytic_serialrun.cpp \
+    ace_analytic_runthread.cpp \
     ace_analytic_openclrun.cpp \
     ace_analytic_openclrunthread.cpp \
     ace_analytic_cudarun.cpp \
     ace_analytic_cudarunthread.cpp \
+    ace_analytic_threadpoolrun.cpp \
+    ace_analytic_threadpoolrunthread.cpp \
     ace_analytic_single.cpp \
     ace_settings.cpp \
     ace_analytic_mpimaster.cpp \
     ace_analytic_mpislave.cpp \
     ace_analytic_chunk.cpp \
     ace_analytic_merge.cpp \
+    ace_analytic_mergethread.cpp \
     ace_analytic_abstractrun.cpp \
     ace_analytic_abstractinput.cpp \
     ace_analytic_abstractmanager.cpp \
@@ -56,6 +60,7 @@ SOURCES += \
     ace_logserver.cpp \
     elog.cpp \
     edebug.cpp \
+    etrace.cpp \
     cuda_common.cpp \
     cuda_context.cpp \
     cuda_device.cpp \
@@ -103,10 +108,13 @@ HEADERS += \
     opencl_kernel.h \
     ace_analytic_simplerun.h \
     ace_analytic_serialrun.h \
+    ace_analytic_runthread.h \
     ace_analytic_openclrun.h \
     ace_analytic_openclrunthread.h \
     ace_analytic_cudarun.h \
     ace_analytic_cudarunthread.h \
+    ace_analytic_threadpoolrun.h \
+    ace_analytic_threadpoolrunthread.h \
     ace_analytic_single.h \
     openclxx.h \
     ace_settings.h \
@@ -114,6 +122,7 @@ HEADERS += \
     ace_analytic_mpislave.h \
     ace_analytic_chunk.h \
     ace_analytic_merge.h \
+    ace_analytic_mergethread.h \
     ace_analytic_abstractrun.h \
     ace_analytic_abstractinput.h \
     ace_analytic_abstractmanager.h \
@@ -121,6 +130,7 @@ HEADERS += \
     ace_logserver.h \
     elog.h \
     edebug.h \
+    etrace.h \
     cuda_buffer.h \
     cuda_common.h \
     cuda_context.h \
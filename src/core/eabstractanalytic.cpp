@@ -141,6 +141,58 @@ EAbstractAnalyticCUDA* EAbstractAnalytic::makeCUDA()
 
 
 
+/*!
+ * This interface tests if any node of an MPI run can make work blocks for this
+ * analytic from its own opened inputs. If true then the master node only sends
+ * ranges of block indexes to slave nodes, which make each work block themselves
+ * with the make work interface, instead of making and sending every work block.
+ * This must only return true if the make work interface depends on nothing but
+ * input set on every node and the initialize interface. The default
+ * implementation returns false.
+ *
+ * @return True if work blocks can be made by any node or false otherwise.
+ */
+bool EAbstractAnalytic::isLocalWork() const
+{
+   EDEBUG_FUNC(this);
+   return false;
+}
+
+
+
+
+
+
+/*!
+ * This interface combines the given next result block into the given result
+ * block, which is used to reduce result blocks in MPI runs before they are sent
+ * to the master node. The given result block covers one or more indexes
+ * starting with its own and the next result block covers the index directly
+ * after them. A combined result block is given to the process interface once in
+ * place of all the indexes it covers, so this must only be implemented if the
+ * results of this analytic can be reduced associatively. If this analytic does
+ * not reduce result blocks then this must return false, in which case it is
+ * not called again for the run. The default implementation returns false.
+ *
+ * @param result The result block that the next result block is combined into.
+ *
+ * @param next The result block that is combined into the given result block.
+ *
+ * @return True if the next result block was combined or false otherwise.
+ */
+bool EAbstractAnalytic::reduce(EAbstractAnalyticBlock* result, const EAbstractAnalyticBlock* next) const
+{
+   EDEBUG_FUNC(this,result,next);
+   Q_UNUSED(result)
+   Q_UNUSED(next)
+   return false;
+}
+
+
+
+
+
+
 /*!
  * This interface initializes this analytic. This is called only once before any
  * other interface is called for this analytic. The default implementation does
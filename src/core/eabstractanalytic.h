@@ -53,6 +53,8 @@ public:
    virtual std::unique_ptr<EAbstractAnalyticBlock> makeWork(int index) const;
    virtual std::unique_ptr<EAbstractAnalyticBlock> makeWork() const;
    virtual std::unique_ptr<EAbstractAnalyticBlock> makeResult() const;
+   virtual bool isLocalWork() const;
+   virtual bool reduce(EAbstractAnalyticBlock* result, const EAbstractAnalyticBlock* next) const;
    virtual EAbstractAnalyticSerial* makeSerial();
    virtual EAbstractAnalyticOpenCL* makeOpenCL();
    virtual EAbstractAnalyticCUDA* makeCUDA();
@@ -1,4 +1,6 @@
 #include "eabstractanalyticblock.h"
+#include <limits>
+#include <QtEndian>
 #include "edebug.h"
 
 
@@ -39,6 +41,24 @@ int EAbstractAnalyticBlock::extractIndex(const QByteArray& data)
 
 
 
+/*!
+ * Returns the size in bytes of the header every block byte array begins with,
+ * which contains the index and the format of the data following it. Special
+ * MPI codes may append additional data after this header.
+ *
+ * @return Size in bytes of a block byte array's header.
+ */
+int EAbstractAnalyticBlock::headerSize()
+{
+   EDEBUG_FUNC();
+   return sizeof(qint32)*2;
+}
+
+
+
+
+
+
 /*!
  * Constructs a new block with the given index.
  *
@@ -83,13 +103,33 @@ QByteArray EAbstractAnalyticBlock::toBytes() const
    // Add the debug header.
    EDEBUG_FUNC(this);
 
+   // If this block's implementation provides raw data then allocate the entire byte
+   // array once, writing the header and then having the implementation copy its
+   // data directly after it.
+   qint64 size {rawSize()};
+   if ( size >= 0 )
+   {
+      if ( size > std::numeric_limits<int>::max() - headerSize() )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("Write Error"));
+         e.setDetails(tr("Raw block data of %1 bytes is too large for a byte array.").arg(size));
+         throw e;
+      }
+      QByteArray ret(headerSize() + static_cast<int>(size),Qt::Uninitialized);
+      qToBigEndian<qint32>(_index,ret.data());
+      qToBigEndian<qint32>(_nativeRaw,ret.data() + sizeof(qint32));
+      writeRaw(ret.data() + headerSize());
+      return ret;
+   }
+
    // Create a new byte array and a data stream for writing to it.
    QByteArray ret;
    QDataStream stream(&ret,QIODevice::WriteOnly);
 
-   // Write this block's index and and then this block's data by calling the write
-   // interface.
-   stream << _index;
+   // Write this block's index and stream format and then this block's data by
+   // calling the write interface.
+   stream << static_cast<qint32>(_index) << static_cast<qint32>(Stream);
    write(stream);
 
    // Make sure all writing to the byte array was successful.
@@ -122,20 +162,53 @@ void EAbstractAnalyticBlock::fromBytes(const QByteArray& data)
    // Add the debug header.
    EDEBUG_FUNC(this,data);
 
-   // Create a data stream for reading the given byte array.
-   QDataStream stream(data);
-
-   // Read in this block's index and then its data by calling the read interface,
-   // making sure all reading was successful.
-   stream >> _index;
-   read(stream);
-   if ( stream.status() != QDataStream::Ok )
+   // Make sure the given byte array contains a full header.
+   if ( data.size() < headerSize() )
    {
       E_MAKE_EXCEPTION(e);
       e.setTitle(tr("Read Error"));
-      e.setDetails(tr("Failed reading index from byte array."));
+      e.setDetails(tr("Failed reading header from byte array."));
       throw e;
    }
+
+   // Read in this block's index and the format of its data from the header.
+   _index = qFromBigEndian<qint32>(data.constData());
+   qint32 format {qFromBigEndian<qint32>(data.constData() + sizeof(qint32))};
+
+   // Read in this block's data using the format given in the header. Raw data is
+   // given directly to the implementation and can only be read if it was written
+   // with this system's byte order.
+   switch (format)
+   {
+   case Stream:
+      {
+         // Create a data stream for reading the given byte array, skipping its header,
+         // and then read in this block's data by calling the read interface, making
+         // sure all reading was successful.
+         QDataStream stream(data);
+         stream.skipRawData(headerSize());
+         read(stream);
+         if ( stream.status() != QDataStream::Ok )
+         {
+            E_MAKE_EXCEPTION(e);
+            e.setTitle(tr("Read Error"));
+            e.setDetails(tr("Failed reading block data from byte array."));
+            throw e;
+         }
+      }
+      break;
+   case _nativeRaw:
+      readRaw(data.constData() + headerSize(),data.size() - headerSize());
+      break;
+   default:
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("Read Error"));
+         e.setDetails(tr("Byte array has unknown block format %1 or raw data with a different "
+                         "byte order.").arg(format));
+         throw e;
+      }
+   }
 }
 
 
@@ -174,3 +247,62 @@ void EAbstractAnalyticBlock::read(QDataStream& stream)
    Q_UNUSED(stream)
 }
 
+
+
+
+
+
+/*!
+ * This interface returns the size in bytes of this block's raw data or a
+ * negative value if this block does not support raw data. If this returns a
+ * non-negative value then the write raw and read raw interfaces are used
+ * instead of the qt data stream interfaces. The default implementation
+ * returns -1.
+ *
+ * @return Size in bytes of this block's raw data or a negative value if raw
+ *         data is not supported.
+ */
+qint64 EAbstractAnalyticBlock::rawSize() const
+{
+   EDEBUG_FUNC(this);
+   return -1;
+}
+
+
+
+
+
+
+/*!
+ * This interface writes out this block's implementation data as raw memory in
+ * native byte order to the given pointer, which has exactly the number of bytes
+ * returned by the raw size interface. The default implementation does nothing.
+ *
+ * @param data Pointer to the memory this block's raw data is written to.
+ */
+void EAbstractAnalyticBlock::writeRaw(char* data) const
+{
+   EDEBUG_FUNC(this,static_cast<const void*>(data));
+   Q_UNUSED(data)
+}
+
+
+
+
+
+
+/*!
+ * This interface reads in this block's implementation data from the given raw
+ * memory written by the write raw interface, overwriting any data it previously
+ * contained. The default implementation does nothing.
+ *
+ * @param data Pointer to the raw data that is read in.
+ *
+ * @param size The size in bytes of the raw data that is read in.
+ */
+void EAbstractAnalyticBlock::readRaw(const char* data, qint64 size)
+{
+   EDEBUG_FUNC(this,static_cast<const void*>(data),size);
+   Q_UNUSED(data)
+   Q_UNUSED(size)
+}
@@ -12,12 +12,19 @@
  * blocks for an analytic. This also handles the conversion to and from a byte
  * array so blocks can be communicated between different processes if MPI or
  * chunk running is used.
+ *
+ * An implementation can either write its data to a qt data stream or, if its
+ * data is plain contiguous memory, implement the raw interface so its byte array
+ * is made with a single allocation and copy in native byte order. The raw
+ * interface is optional and the qt data stream is used if it is not
+ * implemented.
  */
 class EAbstractAnalyticBlock : public QObject
 {
    Q_OBJECT
 public:
    static int extractIndex(const QByteArray& data);
+   static int headerSize();
 public:
    /*!
     * Constructs an uninitialized block. This is used in MPI and chunk runs to load
@@ -33,6 +40,35 @@ public:
 protected:
    virtual void write(QDataStream& stream) const;
    virtual void read(QDataStream& stream);
+   virtual qint64 rawSize() const;
+   virtual void writeRaw(char* data) const;
+   virtual void readRaw(const char* data, qint64 size);
+private:
+   /*!
+    * Defines the formats a block's data can be stored in within its byte array,
+    * which is saved in the header following the index.
+    */
+   enum Format
+   {
+      /*!
+       * The data is written with a qt data stream using the write interface.
+       */
+      Stream = 0
+      /*!
+       * The data is raw memory written by the write raw interface in little endian
+       * byte order.
+       */
+      ,RawLittleEndian = 1
+      /*!
+       * The data is raw memory written by the write raw interface in big endian byte
+       * order.
+       */
+      ,RawBigEndian = 2
+   };
+   /*!
+    * The raw format used by this system's native byte order.
+    */
+   constexpr static qint32 _nativeRaw {Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? RawLittleEndian : RawBigEndian};
 private:
    friend EDebug& operator<<(EDebug&, const EAbstractAnalyticBlock*const);
 private:
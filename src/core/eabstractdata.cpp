@@ -136,3 +136,41 @@ void EAbstractData::allocate(qint64 size)
    qobject_cast<Ace::DataObject*>(parent())->allocate(size);
 }
 
+
+
+
+
+
+/*!
+ * Tests if this data object's data section is memory mapped, allowing read only
+ * spans of it to be accessed directly.
+ *
+ * @return True if this data object is memory mapped or false otherwise.
+ */
+bool EAbstractData::isMapped() const
+{
+   EDEBUG_FUNC(this);
+   return qobject_cast<Ace::DataObject*>(parent())->isMapped();
+}
+
+
+
+
+
+
+/*!
+ * Returns a read only pointer to the given region of this data object's memory
+ * mapped data section. If this data object is not memory mapped or the region
+ * extends past the data end of this data object then an exception is thrown.
+ *
+ * @param index The index of the first byte of the region.
+ *
+ * @param size The size in bytes of the region.
+ *
+ * @return Read only pointer to the given region of this data object's data.
+ */
+const char* EAbstractData::span(qint64 index, qint64 size) const
+{
+   EDEBUG_FUNC(this,index,size);
+   return qobject_cast<Ace::DataObject*>(parent())->span(index,size);
+}
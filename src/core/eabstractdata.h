@@ -61,6 +61,8 @@ protected:
    EDataStream& stream();
    void seek(qint64 index) const;
    void allocate(qint64 size);
+   bool isMapped() const;
+   const char* span(qint64 index, qint64 size) const;
 };
 
 
@@ -559,3 +559,23 @@ EDataStream::EDataStream(Ace::DataObject* parent)
    EDEBUG_FUNC(this,parent)
 }
 
+
+
+
+
+
+/*!
+ * Sets the byte order all values are stored in within this data stream's data
+ * object, switching this data stream from the legacy format. Values, including
+ * floating point ones, are byte swapped if the given order differs from the
+ * local machine's.
+ *
+ * @param order The byte order values are stored in.
+ */
+void EDataStream::setByteOrder(QSysInfo::Endian order)
+{
+   EDEBUG_FUNC(this,static_cast<int>(order))
+
+   _swap = order != QSysInfo::ByteOrder;
+   _swapFloats = _swap;
+}
@@ -2,6 +2,9 @@
 #define EDATASTREAM_H
 #include <QtCore>
 #include <memory>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
 #include "edatastream_ext.h"
 #include "ace_dataobject.h"
 #include "ace.h"
@@ -11,13 +14,19 @@
 
 /*!
  * This provides a C++ style stream for input and output of a data object. This
- * also provides endian compatibility for cross platform loading. All data
- * written by this data stream is in beg endian and all reading is switched back
- * to little endian if the local machine is little endian. If the local machine
- * is big endian then no switching of bits is done. Therefore means data object
- * files are always big endian, also called network endian. This class handles
- * all read operations from the data object as constant to keep in line with the
- * constant paradigm used in data objects and ACE in general.
+ * also provides endian compatibility for cross platform loading. By default this
+ * data stream uses the legacy format, where all integers are written in big
+ * endian and switched back to little endian when read if the local machine is
+ * little endian, and floating point values are never switched. This is always
+ * the format of a data object's header. Once a byte order is set, all values,
+ * including floating point ones, are stored in that byte order and only switched
+ * if it differs from the local machine's. This class handles all read operations
+ * from the data object as constant to keep in line with the constant paradigm
+ * used in data objects and ACE in general.
+ *
+ * Arrays of numeric values can be read and written in bulk with a single call
+ * to the data object, which is much faster than streaming each value
+ * separately.
  */
 class EDataStream : public QObject
 {
@@ -67,7 +76,18 @@ public:
    EDataStream& operator<<(const QByteArray& value);
 public:
    explicit EDataStream(Ace::DataObject* parent);
+   void setByteOrder(QSysInfo::Endian order);
+   template<class T> const EDataStream& readArray(T* data, qint64 size) const;
+   template<class T> EDataStream& writeArray(const T* data, qint64 size);
 private:
+   /*!
+    * The maximum number of bytes of swapped values written out at once by the
+    * write array method when values must be byte swapped.
+    */
+   constexpr static qint64 _swapBufferSize {65536};
+   template<class T> static T flip(T value);
+   template<class T> bool isSwapped() const;
+   template<class T> void swap(T* data, qint64 size) const;
    template<class T> const EDataStream& read(T& value) const;
    template<class T> EDataStream& write(T value);
    /*!
@@ -75,6 +95,16 @@ private:
     * streaming.
     */
    Ace::DataObject* _parent;
+   /*!
+    * True if integer values are byte swapped between the local machine and the
+    * data object or false otherwise.
+    */
+   bool _swap {QSysInfo::ByteOrder != QSysInfo::BigEndian};
+   /*!
+    * True if floating point values are byte swapped between the local machine and
+    * the data object or false otherwise.
+    */
+   bool _swapFloats {false};
 };
 
 
@@ -82,6 +112,154 @@ private:
 
 
 
+/*!
+ * Reads in the given number of values from this data stream into the given
+ * array with a single read of the data object, byte swapping all values at once
+ * afterwards if required.
+ *
+ * @tparam T Data type of the values that are read in from this data stream.
+ *
+ * @param data Pointer to the array the values are read into, which must hold
+ *             at least the given number of values.
+ *
+ * @param size The number of values read in.
+ *
+ * @return Read only reference to this data stream.
+ */
+template<class T> const EDataStream& EDataStream::readArray(T* data, qint64 size) const
+{
+   EDEBUG_FUNC(this,static_cast<void*>(data),size)
+
+   // Read in all values with a single read and then flip their bytes if required.
+   static_assert(std::is_arithmetic<T>::value,"Arrays can only contain numeric values.");
+   _parent->read(reinterpret_cast<char*>(data),size*static_cast<qint64>(sizeof(T)));
+   swap(data,size);
+
+   // Return a reference to this data stream.
+   return *this;
+}
+
+
+
+
+
+
+/*!
+ * Writes out the given number of values from the given array to this data
+ * stream. If the values do not need byte swapping they are written with a single
+ * write to the data object, else they are swapped into a buffer and written out
+ * in large pieces.
+ *
+ * @tparam T Data type of the values that are written to this data stream.
+ *
+ * @param data Pointer to the array of values that are written out.
+ *
+ * @param size The number of values written out.
+ *
+ * @return Reference to this data stream.
+ */
+template<class T> EDataStream& EDataStream::writeArray(const T* data, qint64 size)
+{
+   EDEBUG_FUNC(this,static_cast<const void*>(data),size)
+
+   // If the values are not byte swapped then write them all out at once and return.
+   static_assert(std::is_arithmetic<T>::value,"Arrays can only contain numeric values.");
+   if ( !isSwapped<T>() )
+   {
+      _parent->write(reinterpret_cast<const char*>(data),size*static_cast<qint64>(sizeof(T)));
+      return *this;
+   }
+
+   // Copy the values into a buffer one piece at a time, flipping their bytes and
+   // writing each piece out.
+   constexpr qint64 pieceSize {_swapBufferSize/static_cast<qint64>(sizeof(T))};
+   std::unique_ptr<T[]> buffer(new T[static_cast<size_t>(qMin(size,pieceSize))]);
+   for (qint64 i = 0; i < size ;i += pieceSize)
+   {
+      qint64 count {qMin(size - i,pieceSize)};
+      std::copy(data + i,data + i + count,buffer.get());
+      swap(buffer.get(),count);
+      _parent->write(reinterpret_cast<const char*>(buffer.get()),count*static_cast<qint64>(sizeof(T)));
+   }
+
+   // Return a reference to this data stream.
+   return *this;
+}
+
+
+
+
+
+
+/*!
+ * Returns the given value with its bytes in reverse order. This works for
+ * floating point values as well as integers.
+ *
+ * @tparam T Data type of the given value.
+ *
+ * @param value The value whose bytes are reversed.
+ *
+ * @return Value with reversed bytes.
+ */
+template<class T> T EDataStream::flip(T value)
+{
+   typename QIntegerForSizeof<T>::Unsigned bits;
+   memcpy(&bits,&value,sizeof(T));
+   bits = qbswap(bits);
+   memcpy(&value,&bits,sizeof(T));
+   return value;
+}
+
+
+
+
+
+
+/*!
+ * Tests if values of the given type are byte swapped between this system and
+ * this data stream's data object. Single byte values are never swapped.
+ *
+ * @tparam T Data type that is tested.
+ *
+ * @return True if values of the given type are byte swapped or false otherwise.
+ */
+template<class T> bool EDataStream::isSwapped() const
+{
+   return sizeof(T) > 1 && (std::is_floating_point<T>::value ? _swapFloats : _swap);
+}
+
+
+
+
+
+
+/*!
+ * Flips the bytes of all values in the given array in place if values of its
+ * type are byte swapped. This is a simple loop over contiguous memory so the
+ * compiler vectorizes it.
+ *
+ * @tparam T Data type of the values in the given array.
+ *
+ * @param data Pointer to the array of values that are flipped.
+ *
+ * @param size The number of values in the given array.
+ */
+template<class T> void EDataStream::swap(T* data, qint64 size) const
+{
+   if ( isSwapped<T>() )
+   {
+      for (qint64 i = 0; i < size ;++i)
+      {
+         data[i] = flip(data[i]);
+      }
+   }
+}
+
+
+
+
+
+
 /*!
  * Reads in data from this data stream setting the given value to the data read
  * in.
@@ -100,7 +278,10 @@ template<class T> const EDataStream& EDataStream::read(T& value) const
    // Read in the given value from this data stream, flipping the bytes of the read
    // in value if required.
    _parent->read(reinterpret_cast<char*>(&value),sizeof(T));
-   value = qFromBigEndian(value);
+   if ( isSwapped<T>() )
+   {
+      value = flip(value);
+   }
 
    // Return a reference to this data stream.
    return *this;
@@ -126,7 +307,10 @@ template<class T> EDataStream& EDataStream::write(T value)
 
    // Write out the given value to the data stream, flipping the bytes before writing
    // if required.
-   value = qToBigEndian(value);
+   if ( isSwapped<T>() )
+   {
+      value = flip(value);
+   }
    _parent->write(reinterpret_cast<char*>(&value),sizeof(T));
 
    // Return a reference to this data stream.
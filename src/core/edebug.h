@@ -5,15 +5,14 @@
 #include <QVector>
 #include "eabstractanalytic.h"
 #include "ace_analytic_abstractmpi.h"
-#ifdef QT_DEBUG
-#ifdef EDEBUG
+#include "etrace.h"
+#if defined(ETRACE)
+#define EDEBUG_FUNC(...) static const int etraceSite {ETrace::site(__PRETTY_FUNCTION__,#__VA_ARGS__)}; ETrace etrace(etraceSite); etrace.setArguments(__VA_ARGS__);
+#elif defined(QT_DEBUG) && defined(EDEBUG)
 #define EDEBUG_FUNC(...) EDebug debug(__PRETTY_FUNCTION__,#__VA_ARGS__); debug.setArguments(__VA_ARGS__);
 #else
 #define EDEBUG_FUNC(...)
 #endif
-#else
-#define EDEBUG_FUNC(...)
-#endif
 
 
 
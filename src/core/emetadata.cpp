@@ -2,6 +2,10 @@
 #include <QString>
 #include <QByteArray>
 #include <QJsonDocument>
+#include <QMutex>
+#include <QtEndian>
+#include <cstring>
+#include <memory>
 #include "eexception.h"
 #include "emetaarray.h"
 #include "emetaobject.h"
@@ -13,7 +17,8 @@
 
 
 /*!
- * Set this object's data as a copy of the supplied metadata object.
+ * Set this object's data as a copy of the supplied metadata object. The data
+ * is shared with the supplied object until either one is modified.
  *
  * @param object The metadata object that is copied.
  *
@@ -24,15 +29,9 @@ EMetadata& EMetadata::operator=(const EMetadata& object)
    // Add the debug header.
    EDEBUG_FUNC(this,&object);
 
-   // Delete any data this object contains.
-   clear();
-
-   // Copy the type and data of the supplied metadata object.
-   _type = object._type;
-   create();
-   copy(object._data);
-
-   // Return reference to this object.
+   // Share the data of the supplied metadata object and return reference to this
+   // object.
+   _d = object._d;
    return *this;
 }
 
@@ -53,16 +52,9 @@ EMetadata& EMetadata::operator=(EMetadata&& object)
    // Add the debug header.
    EDEBUG_FUNC(this,&object);
 
-   // Delete any data this object contains.
-   clear();
-
-   // Copy the type and data pointer of the supplied metadata object.
-   _type = object._type;
-   _data = object._data;
-
-   // Set the supplied metadata object to Null.
-   object._type = Null;
-   object._data = nullptr;
+   // Take the data of the supplied metadata object, setting it to Null.
+   _d.swap(object._d);
+   object._d = nullptr;
 
    // Return reference to this object.
    return *this;
@@ -80,10 +72,9 @@ EMetadata& EMetadata::operator=(EMetadata&& object)
  */
 EMetadata::EMetadata(Type type)
    :
-   _type(type)
+   _d(type != Null ? new Data(type) : nullptr)
 {
    EDEBUG_FUNC(this,type);
-   create();
 }
 
 
@@ -257,20 +248,16 @@ EMetadata::EMetadata(const QJsonValue& value)
 
 
 /*!
- * This creates a new metadata object that is a direct copy of the one supplied.
+ * This creates a new metadata object that is a copy of the one supplied. The
+ * data is shared with the supplied object until either one is modified.
  *
  * @param object The metadata object that is copied.
  */
 EMetadata::EMetadata(const EMetadata& object)
    :
-   _type(object._type)
+   _d(object._d)
 {
-   // Add the debug header.
    EDEBUG_FUNC(this,&object);
-
-   // Copy the type and data of the supplied metadata object.
-   create();
-   copy(object._data);
 }
 
 
@@ -286,15 +273,9 @@ EMetadata::EMetadata(const EMetadata& object)
  */
 EMetadata::EMetadata(EMetadata&& object)
    :
-   _type(object._type),
-   _data(object._data)
+   _d(std::move(object._d))
 {
-   // Add the debug header.
    EDEBUG_FUNC(this,&object);
-
-   // Set the supplied metadata object to Null.
-   object._type = Null;
-   object._data = nullptr;
 }
 
 
@@ -303,12 +284,11 @@ EMetadata::EMetadata(EMetadata&& object)
 
 
 /*!
- * Deletes any data this object may contain.
+ * Releases this object's data, deleting it if no other object shares it.
  */
 EMetadata::~EMetadata()
 {
    EDEBUG_FUNC(this);
-   clear();
 }
 
 
@@ -329,7 +309,7 @@ QJsonValue EMetadata::toJson() const
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   switch (_type)
+   switch (type())
    {
    // If this metadata is a boolean, double, or string then return the JSON value of
    // this metadata object, else go to the next step.
@@ -346,7 +326,7 @@ QJsonValue EMetadata::toJson() const
    case Array:
       {
          QJsonArray ret;
-         for (auto value: toArray())
+         for (const auto& value: toArray())
          {
             ret.append(value.toJson());
          }
@@ -378,6 +358,29 @@ QJsonValue EMetadata::toJson() const
 
 
 
+/*!
+ * Returns the compact encoding of this metadata, which can be decoded back into
+ * metadata with the decode method. Any array or object that has not been
+ * modified since it was decoded has its encoded bytes copied directly.
+ *
+ * @return Compact encoding of this metadata.
+ */
+QByteArray EMetadata::encode() const
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // Encode this metadata into a new byte array and return it.
+   QByteArray ret;
+   encode(ret,*this);
+   return ret;
+}
+
+
+
+
+
+
 /*!
  * Returns the type for this metadata.
  *
@@ -386,7 +389,7 @@ QJsonValue EMetadata::toJson() const
 EMetadata::Type EMetadata::type() const
 {
    EDEBUG_FUNC(this);
-   return _type;
+   return _d ? _d->_type : Null;
 }
 
 
@@ -402,7 +405,7 @@ EMetadata::Type EMetadata::type() const
 bool EMetadata::isNull() const
 {
    EDEBUG_FUNC(this);
-   return _type == Null;
+   return type() == Null;
 }
 
 
@@ -418,7 +421,7 @@ bool EMetadata::isNull() const
 bool EMetadata::isBool() const
 {
    EDEBUG_FUNC(this);
-   return _type == Bool;
+   return type() == Bool;
 }
 
 
@@ -434,7 +437,7 @@ bool EMetadata::isBool() const
 bool EMetadata::isDouble() const
 {
    EDEBUG_FUNC(this);
-   return _type == Double;
+   return type() == Double;
 }
 
 
@@ -450,7 +453,7 @@ bool EMetadata::isDouble() const
 bool EMetadata::isString() const
 {
    EDEBUG_FUNC(this);
-   return _type == String;
+   return type() == String;
 }
 
 
@@ -466,7 +469,7 @@ bool EMetadata::isString() const
 bool EMetadata::isBytes() const
 {
    EDEBUG_FUNC(this);
-   return _type == Bytes;
+   return type() == Bytes;
 }
 
 
@@ -482,7 +485,7 @@ bool EMetadata::isBytes() const
 bool EMetadata::isArray() const
 {
    EDEBUG_FUNC(this);
-   return _type == Array;
+   return type() == Array;
 }
 
 
@@ -498,7 +501,7 @@ bool EMetadata::isArray() const
 bool EMetadata::isObject() const
 {
    EDEBUG_FUNC(this);
-   return _type == Object;
+   return type() == Object;
 }
 
 
@@ -519,7 +522,7 @@ const bool& EMetadata::toBool() const
 
    // Make sure this metadata is boolean data and return it.
    checkType(Bool);
-   return *static_cast<bool*>(_data);
+   return *static_cast<const bool*>(_d->_data);
 }
 
 
@@ -540,7 +543,7 @@ const double& EMetadata::toDouble() const
 
    // Make sure this metadata is floating point data and return it.
    checkType(Double);
-   return *static_cast<double*>(_data);
+   return *static_cast<const double*>(_d->_data);
 }
 
 
@@ -561,7 +564,7 @@ const QString& EMetadata::toString() const
 
    // Make sure this metadata is string data and return it.
    checkType(String);
-   return *static_cast<QString*>(_data);
+   return *static_cast<const QString*>(_d->_data);
 }
 
 
@@ -582,7 +585,7 @@ const QByteArray& EMetadata::toBytes() const
 
    // Make sure this metadata is byte array data and return it.
    checkType(Bytes);
-   return *static_cast<QByteArray*>(_data);
+   return *static_cast<const QByteArray*>(_d->_data);
 }
 
 
@@ -592,7 +595,8 @@ const QByteArray& EMetadata::toBytes() const
 
 /*!
  * Returns a read only reference to this object's data cast as a meta array. If
- * This metadata is not an array type then an exception is thrown.
+ * This metadata is not an array type then an exception is thrown. If this
+ * metadata has not been decoded yet then it is decoded first.
  *
  * @return Read only reference to this object's meta array.
  */
@@ -601,9 +605,11 @@ const EMetaArray& EMetadata::toArray() const
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   // Make sure this metadata is meta array data and return it.
+   // Make sure this metadata is meta array data, decoding it if it has not been yet,
+   // and return it.
    checkType(Array);
-   return *static_cast<EMetaArray*>(_data);
+   decodeData();
+   return *static_cast<const EMetaArray*>(_d->_data);
 }
 
 
@@ -613,7 +619,8 @@ const EMetaArray& EMetadata::toArray() const
 
 /*!
  * Returns a read only reference to this object's data cast as a meta object. If
- * This metadata is not an object type then an exception is thrown.
+ * This metadata is not an object type then an exception is thrown. If this
+ * metadata has not been decoded yet then it is decoded first.
  *
  * @return Read only reference to this object's meta object.
  */
@@ -622,9 +629,11 @@ const EMetaObject& EMetadata::toObject() const
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   // Make sure this metadata is meta object data and return it.
+   // Make sure this metadata is meta object data, decoding it if it has not been yet,
+   // and return it.
    checkType(Object);
-   return *static_cast<EMetaObject*>(_data);
+   decodeData();
+   return *static_cast<const EMetaObject*>(_d->_data);
 }
 
 
@@ -635,6 +644,7 @@ const EMetaObject& EMetadata::toObject() const
 /*!
  * Returns a reference to this object's data cast as a boolean. If This metadata
  * is not a boolean type then an exception is thrown.
+ * This object's data is first copied if it is shared with another object.
  *
  * @return Reference to this object's boolean data.
  */
@@ -645,7 +655,7 @@ bool& EMetadata::toBool()
 
    // Make sure this metadata is boolean data and return it.
    checkType(Bool);
-   return *static_cast<bool*>(_data);
+   return *static_cast<bool*>(_d->_data);
 }
 
 
@@ -656,6 +666,7 @@ bool& EMetadata::toBool()
 /*!
  * Returns a reference to this object's data cast as a double. If This metadata
  * is not a double type then an exception is thrown.
+ * This object's data is first copied if it is shared with another object.
  *
  * @return Reference to this object's double data.
  */
@@ -666,7 +677,7 @@ double& EMetadata::toDouble()
 
    // Make sure this metadata is floating point data and return it.
    checkType(Double);
-   return *static_cast<double*>(_data);
+   return *static_cast<double*>(_d->_data);
 }
 
 
@@ -677,6 +688,7 @@ double& EMetadata::toDouble()
 /*!
  * Returns a reference to this object's data cast as a string. If This metadata
  * is not a string type then an exception is thrown.
+ * This object's data is first copied if it is shared with another object.
  *
  * @return Reference to this object's string data.
  */
@@ -687,7 +699,7 @@ QString& EMetadata::toString()
 
    // Make sure this metadata is string data and return it.
    checkType(String);
-   return *static_cast<QString*>(_data);
+   return *static_cast<QString*>(_d->_data);
 }
 
 
@@ -698,6 +710,7 @@ QString& EMetadata::toString()
 /*!
  * Returns a reference to this object's data cast as a byte array. If This
  * metadata is not a byte type then an exception is thrown.
+ * This object's data is first copied if it is shared with another object.
  *
  * @return Reference to this object's byte array data.
  */
@@ -708,7 +721,7 @@ QByteArray& EMetadata::toBytes()
 
    // Make sure this metadata is byte array data and return it.
    checkType(Bytes);
-   return *static_cast<QByteArray*>(_data);
+   return *static_cast<QByteArray*>(_d->_data);
 }
 
 
@@ -719,6 +732,8 @@ QByteArray& EMetadata::toBytes()
 /*!
  * Returns a reference to this object's data cast as a meta array. If This
  * metadata is not an array type then an exception is thrown.
+ * This object's data is first copied if it is shared with another object and
+ * decoded if it has not been yet.
  *
  * @return Reference to this object's meta array.
  */
@@ -727,9 +742,11 @@ EMetaArray& EMetadata::toArray()
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   // Make sure this metadata is meta array data and return it.
+   // Make sure this metadata is meta array data, preparing it to be modified, and
+   // return it.
    checkType(Array);
-   return *static_cast<EMetaArray*>(_data);
+   modifyData();
+   return *static_cast<EMetaArray*>(_d->_data);
 }
 
 
@@ -740,6 +757,8 @@ EMetaArray& EMetadata::toArray()
 /*!
  * Returns a reference to this object's data cast as a meta object. If This
  * metadata is not an object type then an exception is thrown.
+ * This object's data is first copied if it is shared with another object and
+ * decoded if it has not been yet.
  *
  * @return Reference to this object's meta object.
  */
@@ -748,9 +767,11 @@ EMetaObject& EMetadata::toObject()
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   // Make sure this metadata is meta object data and return it.
+   // Make sure this metadata is meta object data, preparing it to be modified, and
+   // return it.
    checkType(Object);
-   return *static_cast<EMetaObject*>(_data);
+   modifyData();
+   return *static_cast<EMetaObject*>(_d->_data);
 }
 
 
@@ -791,6 +812,41 @@ QString EMetadata::typeName(Type type)
 
 
 
+/*!
+ * Decodes the given compact encoding of metadata made by the encode method,
+ * returning the metadata. Only the top level of the encoded metadata is
+ * decoded, any array or object within it being decoded the first time it is
+ * accessed. If the given bytes are not a valid encoding then an exception is
+ * thrown.
+ *
+ * @param bytes The compact encoding of metadata that is decoded.
+ *
+ * @return Decoded metadata of the given bytes.
+ */
+EMetadata EMetadata::decode(const QByteArray& bytes)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(bytes);
+
+   // Decode the metadata at the beginning of the given bytes. If it does not end
+   // exactly at the end of the given bytes then throw an exception, else return it.
+   int offset {0};
+   EMetadata ret {decode(bytes,offset)};
+   if ( offset != bytes.size() )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Read Error"));
+      e.setDetails(QObject::tr("Could not decode metadata because its encoding is corrupt."));
+      throw e;
+   }
+   return ret;
+}
+
+
+
+
+
+
 /*!
  * Makes sure given type matches the type this object contains. If it does not
  * match an exception is thrown saying so.
@@ -804,14 +860,14 @@ void EMetadata::checkType(Type type) const
 
    // If the given type does not match with this object's type then throw an
    // exception, else return from operation.
-   if ( _type != type )
+   if ( this->type() != type )
    {
       E_MAKE_EXCEPTION(e);
       e.setTitle(QObject::tr("Logical Error"));
       e.setDetails(
                QObject::tr("Cannot convert metadata to %1 type when it is %2 type.")
                .arg(typeName(type))
-               .arg(typeName(_type)));
+               .arg(typeName(this->type())));
       throw e;
    }
 }
@@ -822,34 +878,483 @@ void EMetadata::checkType(Type type) const
 
 
 /*!
- * Deletes this object's data. Does not alter the type or data pointer of the
- * object.
+ * Reads in a little endian integer from the given compact encoding at the given
+ * offset, moving the offset past it. If the given bytes end before the integer
+ * does then an exception is thrown.
+ *
+ * @tparam T The integer type that is read.
+ *
+ * @param bytes The compact encoding the integer is read from.
+ *
+ * @param offset The offset within the given bytes where the integer begins,
+ *               which is moved past its end.
+ *
+ * @return The integer that was read.
  */
-void EMetadata::clear()
+template<class T> T EMetadata::read(const QByteArray& bytes, int& offset)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(&bytes,offset);
+
+   // If the given bytes end before the integer does then throw an exception.
+   if ( offset < 0 || bytes.size() - offset < static_cast<int>(sizeof(T)) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Read Error"));
+      e.setDetails(QObject::tr("Could not decode metadata because its encoding is corrupt."));
+      throw e;
+   }
+
+   // Read in the integer, move the offset past it, and return it.
+   T ret {qFromLittleEndian<T>(reinterpret_cast<const uchar*>(bytes.constData() + offset))};
+   offset += sizeof(T);
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * Appends the given integer to the given compact encoding as little endian.
+ *
+ * @tparam T The integer type that is written.
+ *
+ * @param bytes The compact encoding the integer is appended to.
+ *
+ * @param value The integer that is appended.
+ */
+template<class T> void EMetadata::write(QByteArray& bytes, T value)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(&bytes,value);
+
+   // Append the given integer to the given bytes as little endian.
+   uchar buffer[sizeof(T)];
+   qToLittleEndian<T>(value,buffer);
+   bytes.append(reinterpret_cast<const char*>(buffer),sizeof(T));
+}
+
+
+
+
+
+
+/*!
+ * Decodes this array or object from its encoded bytes if it has not been
+ * decoded yet. Its children that are arrays or objects are left encoded. This
+ * does not change the value of this metadata, so it is done even though this
+ * method is constant. Decoding is guarded by a mutex so metadata shared between
+ * threads can be read by any of them. If the encoded bytes are corrupt then an
+ * exception is thrown.
+ */
+void EMetadata::decodeData() const
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this);
+
+   // If this metadata is already decoded then do nothing, else lock the decode mutex
+   // and check again in case another thread decoded it.
+   static QMutex mutex;
+   Data* data {const_cast<Data*>(_d.constData())};
+   if ( data->_decoded.loadAcquire() )
+   {
+      return;
+   }
+   QMutexLocker locker(&mutex);
+   if ( data->_decoded.load() )
+   {
+      return;
+   }
+
+   // Read in the length prefix and number of children of this array or object,
+   // determining where its body begins.
+   const QByteArray& bytes {data->_encoded};
+   int offset {data->_offset};
+   int size {readSize(bytes,offset)};
+   int body {offset};
+   quint32 count {read<quint32>(bytes,offset)};
+
+   // If this is an array then decode each child in order, appending it to a new meta
+   // array, and set this data to it.
+   if ( data->_type == Array )
+   {
+      std::unique_ptr<EMetaArray> array {new EMetaArray};
+      for (quint32 i = 0; i < count ;++i)
+      {
+         array->append(decode(bytes,offset));
+      }
+      data->_data = array.release();
+   }
+
+   // Else this is an object so decode each key and child at the offset given by the
+   // object's offset table, inserting them into a new meta object, and set this data
+   // to it. If any offset is outside of the object's body then throw an exception.
+   else
+   {
+      std::unique_ptr<EMetaObject> object {new EMetaObject};
+      for (quint32 i = 0; i < count ;++i)
+      {
+         quint32 position {read<quint32>(bytes,offset)};
+         if ( position >= static_cast<quint32>(size) )
+         {
+            E_MAKE_EXCEPTION(e);
+            e.setTitle(QObject::tr("Read Error"));
+            e.setDetails(QObject::tr("Could not decode metadata because its encoding is corrupt."));
+            throw e;
+         }
+         int entry {body + static_cast<int>(position)};
+         int keySize {readSize(bytes,entry)};
+         QString key {QString::fromUtf8(bytes.constData() + entry,keySize)};
+         entry += keySize;
+         object->insert(key,decode(bytes,entry));
+      }
+      data->_data = object.release();
+   }
+
+   // Mark this data as decoded, publishing its data pointer to other threads.
+   data->_decoded.storeRelease(1);
+}
+
+
+
+
+
+
+/*!
+ * Prepares this array or object to be modified. Its data is first copied if it
+ * is shared with another object and decoded if it has not been yet. Its encoded
+ * bytes are then released because they no longer match its value.
+ */
+void EMetadata::modifyData()
 {
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   // Delete the underlying data the data pointer points to, if any.
+   // Detach this object's data, decode it, and release its encoded bytes.
+   _d.detach();
+   decodeData();
+   _d->_encoded.clear();
+}
+
+
+
+
+
+
+/*!
+ * Appends the compact encoding of the given metadata to the given bytes. Every
+ * encoded value begins with its type. Booleans and doubles follow with their
+ * value, and strings and byte arrays follow with their size and then their
+ * UTF-8 or raw bytes. Arrays and objects follow with a length prefix giving the
+ * size of their body, which begins with their number of children. An array's
+ * body then has each child in order. An object's body then has an offset table
+ * giving the position of each key within its body, followed by each key and
+ * its child in key order. All integers are little endian. If an array or object
+ * still has the encoded bytes it was decoded from then they are copied
+ * directly.
+ *
+ * @param bytes The bytes the encoding is appended to.
+ *
+ * @param meta The metadata that is encoded.
+ */
+void EMetadata::encode(QByteArray& bytes, const EMetadata& meta)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(&bytes,&meta);
+
+   // Write out the type of the given metadata.
+   write<quint8>(bytes,static_cast<quint8>(meta.type()));
+
+   // Determine which type the given metadata is and write out its value.
+   switch (meta.type())
+   {
+   case Bool:
+      write<quint8>(bytes,meta.toBool());
+      break;
+   case Double:
+      {
+         quint64 value;
+         std::memcpy(&value,&meta.toDouble(),sizeof(value));
+         write<quint64>(bytes,value);
+         break;
+      }
+   case String:
+      {
+         const QByteArray value {meta.toString().toUtf8()};
+         write<quint32>(bytes,static_cast<quint32>(value.size()));
+         bytes.append(value);
+         break;
+      }
+   case Bytes:
+      write<quint32>(bytes,static_cast<quint32>(meta.toBytes().size()));
+      bytes.append(meta.toBytes());
+      break;
+   case Array:
+   case Object:
+      {
+         // If the given array or object still has its encoded bytes then copy its length
+         // prefix and body directly and go to the next step.
+         const Data* data {meta._d.constData()};
+         if ( !data->_encoded.isNull() )
+         {
+            int offset {data->_offset};
+            int size {readSize(data->_encoded,offset)};
+            bytes.append(data->_encoded.constData() + data->_offset,offset - data->_offset + size);
+            break;
+         }
+
+         // Write out a placeholder length prefix and the number of children.
+         int prefix {bytes.size()};
+         write<quint32>(bytes,0);
+         int body {bytes.size()};
+         if ( meta.type() == Array )
+         {
+            // Write out each child of the array in order.
+            write<quint32>(bytes,static_cast<quint32>(meta.toArray().size()));
+            for (const auto& child: meta.toArray())
+            {
+               encode(bytes,child);
+            }
+         }
+         else
+         {
+            // Write out a blank offset table and then each key and child of the object,
+            // setting the offset table entry of each key to its position in the body.
+            const EMetaObject& object {meta.toObject()};
+            write<quint32>(bytes,static_cast<quint32>(object.size()));
+            int table {bytes.size()};
+            bytes.resize(table + object.size()*static_cast<int>(sizeof(quint32)));
+            for (auto i = object.begin(); i != object.end() ;++i)
+            {
+               qToLittleEndian<quint32>(static_cast<quint32>(bytes.size() - body),reinterpret_cast<uchar*>(bytes.data() + table));
+               table += sizeof(quint32);
+               const QByteArray key {i.key().toUtf8()};
+               write<quint32>(bytes,static_cast<quint32>(key.size()));
+               bytes.append(key);
+               encode(bytes,*i);
+            }
+         }
+
+         // Overwrite the placeholder length prefix with the size of the body.
+         qToLittleEndian<quint32>(static_cast<quint32>(bytes.size() - body),reinterpret_cast<uchar*>(bytes.data() + prefix));
+         break;
+      }
+   default: break;
+   }
+}
+
+
+
+
+
+
+/*!
+ * Decodes the metadata at the given offset of the given compact encoding,
+ * moving the offset past it. Arrays and objects are not decoded, instead
+ * keeping a reference to the given bytes so they are decoded the first time
+ * they are accessed. If the given bytes are corrupt then an exception is
+ * thrown.
+ *
+ * @param bytes The compact encoding of metadata that is decoded.
+ *
+ * @param offset The offset within the given bytes where the metadata begins,
+ *               which is moved past its end.
+ *
+ * @return Decoded metadata at the given offset.
+ */
+EMetadata EMetadata::decode(const QByteArray& bytes, int& offset)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(&bytes,offset);
+
+   // Read in the type of the metadata and then read in its value based off its type,
+   // returning the metadata. If the type is not valid then throw an exception.
+   quint8 type {read<quint8>(bytes,offset)};
+   switch (type)
+   {
+   case Null:
+      return EMetadata();
+   case Bool:
+      {
+         EMetadata ret(Bool);
+         ret.toBool() = read<quint8>(bytes,offset);
+         return ret;
+      }
+   case Double:
+      {
+         EMetadata ret(Double);
+         quint64 value {read<quint64>(bytes,offset)};
+         std::memcpy(&ret.toDouble(),&value,sizeof(value));
+         return ret;
+      }
+   case String:
+      {
+         int size {readSize(bytes,offset)};
+         EMetadata ret(QString::fromUtf8(bytes.constData() + offset,size));
+         offset += size;
+         return ret;
+      }
+   case Bytes:
+      {
+         int size {readSize(bytes,offset)};
+         EMetadata ret(bytes.mid(offset,size));
+         offset += size;
+         return ret;
+      }
+   case Array:
+   case Object:
+      {
+         // Make new metadata that references the encoded bytes of this array or object
+         // and skip past its body using its length prefix.
+         EMetadata ret;
+         ret._d = new Data(static_cast<Type>(type),bytes,offset);
+         offset += readSize(bytes,offset);
+         return ret;
+      }
+   default:
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(QObject::tr("Read Error"));
+         e.setDetails(QObject::tr("Could not decode metadata because its encoding is corrupt."));
+         throw e;
+      }
+   }
+}
+
+
+
+
+
+
+/*!
+ * Reads in a size from the given compact encoding at the given offset, moving
+ * the offset past it. If the given bytes do not have at least that many bytes
+ * after the size then an exception is thrown.
+ *
+ * @param bytes The compact encoding the size is read from.
+ *
+ * @param offset The offset within the given bytes where the size begins, which
+ *               is moved past its end.
+ *
+ * @return The size that was read.
+ */
+int EMetadata::readSize(const QByteArray& bytes, int& offset)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(&bytes,offset);
+
+   // Read in the size. If there are not that many bytes left then throw an exception,
+   // else return it.
+   quint32 ret {read<quint32>(bytes,offset)};
+   if ( ret > static_cast<quint32>(bytes.size() - offset) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Read Error"));
+      e.setDetails(QObject::tr("Could not decode metadata because its encoding is corrupt."));
+      throw e;
+   }
+   return static_cast<int>(ret);
+}
+
+
+
+
+
+
+/*!
+ * Constructs new data of the given type.
+ *
+ * @param type The type this new data will contain.
+ */
+EMetadata::Data::Data(Type type)
+   :
+   _type(type)
+{
+   EDEBUG_FUNC(this,type);
+   create();
+}
+
+
+
+
+
+
+/*!
+ * Constructs new array or object data of the given type that is not decoded
+ * yet, referencing the given encoded bytes it is decoded from the first time
+ * it is accessed.
+ *
+ * @param type The array or object type this new data will contain.
+ *
+ * @param encoded The encoded bytes this new data is decoded from.
+ *
+ * @param offset The offset of this new data's length prefix within the given
+ *               encoded bytes.
+ */
+EMetadata::Data::Data(Type type, const QByteArray& encoded, int offset)
+   :
+   _type(type),
+   _encoded(encoded),
+   _offset(offset)
+{
+   EDEBUG_FUNC(this,type,&encoded,offset);
+}
+
+
+
+
+
+
+/*!
+ * Constructs new data that is a copy of the given data. This is used to detach
+ * a metadata object from the data it shares before it is modified. The children
+ * of an array or object are themselves shared and not copied. If the given data
+ * is not decoded yet then this new data shares its encoded bytes and is not
+ * decoded either.
+ *
+ * @param object The data that is copied.
+ */
+EMetadata::Data::Data(const Data& object)
+   :
+   QSharedData(),
+   _type(object._type),
+   _encoded(object._encoded),
+   _offset(object._offset)
+{
+   // Add the debug header.
+   EDEBUG_FUNC(this,&object);
+
+   // If the given data is not decoded yet then leave this data not decoded as well,
+   // else go to the next step.
+   if ( !object._decoded.loadAcquire() )
+   {
+      return;
+   }
+
+   // Create new data of this object's type and copy the data pointed to by the given
+   // data's pointer based off this object's type.
+   create();
    switch (_type)
    {
    case Bool:
-      delete static_cast<bool*>(_data);
+      *static_cast<bool*>(_data) = *static_cast<const bool*>(object._data);
       break;
    case Double:
-      delete static_cast<double*>(_data);
+      *static_cast<double*>(_data) = *static_cast<const double*>(object._data);
       break;
    case String:
-      delete static_cast<QString*>(_data);
+      *static_cast<QString*>(_data) = *static_cast<const QString*>(object._data);
       break;
    case Bytes:
-      delete static_cast<QByteArray*>(_data);
+      *static_cast<QByteArray*>(_data) = *static_cast<const QByteArray*>(object._data);
       break;
    case Array:
-      delete static_cast<EMetaArray*>(_data);
+      *static_cast<EMetaArray*>(_data) = *static_cast<const EMetaArray*>(object._data);
       break;
    case Object:
-      delete static_cast<EMetaObject*>(_data);
+      *static_cast<EMetaObject*>(_data) = *static_cast<const EMetaObject*>(object._data);
       break;
    default:
       break;
@@ -862,35 +1367,33 @@ void EMetadata::clear()
 
 
 /*!
- * Creates new data for this object. Overwrites any previous data pointer and
- * does not free anything it pointed to.
+ * Deletes the underlying data this object's data pointer points to, if any.
  */
-void EMetadata::create()
+EMetadata::Data::~Data()
 {
    // Add the debug header.
    EDEBUG_FUNC(this);
 
-   // Create new data based off the type of this object, setting this object's data
-   // pointer to the new data.
+   // Delete the underlying data based off this object's type.
    switch (_type)
    {
    case Bool:
-      _data = new bool;
+      delete static_cast<bool*>(_data);
       break;
    case Double:
-      _data = new double;
+      delete static_cast<double*>(_data);
       break;
    case String:
-      _data = new QString;
+      delete static_cast<QString*>(_data);
       break;
    case Bytes:
-      _data = new QByteArray;
+      delete static_cast<QByteArray*>(_data);
       break;
    case Array:
-      _data = new EMetaArray;
+      delete static_cast<EMetaArray*>(_data);
       break;
    case Object:
-      _data = new EMetaObject;
+      delete static_cast<EMetaObject*>(_data);
       break;
    default:
       break;
@@ -903,43 +1406,38 @@ void EMetadata::create()
 
 
 /*!
- * Copy data from the supplied data pointer to the object's data pointer based
- * off this object's type. If the type is Null then this object's data pointer
- * is set to Null.
- *
- * @param data The data pointer to use for possible copying.
+ * Creates new underlying data based off this object's type, setting this
+ * object's data pointer to it and marking this object as decoded.
  */
-void EMetadata::copy(const void* data)
+void EMetadata::Data::create()
 {
    // Add the debug header.
-   EDEBUG_FUNC(this,data);
+   EDEBUG_FUNC(this);
 
-   // Copy the data pointed to by this object's data pointer from a data pointed to
-   // by the supplied data pointer based of this object's type. If the type is Null
-   // then the data pointer is set to null and the supplied data pointer is ignored.
+   // Create new data based off this object's type, setting this object's data
+   // pointer to the new data.
    switch (_type)
    {
-   case Null:
-      _data = nullptr;
-      break;
    case Bool:
-      *static_cast<bool*>(_data) = *static_cast<const bool*>(data);
+      _data = new bool;
       break;
    case Double:
-      *static_cast<double*>(_data) = *static_cast<const double*>(data);
+      _data = new double;
       break;
    case String:
-      *static_cast<QString*>(_data) = *static_cast<const QString*>(data);
+      _data = new QString;
       break;
    case Bytes:
-      *static_cast<QByteArray*>(_data) = *static_cast<const QByteArray*>(data);
+      _data = new QByteArray;
       break;
    case Array:
-      *static_cast<EMetaArray*>(_data) = *static_cast<const EMetaArray*>(data);
+      _data = new EMetaArray;
       break;
    case Object:
-      *static_cast<EMetaObject*>(_data) = *static_cast<const EMetaObject*>(data);
+      _data = new EMetaObject;
+      break;
+   default:
       break;
    }
+   _decoded.store(1);
 }
-
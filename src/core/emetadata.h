@@ -1,8 +1,10 @@
 #ifndef EMETADATA_H
 #define EMETADATA_H
+#include <QSharedDataPointer>
+#include <QAtomicInteger>
+#include <QByteArray>
 #include "global.h"
 class QString;
-class QByteArray;
 class QJsonValue;
 
 
@@ -13,7 +15,16 @@ class QJsonValue;
  * Because this can be an array or object it can possibly hold additional
  * metadata objects as children. Care should be taken to not attempt to convert
  * a metadata object to a type that it is not. If the object attempts to convert
- * itself to a type it is not an exception will be thrown.
+ * itself to a type it is not an exception will be thrown. Like qt containers
+ * this class is implicitly shared, so copying a metadata object only copies a
+ * pointer and its data is only copied once one of the copies is modified.
+ *
+ * Metadata can be encoded into a compact byte array where every array and
+ * object is prefixed with its length and every object has an offset table for
+ * its keys. Decoding such a byte array only decodes its top level, each array
+ * or object within it being decoded the first time it is accessed. Encoding an
+ * array or object that has not been modified since it was decoded copies its
+ * encoded bytes directly.
  */
 class EMetadata
 {
@@ -71,6 +82,7 @@ public:
    EMetadata(EMetadata&& object);
    ~EMetadata();
    QJsonValue toJson() const;
+   QByteArray encode() const;
    EMetadata::Type type() const;
    bool isNull() const;
    bool isBool() const;
@@ -92,19 +104,59 @@ public:
    EMetaArray& toArray();
    EMetaObject& toObject();
    static QString typeName(Type type);
+   static EMetadata decode(const QByteArray& bytes);
 private:
-   void checkType(Type type) const;
-   void clear();
-   void create();
-   void copy(const void* data);
    /*!
-    * This stores what type this object contains.
+    * This holds the type and data of a metadata value, shared between all metadata
+    * objects copied from each other until one of them is modified.
     */
-   Type _type;
+   class Data : public QSharedData
+   {
+   public:
+      Data(Type type);
+      Data(Type type, const QByteArray& encoded, int offset);
+      Data(const Data& object);
+      ~Data();
+      void create();
+      /*!
+       * This stores what type this data contains.
+       */
+      Type _type;
+      /*!
+       * This is a pointer to the actual data, if any, this contains. This is null for
+       * an array or object that has not been decoded yet.
+       */
+      void* _data {nullptr};
+      /*!
+       * Atomic switch set to 1 once the data pointer is set, which an array or object
+       * that is not decoded yet does the first time it is accessed. Checking this
+       * lets an already decoded array or object be read without locking.
+       */
+      QAtomicInteger<int> _decoded {0};
+      /*!
+       * The encoded bytes this array or object was decoded from, if any, which are
+       * cleared once it is modified.
+       */
+      QByteArray _encoded;
+      /*!
+       * The offset of this array or object's length prefix within its encoded bytes.
+       */
+      int _offset {0};
+   };
+private:
+   void checkType(Type type) const;
+   void decodeData() const;
+   void modifyData();
+   static void encode(QByteArray& bytes, const EMetadata& meta);
+   static EMetadata decode(const QByteArray& bytes, int& offset);
+   static int readSize(const QByteArray& bytes, int& offset);
+   template<class T> static T read(const QByteArray& bytes, int& offset);
+   template<class T> static void write(QByteArray& bytes, T value);
    /*!
-    * This is a pointer to the actual data, if any, that this object contains.
+    * This is a pointer to the shared data of this object, which is null if this
+    * object is the null type.
     */
-   void* _data {nullptr};
+   QSharedDataPointer<Data> _d;
 };
 
 #endif
@@ -0,0 +1,440 @@
+#include "etrace.h"
+#include <chrono>
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QObject>
+
+
+
+
+
+
+/*!
+ * Registers a new call site with the given function name and argument names,
+ * appending its site chunk to the trace file. This is called once for each call
+ * site the first time it is reached.
+ *
+ * @param function The function name of the call site.
+ *
+ * @param argumentNames The argument names of the call site separated by commas.
+ *
+ * @return The new call site ID.
+ */
+int ETrace::site(const char* function, const char* argumentNames)
+{
+   return file().addSite(function,argumentNames);
+}
+
+
+
+
+
+
+/*!
+ * Constructs a new trace object for a function call at the given call site,
+ * recording its enter event on the calling thread's buffer. The enter event is
+ * finished once its argument values are set.
+ *
+ * @param site The call site ID of the function call.
+ */
+ETrace::ETrace(int site)
+   :
+   _site(site),
+   _buffer(buffer())
+{
+   // Write the enter event with its call site ID and timestamp.
+   write<quint8>(_buffer._data,Enter);
+   write<quint32>(_buffer._data,static_cast<quint32>(_site));
+   write<qint64>(_buffer._data,timestamp());
+}
+
+
+
+
+
+
+/*!
+ * Records the leave event of the function call this trace object records,
+ * appending the calling thread's buffer to the trace file if it is full.
+ */
+ETrace::~ETrace()
+{
+   // Write the leave event with its call site ID and timestamp.
+   write<quint8>(_buffer._data,Leave);
+   write<quint32>(_buffer._data,static_cast<quint32>(_site));
+   write<qint64>(_buffer._data,timestamp());
+
+   // If this thread's buffer is full then append it to the trace file.
+   if ( _buffer._data.size() >= _bufferSize )
+   {
+      _buffer.flush();
+   }
+}
+
+
+
+
+
+
+/*!
+ * Opens the trace file of this process, writing its header. If the trace file
+ * cannot be opened then a warning is reported and all chunks are discarded.
+ */
+ETrace::File::File()
+{
+   // Build the path of this process's trace file from the trace environment variable
+   // and its process ID.
+   QByteArray prefix {qgetenv("ACE_TRACE")};
+   if ( prefix.isEmpty() )
+   {
+      prefix = "ace";
+   }
+   qint64 pid {QCoreApplication::applicationPid()};
+   _file.setFileName(QString("%1-%2.trace").arg(QString::fromLocal8Bit(prefix)).arg(pid));
+
+   // Open the trace file as write only. If opening fails then report a warning and
+   // return.
+   if ( !_file.open(QIODevice::WriteOnly|QIODevice::Truncate) )
+   {
+      QTextStream stream(stderr);
+      stream << QObject::tr("Failed opening trace file %1: %2\n")
+                .arg(_file.fileName())
+                .arg(_file.errorString());
+      return;
+   }
+
+   // Write the header of the trace file.
+   QByteArray header;
+   ETrace::write<quint64>(header,_magic);
+   ETrace::write<quint32>(header,_version);
+   ETrace::write<qint64>(header,pid);
+   _file.write(header);
+}
+
+
+
+
+
+
+/*!
+ * Closes the trace file of this process, making sure everything appended to it
+ * is written.
+ */
+ETrace::File::~File()
+{
+   _file.close();
+}
+
+
+
+
+
+
+/*!
+ * Registers a new call site with the given function name and argument names,
+ * appending its site chunk to this trace file.
+ *
+ * @param function The function name of the call site.
+ *
+ * @param argumentNames The argument names of the call site separated by commas.
+ *
+ * @return The new call site ID.
+ */
+int ETrace::File::addSite(const char* function, const char* argumentNames)
+{
+   // Lock this trace file and give the call site the next ID.
+   QMutexLocker locker(&_mutex);
+   int ret {_sites++};
+
+   // Build the site chunk of the new call site and append it to the trace file.
+   QByteArray chunk;
+   ETrace::write<quint8>(chunk,Site);
+   ETrace::write<quint32>(chunk,static_cast<quint32>(ret));
+   writeString(chunk,QByteArray(function));
+   writeString(chunk,QByteArray(argumentNames));
+   if ( _file.isOpen() )
+   {
+      _file.write(chunk);
+   }
+
+   // Return the new call site ID.
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * Gives a new thread the next thread ID of this trace file.
+ *
+ * @return The new thread ID.
+ */
+int ETrace::File::addThread()
+{
+   QMutexLocker locker(&_mutex);
+   return _threads++;
+}
+
+
+
+
+
+
+/*!
+ * Appends the given chunk to this trace file. If this trace file is not open
+ * then the chunk is discarded.
+ *
+ * @param chunk The chunk that is appended.
+ */
+void ETrace::File::write(const QByteArray& chunk)
+{
+   QMutexLocker locker(&_mutex);
+   if ( _file.isOpen() )
+   {
+      _file.write(chunk);
+   }
+}
+
+
+
+
+
+
+/*!
+ * Constructs a new event buffer for the calling thread, giving it a new thread
+ * ID.
+ */
+ETrace::Buffer::Buffer()
+   :
+   _thread(file().addThread())
+{
+   _data.reserve(_bufferSize + _bufferSize/16);
+}
+
+
+
+
+
+
+/*!
+ * Appends any events this buffer still holds to the trace file once its thread
+ * exits.
+ */
+ETrace::Buffer::~Buffer()
+{
+   flush();
+}
+
+
+
+
+
+
+/*!
+ * Appends the events this buffer holds to the trace file as an events chunk and
+ * then clears them. If this buffer holds no events then nothing is done.
+ */
+void ETrace::Buffer::flush()
+{
+   // If this buffer holds no events then there is nothing to do.
+   if ( _data.isEmpty() )
+   {
+      return;
+   }
+
+   // Build the events chunk of this buffer and append it to the trace file.
+   QByteArray chunk;
+   chunk.reserve(_data.size() + 9);
+   ETrace::write<quint8>(chunk,Events);
+   ETrace::write<qint32>(chunk,_thread);
+   ETrace::write<quint32>(chunk,static_cast<quint32>(_data.size()));
+   chunk.append(_data);
+   file().write(chunk);
+
+   // Clear this buffer, keeping its allocation.
+   _data.resize(0);
+}
+
+
+
+
+
+
+/*!
+ * Returns the trace file of this process, opening it the first time this is
+ * called.
+ *
+ * @return The trace file of this process.
+ */
+ETrace::File& ETrace::file()
+{
+   static File ret;
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * Returns the event buffer of the calling thread, making it the first time this
+ * is called on a thread.
+ *
+ * @return The event buffer of the calling thread.
+ */
+ETrace::Buffer& ETrace::buffer()
+{
+   static thread_local Buffer ret;
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * Returns the current time of a monotonic clock in nanoseconds, used as the
+ * timestamp of events.
+ *
+ * @return The current timestamp in nanoseconds.
+ */
+qint64 ETrace::timestamp()
+{
+   using namespace std::chrono;
+   return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+
+
+
+/*!
+ * Appends the given string to the given bytes as its size followed by its
+ * bytes.
+ *
+ * @param bytes The bytes the string is appended to.
+ *
+ * @param value The string that is written.
+ */
+void ETrace::writeString(QByteArray& bytes, const QByteArray& value)
+{
+   write<quint32>(bytes,static_cast<quint32>(value.size()));
+   bytes.append(value);
+}
+
+
+
+
+
+
+/*!
+ * Ends the variadic function chain once all argument values are packed.
+ *
+ * @param bytes Unused bytes the argument values were packed into.
+ */
+void ETrace::setArgument(QByteArray& bytes)
+{
+   Q_UNUSED(bytes)
+}
+
+
+
+
+
+
+/*!
+ * Packs the given boolean argument value.
+ *
+ * @param bytes The bytes the argument value is packed into.
+ *
+ * @param value The argument value.
+ */
+void ETrace::pack(QByteArray& bytes, bool value)
+{
+   write<quint8>(bytes,Bool);
+   write<quint8>(bytes,value);
+}
+
+
+
+
+
+
+/*!
+ * Packs the given null pointer argument value as a pointer.
+ *
+ * @param bytes The bytes the argument value is packed into.
+ *
+ * @param value Unused argument value.
+ */
+void ETrace::pack(QByteArray& bytes, std::nullptr_t value)
+{
+   Q_UNUSED(value)
+   write<quint8>(bytes,Pointer);
+   write<quint64>(bytes,0);
+}
+
+
+
+
+
+
+/*!
+ * Packs the given C string argument value as a string, or as a null pointer if
+ * it is null.
+ *
+ * @param bytes The bytes the argument value is packed into.
+ *
+ * @param value The argument value.
+ */
+void ETrace::pack(QByteArray& bytes, const char* value)
+{
+   if ( !value )
+   {
+      pack(bytes,nullptr);
+      return;
+   }
+   write<quint8>(bytes,String);
+   writeString(bytes,QByteArray(value,static_cast<int>(qMin<size_t>(strlen(value),_stringSize))));
+}
+
+
+
+
+
+
+/*!
+ * Packs the given string argument value.
+ *
+ * @param bytes The bytes the argument value is packed into.
+ *
+ * @param value The argument value.
+ */
+void ETrace::pack(QByteArray& bytes, const QString& value)
+{
+   write<quint8>(bytes,String);
+   writeString(bytes,value.left(_stringSize).toUtf8().left(_stringSize));
+}
+
+
+
+
+
+
+/*!
+ * Packs the given byte array argument value as a string.
+ *
+ * @param bytes The bytes the argument value is packed into.
+ *
+ * @param value The argument value.
+ */
+void ETrace::pack(QByteArray& bytes, const QByteArray& value)
+{
+   write<quint8>(bytes,String);
+   writeString(bytes,value.left(_stringSize));
+}
@@ -0,0 +1,369 @@
+#ifndef ETRACE_H
+#define ETRACE_H
+#include <QtEndian>
+#include <QMutex>
+#include <QFile>
+#include <QByteArray>
+#include <QString>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+
+
+
+/*!
+ * This is the trace class which is used at the beginning of each function to
+ * record every function call in a compact binary form when ACE is built with
+ * the ETRACE define. Like the debug class this should NEVER be used directly,
+ * instead using the debug macro that declares an instance of this class. Every
+ * call site is registered once, getting an ID used by all of its events. Each
+ * function call records an enter event with the call site ID, a timestamp, and
+ * its packed argument values, and a leave event with a timestamp once it
+ * returns. Events are appended to a buffer owned by the calling thread, so
+ * recording an event never locks. A thread's buffer is appended to the trace
+ * file whenever it is full and when the thread exits.
+ *
+ * The trace file of a process is named with the prefix given by the ACE_TRACE
+ * environment variable, or ace if it is not set, followed by the process ID and
+ * the trace extension. It begins with a header made of the trace magic number,
+ * the trace version, and the process ID. The rest of the file is a sequence of
+ * chunks that begin with their chunk type. A site chunk has a call site ID, its
+ * function name, and its argument names. An events chunk has a thread ID, the
+ * size of its events, and then the events themselves. All integers are little
+ * endian and all strings are a size followed by UTF-8 bytes. Traces are read by
+ * the log client, which can print them or convert them to Chrome trace JSON.
+ */
+class ETrace
+{
+public:
+   /*!
+    * Defines the chunk types of a trace file.
+    */
+   enum Chunk
+   {
+      /*!
+       * Defines a chunk that registers a call site ID with its function name and
+       * argument names.
+       */
+      Site
+      /*!
+       * Defines a chunk of events recorded by a single thread.
+       */
+      ,Events
+   };
+   /*!
+    * Defines the event types recorded within an events chunk.
+    */
+   enum Event
+   {
+      /*!
+       * Defines an event recorded when a function is entered, followed by its call
+       * site ID, timestamp, number of arguments, and packed arguments.
+       */
+      Enter
+      /*!
+       * Defines an event recorded when a function returns, followed by its call site
+       * ID and timestamp.
+       */
+      ,Leave
+   };
+   /*!
+    * Defines the tags of packed argument values, each tag followed by the value
+    * it describes.
+    */
+   enum Tag
+   {
+      /*!
+       * Defines an argument whose type cannot be packed, which has no value.
+       */
+      Unknown
+      /*!
+       * Defines a boolean argument packed as an 8 bit unsigned integer.
+       */
+      ,Bool
+      /*!
+       * Defines a signed integer or enumeration argument packed as a 64 bit integer.
+       */
+      ,Int
+      /*!
+       * Defines an unsigned integer argument packed as a 64 bit unsigned integer.
+       */
+      ,UInt
+      /*!
+       * Defines a real number argument packed as the 64 bits of a double.
+       */
+      ,Double
+      /*!
+       * Defines a pointer argument packed as a 64 bit unsigned integer.
+       */
+      ,Pointer
+      /*!
+       * Defines a string argument packed as a size and UTF-8 bytes, truncated to the
+       * maximum string size.
+       */
+      ,String
+   };
+   /*!
+    * The magic number every trace file begins with.
+    */
+   constexpr static quint64 _magic {0x4543415254454341};
+   /*!
+    * The trace file version written by this class.
+    */
+   constexpr static quint32 _version {1};
+public:
+   static int site(const char* function, const char* argumentNames);
+public:
+   explicit ETrace(int site);
+   ~ETrace();
+   template<class... Args> void setArguments(const Args&... arguments);
+private:
+   /*!
+    * This is the trace file of this process, which every thread appends its
+    * chunks to.
+    */
+   class File
+   {
+   public:
+      File();
+      ~File();
+      int addSite(const char* function, const char* argumentNames);
+      int addThread();
+      void write(const QByteArray& chunk);
+   private:
+      /*!
+       * Mutex protecting the file and counters of this trace file.
+       */
+      QMutex _mutex;
+      /*!
+       * The file device of this trace file.
+       */
+      QFile _file;
+      /*!
+       * The number of call sites that have been registered.
+       */
+      int _sites {0};
+      /*!
+       * The number of threads that have recorded events.
+       */
+      int _threads {0};
+   };
+   /*!
+    * This is the event buffer of a single thread, appended to the trace file as
+    * an events chunk whenever it is full and when its thread exits.
+    */
+   class Buffer
+   {
+   public:
+      Buffer();
+      ~Buffer();
+      void flush();
+      /*!
+       * The thread ID of this buffer's thread.
+       */
+      qint32 _thread;
+      /*!
+       * The events this buffer holds.
+       */
+      QByteArray _data;
+   };
+private:
+   static File& file();
+   static Buffer& buffer();
+   static qint64 timestamp();
+   template<class T> static void write(QByteArray& bytes, T value);
+   static void writeString(QByteArray& bytes, const QByteArray& value);
+   static void setArgument(QByteArray& bytes);
+   template<class T, class... Args> static void setArgument(QByteArray& bytes, const T& next, const Args&... arguments);
+   template<class T> static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type pack(QByteArray& bytes, const T& value);
+   template<class T> static typename std::enable_if<std::is_floating_point<T>::value>::type pack(QByteArray& bytes, const T& value);
+   template<class T> static typename std::enable_if<std::is_pointer<typename std::decay<T>::type>::value>::type pack(QByteArray& bytes, const T& value);
+   template<class T> static typename std::enable_if<std::is_class<T>::value>::type pack(QByteArray& bytes, const T& value);
+   static void pack(QByteArray& bytes, bool value);
+   static void pack(QByteArray& bytes, std::nullptr_t value);
+   static void pack(QByteArray& bytes, const char* value);
+   static void pack(QByteArray& bytes, const QString& value);
+   static void pack(QByteArray& bytes, const QByteArray& value);
+   /*!
+    * The maximum number of bytes packed for a string argument.
+    */
+   constexpr static int _stringSize {64};
+   /*!
+    * The number of bytes a thread's buffer holds before it is appended to the trace
+    * file.
+    */
+   constexpr static int _bufferSize {1 << 20};
+   /*!
+    * The call site ID of the function call this trace object records.
+    */
+   int _site;
+   /*!
+    * The event buffer of the thread this trace object was made on.
+    */
+   Buffer& _buffer;
+};
+
+
+
+
+
+
+/*!
+ * Records the values of the arguments of the function this trace object is
+ * recording, finishing its enter event. The number of arguments MUST match with
+ * the number of argument names given when its call site was registered.
+ *
+ * @tparam Args The variadic list of argument types.
+ *
+ * @param arguments The variadic list of argument values.
+ */
+template<class... Args> void ETrace::setArguments(const Args&... arguments)
+{
+   // Write out the number of arguments and then pack each one.
+   write<quint8>(_buffer._data,static_cast<quint8>(sizeof...(Args)));
+   setArgument(_buffer._data,arguments...);
+}
+
+
+
+
+
+
+/*!
+ * Appends the given integer to the given bytes as little endian.
+ *
+ * @tparam T The integer type that is written.
+ *
+ * @param bytes The bytes the integer is appended to.
+ *
+ * @param value The integer that is written.
+ */
+template<class T> void ETrace::write(QByteArray& bytes, T value)
+{
+   uchar buffer[sizeof(T)];
+   qToLittleEndian<T>(value,buffer);
+   bytes.append(reinterpret_cast<const char*>(buffer),sizeof(T));
+}
+
+
+
+
+
+
+/*!
+ * Packs the next argument value of the variadic function chain and then the
+ * rest of them.
+ *
+ * @tparam T The type of the next argument value.
+ *
+ * @tparam Args The variadic list of remaining argument types.
+ *
+ * @param bytes The bytes the argument values are packed into.
+ *
+ * @param next The next argument value.
+ *
+ * @param arguments The variadic list of remaining argument values.
+ */
+template<class T, class... Args> void ETrace::setArgument(QByteArray& bytes, const T& next, const Args&... arguments)
+{
+   pack(bytes,next);
+   setArgument(bytes,arguments...);
+}
+
+
+
+
+
+
+/*!
+ * Packs the given integer or enumeration argument value.
+ *
+ * @tparam T The integer or enumeration type of the argument.
+ *
+ * @param bytes The bytes the argument value is packed into.
+ *
+ * @param value The argument value.
+ */
+template<class T> typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type ETrace::pack(QByteArray& bytes, const T& value)
+{
+   // Pack the given value as an unsigned integer if its type is unsigned, else as a
+   // signed integer.
+   if ( std::is_unsigned<T>::value )
+   {
+      write<quint8>(bytes,UInt);
+      write<quint64>(bytes,static_cast<quint64>(value));
+   }
+   else
+   {
+      write<quint8>(bytes,Int);
+      write<qint64>(bytes,static_cast<qint64>(value));
+   }
+}
+
+
+
+
+
+
+/*!
+ * Packs the given real number argument value.
+ *
+ * @tparam T The floating point type of the argument.
+ *
+ * @param bytes The bytes the argument value is packed into.
+ *
+ * @param value The argument value.
+ */
+template<class T> typename std::enable_if<std::is_floating_point<T>::value>::type ETrace::pack(QByteArray& bytes, const T& value)
+{
+   // Pack the given value as the bits of a double.
+   double real {static_cast<double>(value)};
+   quint64 bits;
+   std::memcpy(&bits,&real,sizeof(bits));
+   write<quint8>(bytes,Double);
+   write<quint64>(bytes,bits);
+}
+
+
+
+
+
+
+/*!
+ * Packs the given pointer or array argument value as a pointer.
+ *
+ * @tparam T The pointer or array type of the argument.
+ *
+ * @param bytes The bytes the argument value is packed into.
+ *
+ * @param value The argument value.
+ */
+template<class T> typename std::enable_if<std::is_pointer<typename std::decay<T>::type>::value>::type ETrace::pack(QByteArray& bytes, const T& value)
+{
+   const typename std::decay<T>::type pointer {value};
+   write<quint8>(bytes,Pointer);
+   write<quint64>(bytes,static_cast<quint64>(reinterpret_cast<quintptr>(pointer)));
+}
+
+
+
+
+
+
+/*!
+ * Packs an argument value whose class type cannot be packed, recording only
+ * that it is unknown.
+ *
+ * @tparam T The class type of the argument.
+ *
+ * @param bytes The bytes the argument value is packed into.
+ *
+ * @param value Unused argument value.
+ */
+template<class T> typename std::enable_if<std::is_class<T>::value>::type ETrace::pack(QByteArray& bytes, const T& value)
+{
+   Q_UNUSED(value)
+   write<quint8>(bytes,Unknown);
+}
+
+#endif
@@ -153,7 +153,7 @@ EDataStream& operator<<(EDataStream& stream, const EMetadata& meta)
 
       // Iterate through all metadata values the array contains and write them to the
       // data stream.
-      for (auto child : meta.toArray())
+      for (const auto& child : meta.toArray())
       {
          stream << child;
       }
@@ -197,8 +197,10 @@ EDebug& operator<<(EDebug& debug, const EMetadata*const meta)
    // Disable quoting of strings.
    debug << EDebug::NoQuote;
 
-   // Append the fact that this is metadata and its type.
-   switch (meta->_type)
+   // Get the shared data of the metadata directly, if any, and append the fact that
+   // this is metadata and its type.
+   const EMetadata::Data* data {meta->_d.constData()};
+   switch (data ? data->_type : EMetadata::Null)
    {
    case EMetadata::Null:
       debug << QStringLiteral("EMetadata(null");
@@ -224,21 +226,21 @@ EDebug& operator<<(EDebug& debug, const EMetadata*const meta)
    }
 
    // Check to see if this metadata object has data.
-   if ( meta->_data )
+   if ( data && data->_data )
    {
       // Append the value of this metadata's data as a string.
-      switch (meta->_type)
+      switch (data->_type)
       {
       case EMetadata::Bool:
-         debug << ( *reinterpret_cast<bool*>(meta->_data) ? QStringLiteral("TRUE") : QStringLiteral("FALSE") )
+         debug << ( *reinterpret_cast<bool*>(data->_data) ? QStringLiteral("TRUE") : QStringLiteral("FALSE") )
                << QStringLiteral(")");
          break;
       case EMetadata::Double:
-         debug << *reinterpret_cast<double*>(meta->_data)
+         debug << *reinterpret_cast<double*>(data->_data)
                << QStringLiteral(")");
          break;
       case EMetadata::String:
-         debug << *reinterpret_cast<QString*>(meta->_data)
+         debug << *reinterpret_cast<QString*>(data->_data)
                << QStringLiteral("\")");
          break;
       default:
@@ -16,11 +16,18 @@ SOURCES += \
     dataframe.cpp \
     dataframe_iterator.cpp \
     dataframe_model.cpp \
+    dataframe_names.cpp \
     mathtransform.cpp \
     importdataframe.cpp \
     importdataframe_input.cpp \
+    importdataframe_workblock.cpp \
+    importdataframe_resultblock.cpp \
+    importdataframe_serial.cpp \
     exportdataframe.cpp \
     exportdataframe_input.cpp \
+    exportdataframe_workblock.cpp \
+    exportdataframe_resultblock.cpp \
+    exportdataframe_serial.cpp \
     mathtransform_input.cpp \
     mathtransform_serial.cpp \
     mathtransform_block.cpp \
@@ -37,11 +44,18 @@ HEADERS += \
     dataframe.h \
     dataframe_iterator.h \
     dataframe_model.h \
+    dataframe_names.h \
     mathtransform.h \
     importdataframe.h \
     importdataframe_input.h \
+    importdataframe_workblock.h \
+    importdataframe_resultblock.h \
+    importdataframe_serial.h \
     exportdataframe.h \
     exportdataframe_input.h \
+    exportdataframe_workblock.h \
+    exportdataframe_resultblock.h \
+    exportdataframe_serial.h \
     mathtransform_input.h \
     mathtransform_serial.h \
     global.h \
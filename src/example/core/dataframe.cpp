@@ -1,5 +1,6 @@
 #include "dataframe.h"
 #include "dataframe_model.h"
+#include "dataframe_names.h"
 
 
 
@@ -10,10 +11,30 @@
 
 
 
+/*!
+ * Construct a new dataframe with no rows or columns.
+ */
+DataFrame::DataFrame() = default;
+
+
+
+
+
+
+/*!
+ * Destroy this dataframe and its name tables.
+ */
+DataFrame::~DataFrame() = default;
+
+
+
+
+
+
 /*!
  * Implements the interface that returns the index within this data object after
  * the end of where the data is stored. Defined as the header size plus the size
- * of the matrix data.
+ * of the matrix data plus the size of the name tables.
  *
  * @return Index of the first byte in the data object after the data section ends.
  */
@@ -21,7 +42,7 @@ qint64 DataFrame::dataEnd() const
 {
    EDEBUG_FUNC(this);
 
-   return _headerSize + (qint64)_rowSize * (qint64)_columnSize * sizeof(float);
+   return matrixEnd() + _rowNamesSize + _columnNamesSize;
 }
 
 
@@ -31,7 +52,9 @@ qint64 DataFrame::dataEnd() const
 
 /*!
  * Implements the interface that reads in the data of an existing data object that
- * was just opened.
+ * was just opened. The header and both name tables are read. An older dataframe
+ * without the names tag takes its names from metadata the first time they are
+ * accessed, because its metadata is read after its data.
  */
 void DataFrame::readData()
 {
@@ -40,8 +63,45 @@ void DataFrame::readData()
    // seek to the beginning of the data
    seek(0);
 
-   // read the header
-   stream() >> _rowSize >> _columnSize;
+   // read the names tag or the row size of an older dataframe
+   qint32 tag;
+   stream() >> tag;
+
+   // read the rest of the header of an older dataframe
+   _rowNames.reset();
+   _columnNames.reset();
+
+   if ( tag != _namesTag )
+   {
+      _rowSize = tag;
+      stream() >> _columnSize;
+      _matrixOffset = _legacyHeaderSize;
+      _rowNamesSize = 0;
+      _columnNamesSize = 0;
+      return;
+   }
+
+   // read the rest of the header
+   qint32 version;
+   stream() >> version >> _rowSize >> _columnSize >> _rowNamesSize >> _columnNamesSize;
+   _matrixOffset = _headerSize;
+
+   // make sure the version is supported
+   if ( version != _namesVersion )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Read Error"));
+      e.setDetails(tr("Dataframe has unsupported version %1.").arg(version));
+      throw e;
+   }
+
+   // read the name tables that follow the matrix data
+   _rowNames.reset(new Names);
+   _columnNames.reset(new Names);
+   seek(matrixEnd());
+   _rowNames->read(stream(),_rowSize);
+   seek(matrixEnd() + _rowNamesSize);
+   _columnNames->read(stream(),_columnSize);
 }
 
 
@@ -60,11 +120,17 @@ void DataFrame::writeNewData()
    // initialize metadata object
    setMeta(EMetaObject());
 
-   // seek to the beginning of the data
-   seek(0);
+   // initialize an empty dataframe
+   _rowSize = 0;
+   _columnSize = 0;
+   _matrixOffset = _headerSize;
+   _rowNames.reset(new Names);
+   _columnNames.reset(new Names);
+   _rowNamesSize = _rowNames->byteSize();
+   _columnNamesSize = _columnNames->byteSize();
 
    // write the header
-   stream() << _rowSize << _columnSize;
+   writeHeader();
 }
 
 
@@ -74,17 +140,35 @@ void DataFrame::writeNewData()
 
 /*!
  * Implements the interface that finalizes this data object's data after the
- * analytic that created it has finished giving it new data.
+ * analytic that created it has finished giving it new data. The name tables
+ * are written after the matrix data.
  */
 void DataFrame::finish()
 {
    EDEBUG_FUNC(this);
 
-   // seek to the beginning of the data
-   seek(0);
+   // make sure the name tables match the size of the matrix
+   if ( rowTable().size() != _rowSize || columnTable().size() != _columnSize )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Logic Error"));
+      e.setDetails(tr("Dataframe of size (%1,%2) has %3 row names and %4 column names.")
+         .arg(_rowSize)
+         .arg(_columnSize)
+         .arg(rowTable().size())
+         .arg(columnTable().size()));
+      throw e;
+   }
+
+   // write the name tables after the matrix data
+   _rowNamesSize = _rowNames->byteSize();
+   _columnNamesSize = _columnNames->byteSize();
+   seek(matrixEnd());
+   _rowNames->write(stream());
+   _columnNames->write(stream());
 
    // write the header
-   stream() << _rowSize << _columnSize;
+   writeHeader();
 }
 
 
@@ -151,7 +235,7 @@ EMetaArray DataFrame::rowNames() const
 {
    EDEBUG_FUNC(this);
 
-   return meta().toObject().at("rows").toArray();
+   return rowTable().toArray();
 }
 
 
@@ -166,7 +250,77 @@ EMetaArray DataFrame::columnNames() const
 {
    EDEBUG_FUNC(this);
 
-   return meta().toObject().at("columns").toArray();
+   return columnTable().toArray();
+}
+
+
+
+
+
+
+/*!
+ * Return the name of the given row in this dataframe.
+ *
+ * @param index
+ */
+QString DataFrame::rowName(int index) const
+{
+   EDEBUG_FUNC(this,index);
+
+   return rowTable().at(index);
+}
+
+
+
+
+
+
+/*!
+ * Return the name of the given column in this dataframe.
+ *
+ * @param index
+ */
+QString DataFrame::columnName(int index) const
+{
+   EDEBUG_FUNC(this,index);
+
+   return columnTable().at(index);
+}
+
+
+
+
+
+
+/*!
+ * Return the index of the row with the given name in this dataframe, or -1 if
+ * there is no such row.
+ *
+ * @param name
+ */
+int DataFrame::rowIndex(const QString& name) const
+{
+   EDEBUG_FUNC(this,name);
+
+   return rowTable().indexOf(name);
+}
+
+
+
+
+
+
+/*!
+ * Return the index of the column with the given name in this dataframe, or -1
+ * if there is no such column.
+ *
+ * @param name
+ */
+int DataFrame::columnIndex(const QString& name) const
+{
+   EDEBUG_FUNC(this,name);
+
+   return columnTable().indexOf(name);
 }
 
 
@@ -185,22 +339,13 @@ void DataFrame::initialize(const QStringList& rowNames, const QStringList& colum
 {
    EDEBUG_FUNC(this,&rowNames,&columnNames);
 
-   // create a metadata array of row names
-   EMetaArray metaRowNames;
-   for ( auto& rowName : rowNames )
-   {
-      metaRowNames.append(rowName);
-   }
-
-   // create a metadata array of column names
-   EMetaArray metaColumnNames;
-   for ( auto& columnName : columnNames )
-   {
-      metaColumnNames.append(columnName);
-   }
+   // create the name tables
+   _rowNames.reset(new Names(rowNames));
+   _columnNames.reset(new Names(columnNames));
 
-   // initialize this dataframe with the metadata arrays
-   initialize(metaRowNames, metaColumnNames);
+   // initialize the row size and column size accordingly
+   _rowSize = rowNames.size();
+   _columnSize = columnNames.size();
 }
 
 
@@ -219,11 +364,9 @@ void DataFrame::initialize(const EMetaArray& rowNames, const EMetaArray& columnN
 {
    EDEBUG_FUNC(this,&rowNames,&columnNames);
 
-   // save the row names and column names to metadata
-   EMetaObject metaObject {meta().toObject()};
-   metaObject.insert("rows", rowNames);
-   metaObject.insert("columns", columnNames);
-   setMeta(metaObject);
+   // create the name tables
+   _rowNames.reset(new Names(rowNames));
+   _columnNames.reset(new Names(columnNames));
 
    // initialize the row size and column size accordingly
    _rowSize = rowNames.size();
@@ -235,6 +378,36 @@ void DataFrame::initialize(const EMetaArray& rowNames, const EMetaArray& columnN
 
 
 
+/*!
+ * Change the number of rows in this dataframe without changing its row names.
+ * This allows rows to be written to a new dataframe before all of its row
+ * names are known, in which case initialize must be called with the final row
+ * names before the dataframe is finished.
+ *
+ * @param size
+ */
+void DataFrame::resizeRows(qint32 size)
+{
+   EDEBUG_FUNC(this,size);
+
+   // make sure the size is valid
+   if ( size < 0 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Invalid Argument"));
+      e.setDetails(tr("Row size cannot be negative."));
+      throw e;
+   }
+
+   // set the new row size
+   _rowSize = size;
+}
+
+
+
+
+
+
 /*!
  * Seek to a particular value in this dataframe given a row index
  * and a column index.
@@ -260,5 +433,82 @@ void DataFrame::seekValue(int row, int column) const
    }
 
    // seek to the specified position in the data
-   seek(_headerSize + ((qint64)row * (qint64)_columnSize + (qint64)column) * sizeof(float));
+   seek(_matrixOffset + ((qint64)row * (qint64)_columnSize + (qint64)column) * sizeof(float));
+}
+
+
+
+
+
+
+/*!
+ * Return the index within this data object after the end of the matrix data,
+ * where the name tables begin.
+ */
+qint64 DataFrame::matrixEnd() const
+{
+   EDEBUG_FUNC(this);
+
+   return _matrixOffset + (qint64)_rowSize * (qint64)_columnSize * sizeof(float);
+}
+
+
+
+
+
+
+/*!
+ * Write the header of this dataframe at the beginning of the data.
+ */
+void DataFrame::writeHeader()
+{
+   EDEBUG_FUNC(this);
+
+   // seek to the beginning of the data
+   seek(0);
+
+   // write the header
+   stream() << qint32 {_namesTag} << qint32 {_namesVersion} << _rowSize << _columnSize << _rowNamesSize << _columnNamesSize;
+}
+
+
+
+
+
+
+/*!
+ * Return the table of row names in this dataframe, building it from the
+ * metadata of an older dataframe if this is its first access.
+ */
+const DataFrame::Names& DataFrame::rowTable() const
+{
+   EDEBUG_FUNC(this);
+
+   if ( !_rowNames )
+   {
+      _rowNames.reset(new Names(meta().toObject().at("rows").toArray()));
+   }
+
+   return *_rowNames;
+}
+
+
+
+
+
+
+/*!
+ * Return the table of column names in this dataframe, building it from the
+ * metadata of an older dataframe if this is its first access.
+ */
+const DataFrame::Names& DataFrame::columnTable() const
+{
+   EDEBUG_FUNC(this);
+
+   if ( !_columnNames )
+   {
+      _columnNames.reset(new Names(meta().toObject().at("columns").toArray()));
+   }
+
+   return *_columnNames;
 }
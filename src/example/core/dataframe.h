@@ -1,5 +1,6 @@
 #ifndef DATAFRAME_H
 #define DATAFRAME_H
+#include <memory>
 #include <core/core.h>
 //
 
@@ -7,14 +8,18 @@
 
 /*!
  * This class implements the dataframe data object. A dataframe contains a
- * matrix of floating-point values, as well as metadata for row names and
- * column names. The matrix data can be accessed using the row interator.
+ * matrix of floating-point values, as well as tables of row names and column
+ * names stored after the matrix. The matrix data can be accessed using the row
+ * interator. Each name table is only read the first time it is accessed.
  */
 class DataFrame : public EAbstractData
 {
    Q_OBJECT
 public:
    class Iterator;
+public:
+   DataFrame();
+   virtual ~DataFrame() override;
 public:
    virtual qint64 dataEnd() const override final;
    virtual void readData() override final;
@@ -26,25 +31,74 @@ public:
    qint32 columnSize() const;
    EMetaArray rowNames() const;
    EMetaArray columnNames() const;
+   QString rowName(int index) const;
+   QString columnName(int index) const;
+   int rowIndex(const QString& name) const;
+   int columnIndex(const QString& name) const;
    void initialize(const QStringList& rowNames, const QStringList& columnNames);
    void initialize(const EMetaArray& rowNames, const EMetaArray& columnNames);
+   void resizeRows(qint32 size);
 private:
    class Model;
+   class Names;
 private:
    void seekValue(int row, int column) const;
+   qint64 matrixEnd() const;
+   void writeHeader();
+   const Names& rowTable() const;
+   const Names& columnTable() const;
+   /*!
+    * The tag written in place of the row size at the beginning of a dataframe
+    * that stores its names in tables, which distinguishes it from an older
+    * dataframe that stores its names in metadata.
+    */
+   constexpr static const qint32 _namesTag {-1};
+   /*!
+    * The version of the dataframe header written with the names tag.
+    */
+   constexpr static const qint32 _namesVersion {1};
    /*!
     * The header size (in bytes) at the beginning of the file. The header
-    * consists of the row size and the column size.
+    * consists of the names tag, the version, the row size, the column size, and
+    * the byte sizes of the row name and column name tables.
+    */
+   constexpr static const qint64 _headerSize {32};
+   /*!
+    * The header size (in bytes) of an older dataframe, which consists of only the
+    * row size and the column size.
+    */
+   constexpr static const qint64 _legacyHeaderSize {8};
+   /*!
+    * The offset (in bytes) of the matrix data, which is the size of the header
+    * this dataframe was read or written with.
     */
-   constexpr static const qint64 _headerSize {8};
+   qint64 _matrixOffset {_headerSize};
    /*!
     * The number of rows in the dataframe.
     */
-   qint32 _rowSize;
+   qint32 _rowSize {0};
    /*!
     * The number of columns in the dataframe.
     */
-   qint32 _columnSize;
+   qint32 _columnSize {0};
+   /*!
+    * The byte size of the row name table stored after the matrix data.
+    */
+   qint64 _rowNamesSize {0};
+   /*!
+    * The byte size of the column name table stored after the row name table.
+    */
+   qint64 _columnNamesSize {0};
+   /*!
+    * Pointer to the table of row names, which is null for an older dataframe
+    * until it is first accessed.
+    */
+   mutable std::unique_ptr<Names> _rowNames;
+   /*!
+    * Pointer to the table of column names, which is null for an older dataframe
+    * until it is first accessed.
+    */
+   mutable std::unique_ptr<Names> _columnNames;
    /*!
     * Pointer to a qt table model for this class.
     */
@@ -96,10 +96,7 @@ void DataFrame::Iterator::read(int index)
    _matrix->seekValue(index,0);
 
    // read the entire row into memory
-   for (int i = 0; i < _matrix->columnSize() ;++i)
-   {
-      _matrix->stream() >> _data[i];
-   }
+   _matrix->stream().readArray(_data,_matrix->columnSize());
 
    // set the iterator's current index
    _index = index;
@@ -159,10 +156,7 @@ void DataFrame::Iterator::write(int index)
    _matrix->seekValue(index,0);
 
    // write the entire row to the data object
-   for (int i = 0; i < _matrix->columnSize() ;++i)
-   {
-      _matrix->stream() << _data[i];
-   }
+   _matrix->stream().writeArray(_data,_matrix->columnSize());
 
    // set the iterator's current index
    _index = index;
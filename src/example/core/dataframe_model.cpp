@@ -47,14 +47,11 @@ QVariant DataFrame::Model::headerData(int section, Qt::Orientation orientation,
    {
    case Qt::Vertical:
    {
-      // get row names
-      EMetaArray rowNames {_matrix->rowNames()};
-
       // make sure the index is valid
-      if ( section >= 0 && section < rowNames.size() )
+      if ( section >= 0 && section < _matrix->rowSize() )
       {
          // return the specified row name
-         return rowNames.at(section).toString();
+         return _matrix->rowName(section);
       }
 
       // otherwise return empty string
@@ -62,14 +59,11 @@ QVariant DataFrame::Model::headerData(int section, Qt::Orientation orientation,
    }
    case Qt::Horizontal:
    {
-      // get column names
-      EMetaArray columns {_matrix->columnNames()};
-
       // make sure the index is valid
-      if ( section >= 0 && section < columns.size() )
+      if ( section >= 0 && section < _matrix->columnSize() )
       {
          // return the specified column name
-         return columns.at(section).toString();
+         return _matrix->columnName(section);
       }
 
       // otherwise return empty string
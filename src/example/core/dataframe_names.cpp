@@ -0,0 +1,293 @@
+#include "dataframe_names.h"
+#include <cstring>
+#include <limits>
+#include <QHash>
+
+
+
+//
+
+
+
+
+
+
+/*!
+ * Construct a new name table with the given names.
+ *
+ * @param names
+ */
+DataFrame::Names::Names(const QStringList& names)
+{
+   EDEBUG_FUNC(this,&names);
+
+   _offsets.reserve(names.size() + 1);
+
+   for ( auto& name : names )
+   {
+      append(name.toUtf8());
+   }
+}
+
+
+
+
+
+
+/*!
+ * Construct a new name table with the given metadata array of names.
+ *
+ * @param names
+ */
+DataFrame::Names::Names(const EMetaArray& names)
+{
+   EDEBUG_FUNC(this,&names);
+
+   _offsets.reserve(names.size() + 1);
+
+   for ( auto& name : names )
+   {
+      append(name.toString().toUtf8());
+   }
+}
+
+
+
+
+
+
+/*!
+ * Return the number of names in this table.
+ */
+int DataFrame::Names::size() const
+{
+   EDEBUG_FUNC(this);
+
+   return _offsets.size() - 1;
+}
+
+
+
+
+
+
+/*!
+ * Return the name at the given index.
+ *
+ * @param index
+ */
+QString DataFrame::Names::at(int index) const
+{
+   EDEBUG_FUNC(this,index);
+
+   // make sure the index is valid
+   if ( index < 0 || index >= size() )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(QObject::tr("Domain Error"));
+      e.setDetails(QObject::tr("Attempting to access name %1 when maximum is %2.").arg(index)
+                   .arg(size()-1));
+      throw e;
+   }
+
+   // return the name decoded from its bytes
+   qint64 begin {_offsets.at(index)};
+   return QString::fromUtf8(_bytes.constData() + begin, static_cast<int>(_offsets.at(index + 1) - begin));
+}
+
+
+
+
+
+
+/*!
+ * Return the index of the given name, or -1 if it is not in this table. If
+ * the name occurs more than once then the index of any occurrence may be
+ * returned.
+ *
+ * @param name
+ */
+int DataFrame::Names::indexOf(const QString& name) const
+{
+   EDEBUG_FUNC(this,name);
+
+   // build the hash index if this is the first lookup
+   if ( _buckets.isEmpty() )
+   {
+      buildIndex();
+   }
+
+   // probe the hash index until the name or an empty bucket is found
+   QByteArray key {name.toUtf8()};
+   uint mask {static_cast<uint>(_buckets.size() - 1)};
+   uint bucket {qHashBits(key.constData(), key.size()) & mask};
+
+   while ( _buckets.at(bucket) != -1 )
+   {
+      qint32 index {_buckets.at(bucket)};
+      qint64 begin {_offsets.at(index)};
+      qint64 length {_offsets.at(index + 1) - begin};
+
+      if ( length == key.size() && memcmp(_bytes.constData() + begin, key.constData(), key.size()) == 0 )
+      {
+         return index;
+      }
+
+      bucket = (bucket + 1) & mask;
+   }
+
+   return -1;
+}
+
+
+
+
+
+
+/*!
+ * Return all names in this table as a metadata array.
+ */
+EMetaArray DataFrame::Names::toArray() const
+{
+   EDEBUG_FUNC(this);
+
+   EMetaArray ret;
+
+   for ( int i = 0; i < size(); ++i )
+   {
+      ret.append(at(i));
+   }
+
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * Return the number of bytes this table uses when written to a data stream.
+ */
+qint64 DataFrame::Names::byteSize() const
+{
+   EDEBUG_FUNC(this);
+
+   return _offsets.size() * static_cast<qint64>(sizeof(qint64)) + _bytes.size();
+}
+
+
+
+
+
+
+/*!
+ * Read a table with the given number of names from the given data stream,
+ * replacing the names of this table. The offsets and the packed bytes are each
+ * read with a single call.
+ *
+ * @param stream
+ * @param size
+ */
+void DataFrame::Names::read(const EDataStream& stream, int size)
+{
+   EDEBUG_FUNC(this,&stream,size);
+
+   // read the offsets
+   _offsets.resize(size + 1);
+   stream.readArray(_offsets.data(), _offsets.size());
+
+   // make sure the offsets are valid
+   for ( int i = 0; i < size; ++i )
+   {
+      if ( _offsets.at(i) < 0 || _offsets.at(i) > _offsets.at(i + 1) || _offsets.at(i + 1) > std::numeric_limits<int>::max() )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(QObject::tr("Read Error"));
+         e.setDetails(QObject::tr("Dataframe name table is corrupt."));
+         throw e;
+      }
+   }
+
+   // read the packed bytes
+   _bytes.resize(static_cast<int>(_offsets.last()));
+   stream.readArray(_bytes.data(), _bytes.size());
+   _buckets.clear();
+}
+
+
+
+
+
+
+/*!
+ * Write this table to the given data stream. The offsets and the packed bytes
+ * are each written with a single call.
+ *
+ * @param stream
+ */
+void DataFrame::Names::write(EDataStream& stream) const
+{
+   EDEBUG_FUNC(this,&stream);
+
+   stream.writeArray(_offsets.constData(), _offsets.size());
+   stream.writeArray(_bytes.constData(), _bytes.size());
+}
+
+
+
+
+
+
+/*!
+ * Append the given UTF-8 encoded name to this table.
+ *
+ * @param name
+ */
+void DataFrame::Names::append(const QByteArray& name)
+{
+   EDEBUG_FUNC(this,&name);
+
+   _bytes.append(name);
+   _offsets.append(_bytes.size());
+}
+
+
+
+
+
+
+/*!
+ * Build the hash index of all names in this table, using at least twice as
+ * many buckets as there are names.
+ */
+void DataFrame::Names::buildIndex() const
+{
+   EDEBUG_FUNC(this);
+
+   // initialize all buckets to empty
+   int bucketSize {16};
+
+   while ( bucketSize < 2 * size() )
+   {
+      bucketSize *= 2;
+   }
+
+   _buckets.fill(-1, bucketSize);
+
+   // insert each name into the first empty bucket from its hash
+   uint mask {static_cast<uint>(bucketSize - 1)};
+
+   for ( int i = 0; i < size(); ++i )
+   {
+      qint64 begin {_offsets.at(i)};
+      uint bucket {qHashBits(_bytes.constData() + begin, static_cast<size_t>(_offsets.at(i + 1) - begin)) & mask};
+
+      while ( _buckets.at(bucket) != -1 )
+      {
+         bucket = (bucket + 1) & mask;
+      }
+
+      _buckets[bucket] = i;
+   }
+}
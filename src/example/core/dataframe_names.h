@@ -0,0 +1,49 @@
+#ifndef DATAFRAME_NAMES_H
+#define DATAFRAME_NAMES_H
+#include "dataframe.h"
+//
+
+
+
+/*!
+ * This class implements a compact table of row or column names for the
+ * dataframe data object. All names are stored as packed UTF-8 bytes with an
+ * array of offsets, so any name is found by index in constant time. A hash
+ * index of names is built the first time a name is looked up, which stores
+ * only name indexes and compares against the packed bytes.
+ */
+class DataFrame::Names
+{
+public:
+   Names() = default;
+   explicit Names(const QStringList& names);
+   explicit Names(const EMetaArray& names);
+   int size() const;
+   QString at(int index) const;
+   int indexOf(const QString& name) const;
+   EMetaArray toArray() const;
+   qint64 byteSize() const;
+   void read(const EDataStream& stream, int size);
+   void write(EDataStream& stream) const;
+private:
+   void append(const QByteArray& name);
+   void buildIndex() const;
+   /*!
+    * The offset of each name within the packed bytes, followed by the total size
+    * of the packed bytes.
+    */
+   QVector<qint64> _offsets {0};
+   /*!
+    * The UTF-8 bytes of all names packed one after another.
+    */
+   QByteArray _bytes;
+   /*!
+    * The open addressing hash index of names, where each bucket is the index of a
+    * name or -1 if the bucket is empty. This is empty until it is built.
+    */
+   mutable QVector<qint32> _buckets;
+};
+
+
+
+#endif
@@ -1,5 +1,8 @@
 #include "exportdataframe.h"
 #include "exportdataframe_input.h"
+#include "exportdataframe_workblock.h"
+#include "exportdataframe_resultblock.h"
+#include "exportdataframe_serial.h"
 #include "dataframe.h"
 #include "dataframe_iterator.h"
 #include "datafactory.h"
@@ -15,14 +18,14 @@
 
 /*!
  * Return the total number of blocks this analytic must process as steps
- * or blocks of work. This implementation uses a work block for writing the
- * column names and a work block for writing each row.
+ * or blocks of work. This implementation uses a work block for each range
+ * of rows.
  */
 int ExportDataFrame::size() const
 {
    EDEBUG_FUNC(this);
 
-   return 1 + _in->rowSize();
+   return (_in->rowSize() + _blockRows - 1) / _blockRows;
 }
 
 
@@ -31,77 +34,111 @@ int ExportDataFrame::size() const
 
 
 /*!
- * Process the given index with a possible block of results if this analytic
- * produces work blocks. This implementation uses only the index of the result
- * block to determine which piece of work to do.
+ * Make a work block containing the names and values of the range of rows with
+ * the given index.
  *
- * @param result
+ * @param index
  */
-void ExportDataFrame::process(const EAbstractAnalyticBlock* result)
+std::unique_ptr<EAbstractAnalyticBlock> ExportDataFrame::makeWork(int index) const
 {
-   EDEBUG_FUNC(this,result);
+   EDEBUG_FUNC(this,index);
 
-   // write the column names in the first step
-   if ( result->index() == 0 )
-   {
-      // get column names
-      EMetaArray columnNames {_in->columnNames()};
+   // get the range of rows for this block
+   int first {index * _blockRows};
+   int last {qMin(first + _blockRows, _in->rowSize())};
 
-      // initialize output file stream
-      _stream.setDevice(_out);
-      _stream.setRealNumberPrecision(8);
+   // initialize the work block
+   std::unique_ptr<WorkBlock> ret(new WorkBlock(index));
+   ret->_values.resize((last - first) * _in->columnSize());
 
-      // write column names
-      for ( int i = 0; i < _in->columnSize(); i++ )
+   // load each row from dataframe
+   DataFrame::Iterator iterator(_in);
+   float* values {ret->_values.data()};
+
+   for ( int i = first; i < last; i++ )
+   {
+      ret->_rowNames.append(_in->rowName(i));
+      if ( _in->columnSize() > 0 )
       {
-         _stream << columnNames.at(i).toString() << "\t";
+         iterator.read(i);
+         std::copy(&iterator[0], &iterator[0] + _in->columnSize(), values);
+         values += _in->columnSize();
       }
-      _stream << "\n";
    }
 
-   // write each row to the output file in a separate step
-   else
-   {
-      // get row index
-      int i = result->index() - 1;
+   return std::unique_ptr<EAbstractAnalyticBlock>(ret.release());
+}
 
-      // get row name
-      QString rowName {_in->rowNames().at(i).toString()};
 
-      // load row from dataframe
-      DataFrame::Iterator iterator(_in);
-      iterator.read(i);
 
-      // write row name
-      _stream << rowName;
 
-      // write row values
-      for ( int j = 0; j < _in->columnSize(); j++ )
-      {
-         float value {iterator.at(j)};
-
-         // if value is NAN use the NAN token
-         if ( std::isnan(value) )
-         {
-            _stream << "\t" << _nanToken;
-         }
-
-         // else this is a normal floating point value
-         else
-         {
-            _stream << "\t" << value;
-         }
-      }
 
-      _stream << "\n";
-   }
+
+/*!
+ * Make an empty and uninitialized work block.
+ */
+std::unique_ptr<EAbstractAnalyticBlock> ExportDataFrame::makeWork() const
+{
+   EDEBUG_FUNC(this);
+
+   return std::unique_ptr<EAbstractAnalyticBlock>(new WorkBlock);
+}
+
+
+
+
+
+
+/*!
+ * Make an empty and uninitialized result block.
+ */
+std::unique_ptr<EAbstractAnalyticBlock> ExportDataFrame::makeResult() const
+{
+   EDEBUG_FUNC(this);
+
+   return std::unique_ptr<EAbstractAnalyticBlock>(new ResultBlock);
+}
+
+
+
+
+
+
+/*!
+ * Return true because each work block is only rows read from the input
+ * dataframe, which every node of an MPI run has opened.
+ */
+bool ExportDataFrame::isLocalWork() const
+{
+   EDEBUG_FUNC(this);
+
+   return true;
+}
+
+
+
+
+
+
+/*!
+ * Process the given result block by writing its formatted text to the output
+ * file with a single write.
+ *
+ * @param result
+ */
+void ExportDataFrame::process(const EAbstractAnalyticBlock* result)
+{
+   EDEBUG_FUNC(this,result);
+
+   // write the text of the result block
+   const ResultBlock* valid {result->cast<ResultBlock>()};
 
    // make sure writing output file worked
-   if ( _stream.status() != QTextStream::Ok )
+   if ( _out->write(valid->_text) != valid->_text.size() )
    {
       E_MAKE_EXCEPTION(e);
       e.setTitle(tr("File IO Error"));
-      e.setDetails(tr("Qt Text Stream encountered an unknown error."));
+      e.setDetails(tr("Failed writing output file: %1").arg(_out->errorString()));
       throw e;
    }
 }
@@ -126,19 +163,77 @@ EAbstractAnalyticInput* ExportDataFrame::makeInput()
 
 
 
+/*!
+ * Make a new serial object and return its pointer.
+ */
+EAbstractAnalyticSerial* ExportDataFrame::makeSerial()
+{
+   EDEBUG_FUNC(this);
+
+   return new Serial(this);
+}
+
+
+
+
+
+
 /*!
  * Initialize this analytic. This implementation checks to make sure the input
- * data object and output file have been set.
+ * data object has been set and determines the number of rows in each work
+ * block.
  */
 void ExportDataFrame::initialize()
 {
    EDEBUG_FUNC(this);
 
-   if ( !_in || !_out )
+   if ( !_in )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Invalid Argument"));
+      e.setDetails(tr("Did not get valid input argument."));
+      throw e;
+   }
+
+   // get the number of rows in each block
+   _blockRows = qMax(1, _blockValues / qMax(1, _in->columnSize()));
+}
+
+
+
+
+
+
+/*!
+ * Initialize the output file by writing the column names.
+ */
+void ExportDataFrame::initializeOutputs()
+{
+   EDEBUG_FUNC(this);
+
+   if ( !_out )
    {
       E_MAKE_EXCEPTION(e);
       e.setTitle(tr("Invalid Argument"));
-      e.setDetails(tr("Did not get valid input and/or output arguments."));
+      e.setDetails(tr("Did not get valid output argument."));
+      throw e;
+   }
+
+   // write column names
+   QByteArray text;
+
+   for ( int i = 0; i < _in->columnSize(); i++ )
+   {
+      text.append(_in->columnName(i).toUtf8()).append('\t');
+   }
+   text.append('\n');
+
+   // make sure writing output file worked
+   if ( _out->write(text) != text.size() )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("File IO Error"));
+      e.setDetails(tr("Failed writing output file: %1").arg(_out->errorString()));
       throw e;
    }
 }
@@ -12,21 +12,39 @@
  * value separated by whitespace, and the first row and column containing the
  * row names and column names, respectively. Elements which are NAN in the
  * dataframe are written as the given NAN token.
+ *
+ * Each block of work is a range of rows which is formatted as text by the
+ * serial workers, so formatting runs on as many threads or nodes as the run
+ * provides. The formatted text of each block is written to the output file in
+ * order with a single write.
  */
 class ExportDataFrame : public EAbstractAnalytic
 {
    Q_OBJECT
 public:
    class Input;
+   class WorkBlock;
+   class ResultBlock;
+   class Serial;
    virtual int size() const override final;
+   virtual std::unique_ptr<EAbstractAnalyticBlock> makeWork(int index) const override final;
+   virtual std::unique_ptr<EAbstractAnalyticBlock> makeWork() const override final;
+   virtual std::unique_ptr<EAbstractAnalyticBlock> makeResult() const override final;
+   virtual bool isLocalWork() const override final;
    virtual void process(const EAbstractAnalyticBlock* result) override final;
    virtual EAbstractAnalyticInput* makeInput() override final;
+   virtual EAbstractAnalyticSerial* makeSerial() override final;
    virtual void initialize() override final;
+   virtual void initializeOutputs() override final;
 private:
-   /**
-    * Workspace variables to write to the output file
+   /*!
+    * The approximate number of values in the range of rows of each work block.
+    */
+   constexpr static int _blockValues {262144};
+   /*!
+    * The number of rows in the range of each work block.
     */
-   QTextStream _stream;
+   int _blockRows {1};
    /*!
     * Pointer to the input dataframe.
     */
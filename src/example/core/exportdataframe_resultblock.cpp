@@ -0,0 +1,73 @@
+#include "exportdataframe_resultblock.h"
+#include <cstring>
+
+
+
+//
+
+
+
+
+
+
+/*!
+ * Constructs a new result block with the given index.
+ *
+ * @param index The index for this new block.
+ */
+ExportDataFrame::ResultBlock::ResultBlock(int index):
+   EAbstractAnalyticBlock(index)
+{
+   EDEBUG_FUNC(this,index);
+}
+
+
+
+
+
+
+/*!
+ * Returns the size in bytes of this block's text.
+ */
+qint64 ExportDataFrame::ResultBlock::rawSize() const
+{
+   EDEBUG_FUNC(this);
+
+   return _text.size();
+}
+
+
+
+
+
+
+/*!
+ * Copies this block's text to the given pointer.
+ *
+ * @param data Pointer to the memory this block's text is copied to.
+ */
+void ExportDataFrame::ResultBlock::writeRaw(char* data) const
+{
+   EDEBUG_FUNC(this,static_cast<void*>(data));
+
+   memcpy(data,_text.constData(),_text.size());
+}
+
+
+
+
+
+
+/*!
+ * Copies in this block's text from the given raw memory.
+ *
+ * @param data Pointer to the raw memory this block's text is copied from.
+ *
+ * @param size The size in bytes of the given raw memory.
+ */
+void ExportDataFrame::ResultBlock::readRaw(const char* data, qint64 size)
+{
+   EDEBUG_FUNC(this,static_cast<const void*>(data),size);
+
+   _text = QByteArray(data,static_cast<int>(size));
+}
@@ -0,0 +1,35 @@
+#ifndef EXPORTDATAFRAME_RESULTBLOCK_H
+#define EXPORTDATAFRAME_RESULTBLOCK_H
+#include "exportdataframe.h"
+//
+
+
+
+/*!
+ * This implements the result block of the export dataframe analytic. It
+ * contains the UTF-8 text of its range of rows exactly as it is written to the
+ * output file. The text is stored as raw data so no copying or conversion is
+ * done when it is sent between processes.
+ */
+class ExportDataFrame::ResultBlock : public EAbstractAnalyticBlock
+{
+   Q_OBJECT
+public:
+   /*!
+    * Constructs a new result block in an uninitialized null state.
+    */
+   explicit ResultBlock() = default;
+   explicit ResultBlock(int index);
+   /*!
+    * The formatted text of all rows in this block's range.
+    */
+   QByteArray _text;
+protected:
+   virtual qint64 rawSize() const override final;
+   virtual void writeRaw(char* data) const override final;
+   virtual void readRaw(const char* data, qint64 size) override final;
+};
+
+
+
+#endif
@@ -0,0 +1,493 @@
+#include "exportdataframe_serial.h"
+#include "exportdataframe_workblock.h"
+#include "exportdataframe_resultblock.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+
+
+//
+
+
+
+
+
+
+/*!
+ * The rounded up inverse powers of 5 used by the shortest digits search for
+ * positive binary exponents, where entry i is 2^(pow5Bits(i)-1+59)/5^i plus 1.
+ */
+const quint64 ExportDataFrame::Serial::_pow5InvSplit[31]
+{
+   576460752303423489ull, 461168601842738791ull, 368934881474191033ull,
+   295147905179352826ull, 472236648286964522ull, 377789318629571618ull,
+   302231454903657294ull, 483570327845851670ull, 386856262276681336ull,
+   309485009821345069ull, 495176015714152110ull, 396140812571321688ull,
+   316912650057057351ull, 507060240091291761ull, 405648192073033409ull,
+   324518553658426727ull, 519229685853482763ull, 415383748682786211ull,
+   332306998946228969ull, 531691198313966350ull, 425352958651173080ull,
+   340282366920938464ull, 544451787073501542ull, 435561429658801234ull,
+   348449143727040987ull, 557518629963265579ull, 446014903970612463ull,
+   356811923176489971ull, 570899077082383953ull, 456719261665907162ull,
+   365375409332725730ull
+};
+
+
+
+
+
+
+/*!
+ * The powers of 5 used by the shortest digits search for negative binary
+ * exponents, where entry i is the top 61 bits of 5^i.
+ */
+const quint64 ExportDataFrame::Serial::_pow5Split[47]
+{
+   1152921504606846976ull, 1441151880758558720ull, 1801439850948198400ull,
+   2251799813685248000ull, 1407374883553280000ull, 1759218604441600000ull,
+   2199023255552000000ull, 1374389534720000000ull, 1717986918400000000ull,
+   2147483648000000000ull, 1342177280000000000ull, 1677721600000000000ull,
+   2097152000000000000ull, 1310720000000000000ull, 1638400000000000000ull,
+   2048000000000000000ull, 1280000000000000000ull, 1600000000000000000ull,
+   2000000000000000000ull, 1250000000000000000ull, 1562500000000000000ull,
+   1953125000000000000ull, 1220703125000000000ull, 1525878906250000000ull,
+   1907348632812500000ull, 1192092895507812500ull, 1490116119384765625ull,
+   1862645149230957031ull, 1164153218269348144ull, 1455191522836685180ull,
+   1818989403545856475ull, 2273736754432320594ull, 1421085471520200371ull,
+   1776356839400250464ull, 2220446049250313080ull, 1387778780781445675ull,
+   1734723475976807094ull, 2168404344971008868ull, 1355252715606880542ull,
+   1694065894508600678ull, 2117582368135750847ull, 1323488980084844279ull,
+   1654361225106055349ull, 2067951531382569187ull, 1292469707114105741ull,
+   1615587133892632177ull, 2019483917365790221ull
+};
+
+
+
+
+
+
+/*!
+ * Constructs a new serial object with the given export dataframe as its
+ * parent.
+ *
+ * @param parent The parent export dataframe object for this new serial object.
+ */
+ExportDataFrame::Serial::Serial(ExportDataFrame* parent):
+   EAbstractAnalyticSerial(parent),
+   _base(parent)
+{
+   EDEBUG_FUNC(this,parent);
+}
+
+
+
+
+
+
+/*!
+ * Implements the interface that reads in the given work block and saves the
+ * results in a new results block. This implementation formats each row of the
+ * work block as a line of text, with the row name followed by each value
+ * separated by tabs.
+ *
+ * @param block Pointer to work block that is used to produce the returned
+ *              results block.
+ *
+ * @return Pointer to results block produced from the given work block.
+ */
+std::unique_ptr<EAbstractAnalyticBlock> ExportDataFrame::Serial::execute(const EAbstractAnalyticBlock* block)
+{
+   EDEBUG_FUNC(this,block);
+
+   // cast the given work block to its implementation type
+   const WorkBlock* work {block->cast<WorkBlock>()};
+
+   // initialize the result block, reserving enough text for most values
+   const QByteArray nanToken {_base->_nanToken.toUtf8()};
+   const int columnSize {_base->_in->columnSize()};
+   std::unique_ptr<ResultBlock> ret(new ResultBlock(work->index()));
+   ret->_text.reserve(work->_values.size()*10);
+
+   // format each row
+   const float* values {work->_values.constData()};
+   for ( auto& rowName : work->_rowNames )
+   {
+      // write row name
+      ret->_text.append(rowName.toUtf8());
+
+      // write row values
+      for ( int j = 0; j < columnSize; j++ )
+      {
+         float value {*values++};
+         ret->_text.append('\t');
+
+         // if value is NAN use the NAN token
+         if ( std::isnan(value) )
+         {
+            ret->_text.append(nanToken);
+         }
+
+         // else this is a normal floating point value
+         else
+         {
+            appendFloat(ret->_text,value);
+         }
+      }
+
+      ret->_text.append('\n');
+   }
+
+   // return the result block
+   return std::unique_ptr<EAbstractAnalyticBlock>(ret.release());
+}
+
+
+
+
+
+
+/*!
+ * Appends the given value to the given text using the fewest significant
+ * digits that read back as exactly the same value. The value is written the
+ * same way the printf %g conversion would write it with a precision of at
+ * least 6, so the text only differs from a fixed precision where more digits
+ * are needed to read back the same value. The conversion is independent of the
+ * system locale and allocates nothing besides the appended text.
+ *
+ * @param text The text the formatted value is appended to.
+ *
+ * @param value The value that is formatted.
+ */
+void ExportDataFrame::Serial::appendFloat(QByteArray& text, float value)
+{
+   // write the sign and handle the values that have no digits to search for
+   if ( std::signbit(value) )
+   {
+      text.append('-');
+      value = -value;
+   }
+   if ( std::isinf(value) )
+   {
+      text.append("inf");
+      return;
+   }
+   if ( value == 0.0f )
+   {
+      text.append('0');
+      return;
+   }
+
+   // find the shortest digits and remove any trailing zeros from them
+   quint32 digits;
+   int exponent;
+   shortestDigits(value,digits,exponent);
+   while ( digits%10 == 0 )
+   {
+      digits /= 10;
+      ++exponent;
+   }
+
+   // write the digits into a buffer, getting the decimal exponent of the first digit
+   char digitText[10] {};
+   int count {0};
+   for (quint32 rest = digits; rest > 0 ;rest /= 10)
+   {
+      ++count;
+   }
+   for (int i = count - 1; i >= 0 ;--i)
+   {
+      digitText[i] = static_cast<char>('0' + digits%10);
+      digits /= 10;
+   }
+   const int point {exponent + count - 1};
+
+   // use scientific notation if %g would with the precision of the digits found,
+   // but never less than 6
+   char buffer[32];
+   int size {0};
+   if ( point < -4 || point >= std::max(count,6) )
+   {
+      buffer[size++] = digitText[0];
+      if ( count > 1 )
+      {
+         buffer[size++] = '.';
+         for (int i = 1; i < count ;++i)
+         {
+            buffer[size++] = digitText[i];
+         }
+      }
+      buffer[size++] = 'e';
+      buffer[size++] = point < 0 ? '-' : '+';
+      const int magnitude {std::abs(point)};
+      if ( magnitude >= 10 )
+      {
+         buffer[size++] = static_cast<char>('0' + magnitude/10);
+      }
+      else
+      {
+         buffer[size++] = '0';
+      }
+      buffer[size++] = static_cast<char>('0' + magnitude%10);
+   }
+
+   // else write the digits in positional notation, padding with zeros on either side
+   // of the decimal point as needed
+   else if ( point >= 0 )
+   {
+      for (int i = 0; i <= point || i < count ;++i)
+      {
+         if ( i == point + 1 )
+         {
+            buffer[size++] = '.';
+         }
+         buffer[size++] = i < count ? digitText[i] : '0';
+      }
+   }
+   else
+   {
+      buffer[size++] = '0';
+      buffer[size++] = '.';
+      for (int i = -1; i > point ;--i)
+      {
+         buffer[size++] = '0';
+      }
+      for (int i = 0; i < count ;++i)
+      {
+         buffer[size++] = digitText[i];
+      }
+   }
+   text.append(buffer,size);
+}
+
+
+
+
+
+
+/*!
+ * Finds the shortest decimal digits that read back as the given value, using
+ * the Ryu algorithm of Ulf Adams. Of all digit strings of the shortest length
+ * the one closest to the value is chosen. The value must be finite and greater
+ * than zero.
+ *
+ * @param value The value whose shortest digits are found.
+ *
+ * @param digits Set to the shortest digits as an integer.
+ *
+ * @param exponent Set to the decimal exponent the digits are multiplied by.
+ */
+void ExportDataFrame::Serial::shortestDigits(float value, quint32& digits, int& exponent)
+{
+   // split the value into its binary mantissa and exponent, scaled by 4 so the
+   // halfway points to its neighbors are integers
+   quint32 bits;
+   std::memcpy(&bits,&value,sizeof(bits));
+   const quint32 ieeeMantissa {bits & ((1u << 23) - 1)};
+   const int ieeeExponent {static_cast<int>((bits >> 23) & 0xff)};
+   int e2;
+   quint32 m2;
+   if ( ieeeExponent == 0 )
+   {
+      e2 = 1 - 127 - 23 - 2;
+      m2 = ieeeMantissa;
+   }
+   else
+   {
+      e2 = ieeeExponent - 127 - 23 - 2;
+      m2 = (1u << 23) | ieeeMantissa;
+   }
+   const bool acceptBounds {(m2 & 1) == 0};
+   const quint32 mv {4*m2};
+   const quint32 mp {4*m2 + 2};
+   const quint32 mmShift {ieeeMantissa != 0 || ieeeExponent <= 1 ? 1u : 0u};
+   const quint32 mm {4*m2 - 1 - mmShift};
+
+   // convert the value and the halfway points to its neighbors to decimal, keeping
+   // track of whether the digits cut off from them are all zeros
+   quint32 vr, vp, vm;
+   int e10;
+   bool vmIsTrailingZeros {false};
+   bool vrIsTrailingZeros {false};
+   quint32 lastRemovedDigit {0};
+   if ( e2 >= 0 )
+   {
+      const int q {(e2*78913) >> 18};
+      e10 = q;
+      const int k {_pow5InvBitCount + pow5Bits(q) - 1};
+      const int i {-e2 + q + k};
+      vr = mulShift(mv,_pow5InvSplit[q],i);
+      vp = mulShift(mp,_pow5InvSplit[q],i);
+      vm = mulShift(mm,_pow5InvSplit[q],i);
+      if ( q != 0 && (vp - 1)/10 <= vm/10 )
+      {
+         const int l {_pow5InvBitCount + pow5Bits(q - 1) - 1};
+         lastRemovedDigit = mulShift(mv,_pow5InvSplit[q - 1],-e2 + q - 1 + l)%10;
+      }
+      if ( q <= 9 )
+      {
+         if ( mv%5 == 0 )
+         {
+            vrIsTrailingZeros = isMultipleOfPow5(mv,q);
+         }
+         else if ( acceptBounds )
+         {
+            vmIsTrailingZeros = isMultipleOfPow5(mm,q);
+         }
+         else if ( isMultipleOfPow5(mp,q) )
+         {
+            --vp;
+         }
+      }
+   }
+   else
+   {
+      const int q {(-e2*732923) >> 20};
+      e10 = q + e2;
+      const int i {-e2 - q};
+      const int k {pow5Bits(i) - _pow5BitCount};
+      int j {q - k};
+      vr = mulShift(mv,_pow5Split[i],j);
+      vp = mulShift(mp,_pow5Split[i],j);
+      vm = mulShift(mm,_pow5Split[i],j);
+      if ( q != 0 && (vp - 1)/10 <= vm/10 )
+      {
+         j = q - 1 - (pow5Bits(i + 1) - _pow5BitCount);
+         lastRemovedDigit = mulShift(mv,_pow5Split[i + 1],j)%10;
+      }
+      if ( q <= 1 )
+      {
+         vrIsTrailingZeros = true;
+         if ( acceptBounds )
+         {
+            vmIsTrailingZeros = mmShift == 1;
+         }
+         else
+         {
+            --vp;
+         }
+      }
+      else if ( q < 31 )
+      {
+         vrIsTrailingZeros = (mv & ((1u << (q - 1)) - 1)) == 0;
+      }
+   }
+
+   // remove digits while the halfway points still differ, then round the value's
+   // remaining digits to the nearest, breaking exact ties to even
+   int removed {0};
+   if ( vmIsTrailingZeros || vrIsTrailingZeros )
+   {
+      while ( vp/10 > vm/10 )
+      {
+         vmIsTrailingZeros &= vm%10 == 0;
+         vrIsTrailingZeros &= lastRemovedDigit == 0;
+         lastRemovedDigit = vr%10;
+         vr /= 10;
+         vp /= 10;
+         vm /= 10;
+         ++removed;
+      }
+      if ( vmIsTrailingZeros )
+      {
+         while ( vm%10 == 0 )
+         {
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = vr%10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+         }
+      }
+      if ( vrIsTrailingZeros && lastRemovedDigit == 5 && vr%2 == 0 )
+      {
+         lastRemovedDigit = 4;
+      }
+      const bool roundUp {(vr == vm && (!acceptBounds || !vmIsTrailingZeros))
+                          || lastRemovedDigit >= 5};
+      digits = vr + roundUp;
+   }
+   else
+   {
+      while ( vp/10 > vm/10 )
+      {
+         lastRemovedDigit = vr%10;
+         vr /= 10;
+         vp /= 10;
+         vm /= 10;
+         ++removed;
+      }
+      digits = vr + (vr == vm || lastRemovedDigit >= 5);
+   }
+   exponent = e10 + removed;
+}
+
+
+
+
+
+
+/*!
+ * Multiplies the given value by the given 64 bit factor and shifts the 96 bit
+ * product right by the given amount, which must be at least 32.
+ *
+ * @param value The value that is multiplied.
+ *
+ * @param factor The factor the value is multiplied by.
+ *
+ * @param shift The number of bits the product is shifted right.
+ *
+ * @return The low 32 bits of the shifted product.
+ */
+quint32 ExportDataFrame::Serial::mulShift(quint32 value, quint64 factor, int shift)
+{
+   const quint64 low {static_cast<quint64>(value)*static_cast<quint32>(factor)};
+   const quint64 high {static_cast<quint64>(value)*static_cast<quint32>(factor >> 32)};
+   return static_cast<quint32>(((low >> 32) + high) >> (shift - 32));
+}
+
+
+
+
+
+
+/*!
+ * Returns the number of bits of 5 raised to the given exponent, or 1 for an
+ * exponent of 0.
+ *
+ * @param exponent The exponent of 5, which must be between 0 and 3528.
+ *
+ * @return The number of bits of 5 raised to the given exponent.
+ */
+int ExportDataFrame::Serial::pow5Bits(int exponent)
+{
+   return ((exponent*1217359) >> 19) + 1;
+}
+
+
+
+
+
+
+/*!
+ * Tests if the given value is a multiple of 5 raised to the given exponent.
+ *
+ * @param value The value that is tested.
+ *
+ * @param exponent The exponent of 5.
+ *
+ * @return True if the value is a multiple of 5 raised to the exponent or false
+ *         otherwise.
+ */
+bool ExportDataFrame::Serial::isMultipleOfPow5(quint32 value, int exponent)
+{
+   int count {0};
+   while ( value%5 == 0 )
+   {
+      value /= 5;
+      ++count;
+   }
+   return count >= exponent;
+}
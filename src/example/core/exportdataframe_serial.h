@@ -0,0 +1,55 @@
+#ifndef EXPORTDATAFRAME_SERIAL_H
+#define EXPORTDATAFRAME_SERIAL_H
+#include "exportdataframe.h"
+//
+
+
+
+/*!
+ * This implements the serial working class for its parent export dataframe
+ * analytic. It formats the range of rows given by a work block as text into a
+ * single buffer, writing each value with the fewest digits that read back as
+ * the same value. The shortest digits are found with the Ryu algorithm of Ulf
+ * Adams.
+ */
+class ExportDataFrame::Serial : public EAbstractAnalyticSerial
+{
+   Q_OBJECT
+public:
+   explicit Serial(ExportDataFrame* parent);
+   virtual std::unique_ptr<EAbstractAnalyticBlock> execute(const EAbstractAnalyticBlock* block) override final;
+private:
+   static void appendFloat(QByteArray& text, float value);
+   static void shortestDigits(float value, quint32& digits, int& exponent);
+   static quint32 mulShift(quint32 value, quint64 factor, int shift);
+   static int pow5Bits(int exponent);
+   static bool isMultipleOfPow5(quint32 value, int exponent);
+   /*!
+    * The number of bits kept of each inverse power of 5 in the table used for
+    * positive binary exponents.
+    */
+   constexpr static int _pow5InvBitCount {59};
+   /*!
+    * The number of bits kept of each power of 5 in the table used for negative
+    * binary exponents.
+    */
+   constexpr static int _pow5BitCount {61};
+   /*!
+    * The rounded up inverse powers of 5 from 5^0 to 5^30, scaled so each has
+    * _pow5InvBitCount significant bits.
+    */
+   static const quint64 _pow5InvSplit[31];
+   /*!
+    * The powers of 5 from 5^0 to 5^46, truncated or scaled to their top
+    * _pow5BitCount bits.
+    */
+   static const quint64 _pow5Split[47];
+   /*!
+    * Pointer to this serial object's parent export dataframe analytic.
+    */
+   ExportDataFrame* _base;
+};
+
+
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef EXPORTDATAFRAME_WORKBLOCK_H
+#define EXPORTDATAFRAME_WORKBLOCK_H
+#include "exportdataframe.h"
+//
+
+
+
+/*!
+ * This implements the work block of the export dataframe analytic. It contains
+ * the names and values of a range of rows from the input dataframe, with the
+ * values of all rows stored contiguously in row order.
+ */
+class ExportDataFrame::WorkBlock : public EAbstractAnalyticBlock
+{
+   Q_OBJECT
+public:
+   /*!
+    * Constructs a new work block in an uninitialized null state.
+    */
+   explicit WorkBlock() = default;
+   explicit WorkBlock(int index);
+   /*!
+    * The names of all rows in this block's range.
+    */
+   QStringList _rowNames;
+   /*!
+    * The values of all rows in this block's range, one full row after another.
+    */
+   QVector<float> _values;
+protected:
+   virtual void write(QDataStream& stream) const override final;
+   virtual void read(QDataStream& stream) override final;
+};
+
+
+
+#endif
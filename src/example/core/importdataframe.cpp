@@ -1,5 +1,8 @@
 #include "importdataframe.h"
 #include "importdataframe_input.h"
+#include "importdataframe_workblock.h"
+#include "importdataframe_resultblock.h"
+#include "importdataframe_serial.h"
 #include "datafactory.h"
 #include "dataframe_iterator.h"
 
@@ -14,15 +17,14 @@
 
 /*!
  * Return the total number of blocks this analytic must process as steps
- * or blocks of work. This implementation uses a work block for reading
- * each line of the input file, plus one work block to create the output
- * data object.
+ * or blocks of work. This implementation uses a work block for each range
+ * of lines in the input file.
  */
 int ImportDataFrame::size() const
 {
    EDEBUG_FUNC(this);
 
-   return _numLines + 1;
+   return qMax(_offsets.size() - 1,0);
 }
 
 
@@ -31,132 +33,87 @@ int ImportDataFrame::size() const
 
 
 /*!
- * Process the given index with a possible block of results if this analytic
- * produces work blocks. This implementation uses only the index of the result
- * block to determine which piece of work to do.
+ * Make a work block for the range of lines in the input file with the given
+ * index.
  *
- * @param result
+ * @param index
  */
-void ImportDataFrame::process(const EAbstractAnalyticBlock* result)
+std::unique_ptr<EAbstractAnalyticBlock> ImportDataFrame::makeWork(int index) const
 {
-   EDEBUG_FUNC(this, result);
+   EDEBUG_FUNC(this,index);
 
-   // read or create the column names in the first step
-   if ( result->index() == 0 )
-   {
-      // seek to the beginning of the input file
-      _stream.seek(0);
+   return std::unique_ptr<EAbstractAnalyticBlock>(new WorkBlock(index,_offsets.at(index),_offsets.at(index + 1)));
+}
 
-      // read column names from first line
-      QString line = _stream.readLine();
-      auto words = line.splitRef(QRegExp("\\s+"), QString::SkipEmptyParts);
 
-      // parse the column names
-      _columnSize = words.size();
 
-      for ( auto& word : words )
-      {
-         _columnNames.append(word.toString());
-      }
 
-      // make sure reading input file worked
-      if ( _stream.status() != QTextStream::Ok )
-      {
-         E_MAKE_EXCEPTION(e);
-         e.setTitle(tr("File IO Error"));
-         e.setDetails(tr("Qt Text Stream encountered an unknown error."));
-         throw e;
-      }
-   }
 
-   // read each row from the input file in a separate step
-   else if ( result->index() < _numLines )
-   {
-      // read a line from the input file
-      QString line = _stream.readLine();
-      auto words = line.splitRef(QRegExp("\\s+"), QString::SkipEmptyParts);
 
-      // make sure the number of words matches expected column size
-      if ( words.size() == _columnSize + 1 )
-      {
-         // read row from text file
-         Row row(_columnSize);
-
-         for ( int i = 1; i < words.size(); ++i )
-         {
-            // if word matches the nan token then set it as such
-            if ( words.at(i) == _nanToken )
-            {
-               row.values[i-1] = NAN;
-            }
-
-            // else this is a normal floating point value
-            else
-            {
-               // read in the floating point value
-               bool ok;
-               row.values[i-1] = words.at(i).toDouble(&ok);
-
-               // make sure reading worked
-               if ( !ok )
-               {
-                  E_MAKE_EXCEPTION(e);
-                  e.setTitle(tr("Parsing Error"));
-                  e.setDetails(tr("Failed to read value \"%1\" for row %2.")
-                     .arg(words.at(i).toString())
-                     .arg(words.at(0).toString()));
-                  throw e;
-               }
-            }
-         }
-
-         // append row data and row name
-         _rows.append(row);
-         _rowNames.append(words.at(0).toString());
-      }
+/*!
+ * Make an empty and uninitialized work block.
+ */
+std::unique_ptr<EAbstractAnalyticBlock> ImportDataFrame::makeWork() const
+{
+   EDEBUG_FUNC(this);
 
-      // otherwise throw an error
-      else
-      {
-         E_MAKE_EXCEPTION(e);
-         e.setTitle(tr("Parsing Error"));
-         e.setDetails(tr("Encountered row with incorrect amount of fields. "
-                         "Read in %1 fields when it should have been %2. Row name is %3.")
-            .arg(words.size()-1)
-            .arg(_columnSize)
-            .arg(words.at(0).toString()));
-         throw e;
-      }
+   return std::unique_ptr<EAbstractAnalyticBlock>(new WorkBlock);
+}
 
-      // make sure reading input file worked
-      if ( _stream.status() != QTextStream::Ok )
-      {
-         E_MAKE_EXCEPTION(e);
-         e.setTitle(tr("File IO Error"));
-         e.setDetails(tr("Qt Text Stream encountered an unknown error."));
-         throw e;
-      }
-   }
 
-   // create the output data object in the final step
-   else if ( result->index() == _numLines )
-   {
-      // initialize dataframe
-      _out->initialize(_rowNames, _columnNames);
 
-      // iterate through each row
-      DataFrame::Iterator iterator(_out);
 
-      for ( int i = 0; i < _out->rowSize(); ++i )
-      {
-         // save each row to dataframe
-         for ( int j = 0; j < _out->columnSize(); ++j )
-         {
-            iterator[j] = _rows[i].values[j];
-         }
 
-         iterator.write(i);
-      }
+
+/*!
+ * Make an empty and uninitialized result block.
+ */
+std::unique_ptr<EAbstractAnalyticBlock> ImportDataFrame::makeResult() const
+{
+   EDEBUG_FUNC(this);
+
+   return std::unique_ptr<EAbstractAnalyticBlock>(new ResultBlock);
+}
+
+
+
+
+
+
+/*!
+ * Process the given result block of parsed rows, writing each row to the
+ * output dataframe after all rows of the previous result blocks. The row
+ * names of the output dataframe are saved once the last result block is
+ * processed.
+ *
+ * @param result
+ */
+void ImportDataFrame::process(const EAbstractAnalyticBlock* result)
+{
+   EDEBUG_FUNC(this, result);
+
+   // cast the result block to its implementation type
+   const ResultBlock* valid {result->cast<ResultBlock>()};
+
+   // grow the output dataframe to hold the new rows
+   int first {_rowNames.size()};
+   _rowNames.append(valid->_rowNames);
+   _out->resizeRows(_rowNames.size());
+
+   // write each row to the output dataframe
+   DataFrame::Iterator iterator(_out);
+
+   for ( int i = 0; i < valid->_rowNames.size(); ++i )
+   {
+      const float* values {valid->_values.constData() + static_cast<qint64>(i) * _columnSize};
+      std::copy(values, values + _columnSize, &iterator[0]);
+      iterator.write(first + i);
+   }
+
+   // save the row and column names once the last range has been written
+   if ( result->index() == size() - 1 )
+   {
+      _out->initialize(_rowNames, _columnNames);
    }
 }
 
@@ -180,41 +137,111 @@ EAbstractAnalyticInput* ImportDataFrame::makeInput()
 
 
 
+/*!
+ * Make a new serial object and return its pointer.
+ */
+EAbstractAnalyticSerial* ImportDataFrame::makeSerial()
+{
+   EDEBUG_FUNC(this);
+
+   return new Serial(this);
+}
+
+
+
+
+
+
 /*!
  * Initialize this analytic. This implementation checks to make sure the input
- * file and output data object have been set.
+ * file has been set, reads the column names from its first line, and splits
+ * the remaining lines into ranges. Only the start of each range is read to
+ * find where its line begins, so the file is not read in full.
  */
 void ImportDataFrame::initialize()
 {
    EDEBUG_FUNC(this);
 
-   // make sure input/output arguments are valid
-   if ( !_in || !_out )
+   // make sure input argument is valid
+   if ( !_in )
    {
       E_MAKE_EXCEPTION(e);
       e.setTitle(tr("Invalid Argument"));
-      e.setDetails(tr("Did not get valid input and/or output arguments."));
+      e.setDetails(tr("Did not get valid input argument."));
+      throw e;
+   }
+
+   // read column names from first line
+   _in->seek(0);
+   QString line {QString::fromUtf8(_in->readLine())};
+   _columnNames = line.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+   _columnSize = _columnNames.size();
+
+   // make sure there is at least one column
+   if ( _columnSize == 0 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Parsing Error"));
+      e.setDetails(tr("Input file does not contain any column names."));
       throw e;
    }
 
-   // initialize input file stream
-   _stream.setDevice(_in);
+   // split the remaining lines into ranges that each begin at the start of a line
+   const qint64 fileSize {_in->size()};
+   _offsets.clear();
+   _offsets.append(_in->pos());
 
-   // count the number of lines in the input file
-   _numLines = 0;
+   while ( _offsets.last() + _rangeSize < fileSize )
+   {
+      // move to the start of the line after the approximate end of this range
+      if ( !_in->seek(_offsets.last() + _rangeSize - 1) )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("File IO Error"));
+         e.setDetails(tr("Failed seeking in input file: %1").arg(_in->errorString()));
+         throw e;
+      }
+      _in->readLine();
+
+      // stop if the last line reaches the end of the file
+      if ( _in->pos() >= fileSize )
+      {
+         break;
+      }
+      _offsets.append(_in->pos());
+   }
 
-   while ( !_stream.atEnd() )
+   // end the last range at the end of the file, leaving no ranges if there are no
+   // lines after the column names
+   if ( _offsets.last() < fileSize )
    {
-      _stream.readLine();
-      _numLines++;
+      _offsets.append(fileSize);
    }
+}
+
+
+
 
-   // make sure reading input file worked
-   if ( _stream.status() != QTextStream::Ok )
+
+
+/*!
+ * Initialize the output dataframe with the column names and no rows. Rows are
+ * added as each result block is processed.
+ */
+void ImportDataFrame::initializeOutputs()
+{
+   EDEBUG_FUNC(this);
+
+   // make sure output argument is valid
+   if ( !_out )
    {
       E_MAKE_EXCEPTION(e);
-      e.setTitle(tr("File IO Error"));
-      e.setDetails(tr("Qt Text Stream encountered an unknown error."));
+      e.setTitle(tr("Invalid Argument"));
+      e.setDetails(tr("Did not get valid output argument."));
       throw e;
    }
+
+   // initialize dataframe
+   _rowNames.clear();
+   _out->initialize(QStringList(), _columnNames);
 }
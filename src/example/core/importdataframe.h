@@ -12,38 +12,51 @@
  * line, each value separated by whitespace, and the first row and column
  * containing the row names and column names, respectively. Elements which have
  * the given NAN token are read in as NAN.
+ *
+ * The lines after the column names are split into byte ranges which are each a
+ * block of work, so the text is parsed by as many serial workers as the run
+ * provides. Parsed rows are written to the output dataframe as their result
+ * blocks are processed in order, so the matrix is never held in memory.
  */
 class ImportDataFrame : public EAbstractAnalytic
 {
    Q_OBJECT
 public:
    class Input;
+   class WorkBlock;
+   class ResultBlock;
+   class Serial;
    virtual int size() const override final;
+   virtual std::unique_ptr<EAbstractAnalyticBlock> makeWork(int index) const override final;
+   virtual std::unique_ptr<EAbstractAnalyticBlock> makeWork() const override final;
+   virtual std::unique_ptr<EAbstractAnalyticBlock> makeResult() const override final;
    virtual void process(const EAbstractAnalyticBlock* result) override final;
    virtual EAbstractAnalyticInput* makeInput() override final;
+   virtual EAbstractAnalyticSerial* makeSerial() override final;
    virtual void initialize() override final;
+   virtual void initializeOutputs() override final;
 private:
-   /**
-    * Structure used to load row data
+   /*!
+    * The approximate size in bytes of the input file range parsed by each work
+    * block. Ranges always begin at the start of a line.
     */
-   struct Row
-   {
-      Row() = default;
-      Row(int size)
-      {
-         values.resize(size);
-      }
-
-      QVector<float> values;
-   };
-   /**
-    * Workspace variables to read from the input file.
+   constexpr static qint64 _rangeSize {4*1024*1024};
+   /*!
+    * Byte offsets of the input file where each range of lines begins, followed by
+    * the size of the file as the end of the last range.
+    */
+   QVector<qint64> _offsets;
+   /*!
+    * The number of columns read from the first line of the input file.
     */
-   QTextStream _stream;
-   int _numLines {0};
    int _columnSize {0};
-   QVector<Row> _rows;
+   /*!
+    * The row names of all rows written to the output dataframe so far.
+    */
    QStringList _rowNames;
+   /*!
+    * The column names read from the first line of the input file.
+    */
    QStringList _columnNames;
    /*!
     * Pointer to the input text file.
@@ -0,0 +1,55 @@
+#include "importdataframe_resultblock.h"
+
+
+
+//
+
+
+
+
+
+
+/*!
+ * Constructs a new result block with the given index.
+ *
+ * @param index The index for this new block.
+ */
+ImportDataFrame::ResultBlock::ResultBlock(int index):
+   EAbstractAnalyticBlock(index)
+{
+   EDEBUG_FUNC(this,index);
+}
+
+
+
+
+
+
+/*!
+ * Writes this block's row names and values to the given data stream.
+ *
+ * @param stream The data stream that is used to write out data.
+ */
+void ImportDataFrame::ResultBlock::write(QDataStream& stream) const
+{
+   EDEBUG_FUNC(this,&stream);
+
+   stream << _rowNames << _values;
+}
+
+
+
+
+
+
+/*!
+ * Reads in this block's row names and values from the given data stream.
+ *
+ * @param stream The data stream that is used to read in data.
+ */
+void ImportDataFrame::ResultBlock::read(QDataStream& stream)
+{
+   EDEBUG_FUNC(this,&stream);
+
+   stream >> _rowNames >> _values;
+}
@@ -0,0 +1,37 @@
+#ifndef IMPORTDATAFRAME_RESULTBLOCK_H
+#define IMPORTDATAFRAME_RESULTBLOCK_H
+#include "importdataframe.h"
+//
+
+
+
+/*!
+ * This implements the result block of the import dataframe analytic. It
+ * contains the names and values of all rows parsed from the range of its work
+ * block, with the values of all rows stored contiguously in row order.
+ */
+class ImportDataFrame::ResultBlock : public EAbstractAnalyticBlock
+{
+   Q_OBJECT
+public:
+   /*!
+    * Constructs a new result block in an uninitialized null state.
+    */
+   explicit ResultBlock() = default;
+   explicit ResultBlock(int index);
+   /*!
+    * The names of all rows parsed.
+    */
+   QStringList _rowNames;
+   /*!
+    * The values of all rows parsed, one full row after another.
+    */
+   QVector<float> _values;
+protected:
+   virtual void write(QDataStream& stream) const override final;
+   virtual void read(QDataStream& stream) override final;
+};
+
+
+
+#endif
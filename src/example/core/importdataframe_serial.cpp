@@ -0,0 +1,292 @@
+#include "importdataframe_serial.h"
+#include "importdataframe_workblock.h"
+#include "importdataframe_resultblock.h"
+#include <cstring>
+#include <cmath>
+
+
+
+//
+
+
+
+
+
+
+/*!
+ * Constructs a new serial object with the given import dataframe as its
+ * parent.
+ *
+ * @param parent The parent import dataframe object for this new serial object.
+ */
+ImportDataFrame::Serial::Serial(ImportDataFrame* parent):
+   EAbstractAnalyticSerial(parent),
+   _base(parent)
+{
+   EDEBUG_FUNC(this,parent);
+}
+
+
+
+
+
+
+/*!
+ * Implements the interface that reads in the given work block and saves the
+ * results in a new results block. This implementation reads the range of the
+ * input file given by the work block and parses each line into a row name and
+ * its values. Blank lines are skipped.
+ *
+ * @param block Pointer to work block that is used to produce the returned
+ *              results block.
+ *
+ * @return Pointer to results block produced from the given work block.
+ */
+std::unique_ptr<EAbstractAnalyticBlock> ImportDataFrame::Serial::execute(const EAbstractAnalyticBlock* block)
+{
+   EDEBUG_FUNC(this,block);
+
+   // cast the given work block to its implementation type
+   const WorkBlock* work {block->cast<WorkBlock>()};
+
+   // open the input file separately so this serial object can run on any thread
+   QFile file(_base->_in->fileName());
+   if ( !file.open(QIODevice::ReadOnly) )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("File IO Error"));
+      e.setDetails(tr("Failed opening file %1: %2").arg(file.fileName()).arg(file.errorString()));
+      throw e;
+   }
+
+   // read the entire range of the work block with a single read
+   QByteArray data;
+   if ( file.seek(work->_begin) )
+   {
+      data = file.read(work->_end - work->_begin);
+   }
+   if ( data.size() != work->_end - work->_begin )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("File IO Error"));
+      e.setDetails(tr("Failed reading file %1: %2").arg(file.fileName()).arg(file.errorString()));
+      throw e;
+   }
+
+   // initialize the result block, reserving one value per four bytes of text as a
+   // rough upper bound
+   const QByteArray nanToken {_base->_nanToken.toUtf8()};
+   const int columnSize {_base->_columnSize};
+   std::unique_ptr<ResultBlock> ret(new ResultBlock(work->index()));
+   ret->_values.reserve(data.size()/4);
+
+   // parse each line of the range
+   auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+   const char* next {data.constData()};
+   const char* end {next + data.size()};
+   while ( next < end )
+   {
+      // find the end of the current line and move to the next one
+      const char* line {next};
+      const char* lineEnd {static_cast<const char*>(memchr(line,'\n',end - line))};
+      if ( !lineEnd )
+      {
+         lineEnd = end;
+      }
+      next = lineEnd + 1;
+
+      // skip leading whitespace and skip the line entirely if it is blank
+      while ( line < lineEnd && isSpace(*line) )
+      {
+         ++line;
+      }
+      if ( line == lineEnd )
+      {
+         continue;
+      }
+
+      // read the row name from the first word
+      const char* word {line};
+      while ( line < lineEnd && !isSpace(*line) )
+      {
+         ++line;
+      }
+      QString rowName {QString::fromUtf8(word,line - word)};
+
+      // read each remaining word as a value
+      int count {0};
+      while ( true )
+      {
+         while ( line < lineEnd && isSpace(*line) )
+         {
+            ++line;
+         }
+         if ( line == lineEnd )
+         {
+            break;
+         }
+         word = line;
+         while ( line < lineEnd && !isSpace(*line) )
+         {
+            ++line;
+         }
+
+         // only parse values while the row has not exceeded the column size
+         if ( ++count > columnSize )
+         {
+            continue;
+         }
+
+         // if word matches the nan token then set it as such
+         if ( line - word == nanToken.size() && memcmp(word,nanToken.constData(),line - word) == 0 )
+         {
+            ret->_values.append(NAN);
+         }
+
+         // else this is a normal floating point value
+         else
+         {
+            // read in the floating point value
+            bool ok;
+            ret->_values.append(parseFloat(word,line,&ok));
+
+            // make sure reading worked
+            if ( !ok )
+            {
+               E_MAKE_EXCEPTION(e);
+               e.setTitle(tr("Parsing Error"));
+               e.setDetails(tr("Failed to read value \"%1\" for row %2.")
+                  .arg(QString::fromUtf8(word,line - word))
+                  .arg(rowName));
+               throw e;
+            }
+         }
+      }
+
+      // make sure the number of values matches expected column size
+      if ( count != columnSize )
+      {
+         E_MAKE_EXCEPTION(e);
+         e.setTitle(tr("Parsing Error"));
+         e.setDetails(tr("Encountered row with incorrect amount of fields. "
+                         "Read in %1 fields when it should have been %2. Row name is %3.")
+            .arg(count)
+            .arg(columnSize)
+            .arg(rowName));
+         throw e;
+      }
+
+      // append the row name
+      ret->_rowNames.append(rowName);
+   }
+
+   // return the result block
+   return std::unique_ptr<EAbstractAnalyticBlock>(ret.release());
+}
+
+
+
+
+
+
+/*!
+ * Parses the given word as a floating point value. Plain decimal values whose
+ * digits fit exactly in a double are converted directly, which covers nearly
+ * all values in a numeric table. Any other word is given to Qt's locale
+ * independent conversion.
+ *
+ * @param begin Pointer to the first character of the word.
+ *
+ * @param end Pointer to one past the last character of the word.
+ *
+ * @param ok Pointer to a boolean that is set to true if parsing worked or false
+ *           otherwise.
+ *
+ * @return Parsed floating point value.
+ */
+float ImportDataFrame::Serial::parseFloat(const char* begin, const char* end, bool* ok)
+{
+   // exact powers of ten that can be represented by a double
+   static const double powers[] {
+      1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,
+      1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22
+   };
+
+   // read the sign
+   const char* p {begin};
+   bool negative {false};
+   if ( p < end && (*p == '-' || *p == '+') )
+   {
+      negative = *p == '-';
+      ++p;
+   }
+
+   // read the digits of the integer and fraction parts into the mantissa, giving up
+   // on the fast path if there are too many significant digits
+   quint64 mantissa {0};
+   int exponent {0};
+   int digits {0};
+   bool any {false};
+   bool fast {true};
+   bool fraction {false};
+   for (; p < end ;++p)
+   {
+      if ( *p == '.' && !fraction )
+      {
+         fraction = true;
+         continue;
+      }
+      if ( *p < '0' || *p > '9' )
+      {
+         break;
+      }
+      any = true;
+      if ( mantissa == 0 && *p == '0' )
+      {
+         exponent -= fraction;
+         continue;
+      }
+      if ( digits == 19 )
+      {
+         fast = false;
+         continue;
+      }
+      mantissa = mantissa*10 + static_cast<quint64>(*p - '0');
+      exponent -= fraction;
+      ++digits;
+   }
+
+   // read the exponent if there is one
+   if ( any && p < end && (*p == 'e' || *p == 'E') )
+   {
+      ++p;
+      bool negativeExponent {false};
+      if ( p < end && (*p == '-' || *p == '+') )
+      {
+         negativeExponent = *p == '-';
+         ++p;
+      }
+      int value {0};
+      bool anyExponent {false};
+      for (; p < end && *p >= '0' && *p <= '9' ;++p)
+      {
+         anyExponent = true;
+         value = qMin(value*10 + (*p - '0'),100000);
+      }
+      fast = fast && anyExponent;
+      exponent += negativeExponent ? -value : value;
+   }
+
+   // if the whole word was read and the mantissa and exponent are exact in a double
+   // then compute the value directly
+   if ( any && fast && p == end && mantissa <= (Q_UINT64_C(1) << 53) && exponent >= -22 && exponent <= 22 )
+   {
+      double value {static_cast<double>(mantissa)};
+      value = exponent < 0 ? value/powers[-exponent] : value*powers[exponent];
+      *ok = true;
+      return static_cast<float>(negative ? -value : value);
+   }
+
+   // else fall back to qt's conversion
+   return static_cast<float>(QByteArray::fromRawData(begin,static_cast<int>(end - begin)).toDouble(ok));
+}
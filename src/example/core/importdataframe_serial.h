@@ -0,0 +1,31 @@
+#ifndef IMPORTDATAFRAME_SERIAL_H
+#define IMPORTDATAFRAME_SERIAL_H
+#include "importdataframe.h"
+//
+
+
+
+/*!
+ * This implements the serial working class for its parent import dataframe
+ * analytic. It reads the range of the input text file given by a work block
+ * and parses every line within it into a row name and floating point values.
+ * Each serial object opens the input file itself so any number of them can
+ * parse ranges at the same time.
+ */
+class ImportDataFrame::Serial : public EAbstractAnalyticSerial
+{
+   Q_OBJECT
+public:
+   explicit Serial(ImportDataFrame* parent);
+   virtual std::unique_ptr<EAbstractAnalyticBlock> execute(const EAbstractAnalyticBlock* block) override final;
+private:
+   static float parseFloat(const char* begin, const char* end, bool* ok);
+   /*!
+    * Pointer to this serial object's parent import dataframe analytic.
+    */
+   ImportDataFrame* _base;
+};
+
+
+
+#endif
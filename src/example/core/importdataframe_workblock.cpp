@@ -0,0 +1,61 @@
+#include "importdataframe_workblock.h"
+
+
+
+//
+
+
+
+
+
+
+/*!
+ * Constructs a new work block with the given index and range of the input file.
+ *
+ * @param index The index for this new block.
+ *
+ * @param begin The byte offset where the range of this new block begins.
+ *
+ * @param end The byte offset where the range of this new block ends.
+ */
+ImportDataFrame::WorkBlock::WorkBlock(int index, qint64 begin, qint64 end):
+   EAbstractAnalyticBlock(index),
+   _begin(begin),
+   _end(end)
+{
+   EDEBUG_FUNC(this,index,begin,end);
+}
+
+
+
+
+
+
+/*!
+ * Writes this block's range to the given data stream.
+ *
+ * @param stream The data stream that is used to write out data.
+ */
+void ImportDataFrame::WorkBlock::write(QDataStream& stream) const
+{
+   EDEBUG_FUNC(this,&stream);
+
+   stream << _begin << _end;
+}
+
+
+
+
+
+
+/*!
+ * Reads in this block's range from the given data stream.
+ *
+ * @param stream The data stream that is used to read in data.
+ */
+void ImportDataFrame::WorkBlock::read(QDataStream& stream)
+{
+   EDEBUG_FUNC(this,&stream);
+
+   stream >> _begin >> _end;
+}
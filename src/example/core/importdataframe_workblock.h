@@ -0,0 +1,38 @@
+#ifndef IMPORTDATAFRAME_WORKBLOCK_H
+#define IMPORTDATAFRAME_WORKBLOCK_H
+#include "importdataframe.h"
+//
+
+
+
+/*!
+ * This implements the work block of the import dataframe analytic. It contains
+ * the range of bytes in the input text file that is parsed, which always begins
+ * at the start of a line and ends at the start of a line or the end of the
+ * file.
+ */
+class ImportDataFrame::WorkBlock : public EAbstractAnalyticBlock
+{
+   Q_OBJECT
+public:
+   /*!
+    * Constructs a new work block in an uninitialized null state.
+    */
+   explicit WorkBlock() = default;
+   explicit WorkBlock(int index, qint64 begin, qint64 end);
+   /*!
+    * The byte offset of the input file where this block's range begins.
+    */
+   qint64 _begin {0};
+   /*!
+    * The byte offset of the input file where this block's range ends.
+    */
+   qint64 _end {0};
+protected:
+   virtual void write(QDataStream& stream) const override final;
+   virtual void read(QDataStream& stream) override final;
+};
+
+
+
+#endif
@@ -91,6 +91,23 @@ std::unique_ptr<EAbstractAnalyticBlock> MathTransform::makeResult() const
 
 
 
+/*!
+ * Implements the interface that tests if any node of an MPI run can make work
+ * blocks from its own opened inputs. This implementation returns true because
+ * each work block is only a row read from the input dataframe. 
+ *
+ * @return True. 
+ */
+bool MathTransform::isLocalWork() const
+{
+   return true;
+}
+
+
+
+
+
+
 /*!
  * Implements the interface that reads in a block of results made from a block of 
  * work with the corresponding index. This implementation takes the row result 
@@ -1,4 +1,5 @@
 #include "mathtransform_block.h"
+#include <cstring>
 
 
 
@@ -72,3 +73,59 @@ void MathTransform::Block::read(QDataStream& stream)
 {
    stream >> _data;
 }
+
+
+
+
+
+
+/*!
+ * Returns the size in bytes of this block's data so it is copied as raw memory
+ * instead of using a data stream.
+ *
+ * @return Size in bytes of this block's data.
+ */
+qint64 MathTransform::Block::rawSize() const
+{
+   return _data.size()*sizeof(float);
+}
+
+
+
+
+
+
+/*!
+ * Copies this block's data as raw memory to the given pointer.
+ *
+ * @param data Pointer to the memory this block's data is copied to.
+ */
+void MathTransform::Block::writeRaw(char* data) const
+{
+   memcpy(data,_data.constData(),_data.size()*sizeof(float));
+}
+
+
+
+
+
+
+/*!
+ * Copies in this block's data from the given raw memory.
+ *
+ * @param data Pointer to the raw memory this block's data is copied from.
+ *
+ * @param size The size in bytes of the given raw memory.
+ */
+void MathTransform::Block::readRaw(const char* data, qint64 size)
+{
+   if ( size%sizeof(float) != 0 )
+   {
+      E_MAKE_EXCEPTION(e);
+      e.setTitle(tr("Read Error"));
+      e.setDetails(tr("Raw block data of %1 bytes is not a whole number of floats.").arg(size));
+      throw e;
+   }
+   _data.resize(size/sizeof(float));
+   memcpy(_data.data(),data,size);
+}
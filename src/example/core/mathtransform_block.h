@@ -28,6 +28,9 @@ public:
 protected:
    virtual void write(QDataStream& stream) const override final;
    virtual void read(QDataStream& stream) override final;
+   virtual qint64 rawSize() const override final;
+   virtual void writeRaw(char* data) const override final;
+   virtual void readRaw(const char* data, qint64 size) override final;
 };
 
 
@@ -100,7 +100,9 @@ void SettingsDialog::applyClicked()
 
    // .
    settings.setThreadSize(_threadEdit->value());
+   settings.setCPUThreadSize(_cpuThreadEdit->value());
    settings.setBufferSize(_bufferEdit->value());
+   settings.setWindowSize(_windowEdit->value());
 
    // .
    settings.setChunkDir(_chunkDirEdit->text());
@@ -183,12 +185,26 @@ QLayout* SettingsDialog::createForm()
    _threadEdit->setMaximum(INT_MAX);
    _threadEdit->setValue(settings.threadSize());
 
+   // .
+   _cpuThreadEdit = new QSpinBox;
+   _cpuThreadEdit->setMinimum(0);
+   _cpuThreadEdit->setMaximum(INT_MAX);
+   _cpuThreadEdit->setSpecialValueText(tr("Automatic"));
+   _cpuThreadEdit->setValue(settings.cpuThreadSize());
+
    // .
    _bufferEdit = new QSpinBox;
    _bufferEdit->setMinimum(1);
    _bufferEdit->setMaximum(INT_MAX);
    _bufferEdit->setValue(settings.bufferSize());
 
+   // .
+   _windowEdit = new QSpinBox;
+   _windowEdit->setMinimum(0);
+   _windowEdit->setMaximum(INT_MAX);
+   _windowEdit->setSpecialValueText(tr("Automatic"));
+   _windowEdit->setValue(settings.windowSize());
+
    // .
    _chunkDirEdit = new QLineEdit;
    _chunkDirEdit->setText(settings.chunkDir());
@@ -209,7 +225,9 @@ QLayout* SettingsDialog::createForm()
    ret->addRow(new QLabel(tr("CUDA Device:")),createCUDA());
    ret->addRow(new QLabel(tr("OpenCL Device:")),createOpenCL());
    ret->addRow(new QLabel(tr("Thread Size:")),_threadEdit);
+   ret->addRow(new QLabel(tr("CPU Thread Size:")),_cpuThreadEdit);
    ret->addRow(new QLabel(tr("Buffer Size:")),_bufferEdit);
+   ret->addRow(new QLabel(tr("Window Size:")),_windowEdit);
    ret->addRow(new QLabel(tr("Chunk Working Directory:")),_chunkDirEdit);
    ret->addRow(new QLabel(tr("Chunk Prefix:")),_chunkPrefixEdit);
    ret->addRow(new QLabel(tr("Chunk Extension:")),_chunkExtensionEdit);
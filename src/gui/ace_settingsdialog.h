@@ -49,10 +49,18 @@ namespace Ace
        * The spin box for this dialog used to edit the thread size setting. 
        */
       QSpinBox* _threadEdit;
+      /*!
+       * The spin box for this dialog used to edit the CPU thread size setting. 
+       */
+      QSpinBox* _cpuThreadEdit;
       /*!
        * The spin box for this dialog used to edit the buffer size setting. 
        */
       QSpinBox* _bufferEdit;
+      /*!
+       * The spin box for this dialog used to edit the window size setting. 
+       */
+      QSpinBox* _windowEdit;
       /*!
        * The line edit for this dialog used to edit the chunk working directory setting. 
        */
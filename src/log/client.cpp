@@ -2,6 +2,7 @@
 #include <QCoreApplication>
 #include <QCommandLineParser>
 #include "socket.h"
+#include "trace.h"
 
 
 
@@ -26,12 +27,26 @@ Client::Client()
       {{"s","silent"},tr("Do not signal the server to start.")}
       ,{{"d","debug"},tr("Run in debug mode.")}
       ,{{"t","thread"},tr("The given thread number to listen to in debug mode."),"thread"}
+      ,{"trace",tr("Read the given trace file instead of connecting to any server."),"file"}
+      ,{"chrome",tr("Output the trace file as Chrome trace JSON.")}
    }
    );
 
    // Parse the command line arguments. 
    parse.process(*QCoreApplication::instance());
 
+   // If the trace option is set then read the given trace file, outputting its debug 
+   // stacks of all threads or only the given thread unless Chrome trace JSON is 
+   // requested, and then exit without connecting to any logging server. 
+   if ( parse.isSet("trace") )
+   {
+      int thread {parse.isSet("thread") ? parse.value("thread").toInt() : -1};
+      Trace trace(parse.isSet("chrome"),thread);
+      trace.read(parse.value("trace"));
+      deleteLater();
+      return;
+   }
+
    // Set the silent and debug options. 
    _silent = parse.isSet("silent");
    _isDebug = parse.isSet("debug");
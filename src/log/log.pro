@@ -6,10 +6,12 @@ TARGET = acelog
 SOURCES += \
     main.cpp \
     socket.cpp \
+    trace.cpp \
     client.cpp
 
 HEADERS += \
     socket.h \
+    trace.h \
     client.h
 
 isEmpty(PREFIX) { PREFIX = /usr/local }
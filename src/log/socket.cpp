@@ -60,12 +60,8 @@ void Socket::readyRead()
  */
 void Socket::readHeader()
 {
-   // Keep reading in bytes from the socket until the full header has been read in to 
-   // the internal buffer or there are is no more bytes to read. 
-   while ( _buffer.size() < 9 && bytesAvailable() )
-   {
-      _buffer += read(1);
-   }
+   // Read in as many bytes of the header as are available into the internal buffer. 
+   _buffer += read(9 - _buffer.size());
 
    // Check to see if a full message header has been read into the internal buffer. 
    if ( _buffer.size() == 9 )
@@ -96,12 +92,8 @@ void Socket::readHeader()
  */
 void Socket::readMessage()
 {
-   // Keep reading in bytes from the socket until the full body has been read in to 
-   // the internal buffer or there are no more bytes to read. 
-   while ( _buffer.size() < _sizeToRead && bytesAvailable() )
-   {
-      _buffer += read(1);
-   }
+   // Read in as many bytes of the body as are available into the internal buffer. 
+   _buffer += read(_sizeToRead - _buffer.size());
 
    // Check to see if the full message body has been read into the internal buffer. 
    if ( _buffer.size() == _sizeToRead )
@@ -109,10 +101,6 @@ void Socket::readMessage()
       // Emit the message received signal. 
       emit messageReceived(static_cast<Ace::LogServer::Type>(_type),_thread,_buffer);
 
-      // Write back to the server on the socket signaling the message has been received. 
-      write("A",1);
-      flush();
-
       // Reset the internal buffer and set the size to read state to processing a new 
       // message header. 
       _buffer.clear();
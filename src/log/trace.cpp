@@ -0,0 +1,479 @@
+#include "trace.h"
+#include <QFile>
+#include <QRegularExpression>
+#include <QJsonDocument>
+#include <QJsonObject>
+//
+
+
+
+
+
+
+/*!
+ * Constructs a new trace reader with the given output options and optional 
+ * parent. 
+ *
+ * @param chrome True to output Chrome trace JSON or false to output debug 
+ *               stacks. 
+ *
+ * @param thread The only thread debug stacks are output for, or -1 to output 
+ *               every thread. 
+ *
+ * @param parent Optional parent of this new trace reader. 
+ */
+Trace::Trace(bool chrome, int thread, QObject* parent)
+   :
+   QObject(parent),
+   _chrome(chrome),
+   _thread(thread),
+   _out(stdout)
+{}
+
+
+
+
+
+
+/*!
+ * Reads the trace file with the given path and outputs all of its events to 
+ * standard output. If any error occurs reading the trace file then an error is 
+ * reported to standard error, keeping any output already made. 
+ *
+ * @param path The path of the trace file that is read. 
+ *
+ * @return True if the whole trace file was read or false otherwise. 
+ */
+bool Trace::read(const QString& path)
+{
+   // Open the trace file as read only. If opening fails then report an error and 
+   // return. 
+   QTextStream err(stderr);
+   QFile file(path);
+   if ( !file.open(QIODevice::ReadOnly) )
+   {
+      err << tr("Failed opening trace file %1: %2\n").arg(path).arg(file.errorString());
+      return false;
+   }
+
+   // Read in the header of the trace file. If it is not a valid trace file then 
+   // report an error and return. 
+   QDataStream stream(&file);
+   stream.setByteOrder(QDataStream::LittleEndian);
+   if ( !readHeader(stream) )
+   {
+      err << tr("File %1 is not a trace file of a supported version.\n").arg(path);
+      return false;
+   }
+
+   // If this reader outputs Chrome trace JSON then begin its event list. 
+   if ( _chrome )
+   {
+      _out << QStringLiteral("{\"traceEvents\":[\n");
+   }
+
+   // Read in every chunk of the trace file until its end is reached or an invalid 
+   // chunk is found. 
+   bool ret {true};
+   while ( ret && !stream.atEnd() )
+   {
+      quint8 type;
+      stream >> type;
+      switch (type)
+      {
+      case ETrace::Site:
+         ret = readSite(stream);
+         break;
+      case ETrace::Events:
+         ret = readEvents(stream);
+         break;
+      default:
+         ret = false;
+         break;
+      }
+   }
+
+   // If this reader outputs Chrome trace JSON then end its event list. 
+   if ( _chrome )
+   {
+      _out << QStringLiteral("\n]}\n");
+   }
+   _out.flush();
+
+   // If an invalid chunk was found then report an error since the trace file is 
+   // truncated or corrupt. 
+   if ( !ret )
+   {
+      err << tr("Trace file %1 is truncated or corrupt.\n").arg(path);
+   }
+   return ret;
+}
+
+
+
+
+
+
+/*!
+ * Reads in the header of a trace file from the given stream. 
+ *
+ * @param stream The stream the header is read from. 
+ *
+ * @return True if the header is valid and its version is supported or false 
+ *         otherwise. 
+ */
+bool Trace::readHeader(QDataStream& stream)
+{
+   quint64 magic;
+   quint32 version;
+   stream >> magic >> version >> _pid;
+   quint64 expected {ETrace::_magic};
+   quint32 supported {ETrace::_version};
+   return stream.status() == QDataStream::Ok && magic == expected && version <= supported;
+}
+
+
+
+
+
+
+/*!
+ * Reads in a site chunk from the given stream, adding its call site to this 
+ * reader. 
+ *
+ * @param stream The stream the site chunk is read from. 
+ *
+ * @return True if the site chunk was read or false if it is truncated. 
+ */
+bool Trace::readSite(QDataStream& stream)
+{
+   // Read in the call site ID, function name, and argument names. 
+   quint32 id;
+   stream >> id;
+   Site site;
+   site.function = shorten(readString(stream));
+   site.names = readString(stream).split(QRegularExpression("[,\\s]+"),QString::SkipEmptyParts);
+
+   // Add the call site to this reader if it was read. 
+   if ( stream.status() != QDataStream::Ok )
+   {
+      return false;
+   }
+   _sites.insert(id,site);
+   return true;
+}
+
+
+
+
+
+
+/*!
+ * Reads in an events chunk from the given stream, outputting every event it 
+ * contains. 
+ *
+ * @param stream The stream the events chunk is read from. 
+ *
+ * @return True if the events chunk was read or false if it is truncated or 
+ *         corrupt. 
+ */
+bool Trace::readEvents(QDataStream& stream)
+{
+   // Read in the thread ID and the events of the chunk. If it is truncated then 
+   // return. 
+   qint32 thread;
+   quint32 size;
+   stream >> thread >> size;
+   if ( stream.status() != QDataStream::Ok )
+   {
+      return false;
+   }
+   QByteArray data(static_cast<int>(size),Qt::Uninitialized);
+   if ( stream.readRawData(data.data(),data.size()) != data.size() )
+   {
+      return false;
+   }
+
+   // Iterate through all events of the chunk until its end is reached. 
+   QDataStream events(data);
+   events.setByteOrder(QDataStream::LittleEndian);
+   while ( !events.atEnd() )
+   {
+      // Read in the event type, call site ID, and timestamp. 
+      quint8 type;
+      quint32 site;
+      qint64 time;
+      events >> type >> site >> time;
+
+      // If this is an enter event then read in its argument values and output it, 
+      // else if this is a leave event then output it, else the chunk is corrupt. 
+      if ( type == ETrace::Enter )
+      {
+         quint8 count;
+         events >> count;
+         QStringList values;
+         for (int i = 0; i < count ;++i)
+         {
+            values << readValue(events,!_chrome);
+         }
+         if ( events.status() != QDataStream::Ok )
+         {
+            return false;
+         }
+         enter(thread,site,time,values);
+      }
+      else if ( type == ETrace::Leave )
+      {
+         if ( events.status() != QDataStream::Ok )
+         {
+            return false;
+         }
+         leave(thread,site,time);
+      }
+      else
+      {
+         return false;
+      }
+   }
+
+   // The whole events chunk has been read. 
+   return true;
+}
+
+
+
+
+
+
+/*!
+ * Outputs an enter event with the given thread, call site ID, timestamp, and 
+ * argument values. 
+ *
+ * @param thread The thread ID of the event. 
+ *
+ * @param site The call site ID of the event. 
+ *
+ * @param time The timestamp of the event in nanoseconds. 
+ *
+ * @param values The argument values of the event. 
+ */
+void Trace::enter(int thread, quint32 site, qint64 time, const QStringList& values)
+{
+   // Get the call site of the event along with its name. 
+   const Site& info {_sites[site]};
+   QString function {info.function.isEmpty() ? QStringLiteral("site%1").arg(site) : info.function};
+
+   // If this reader outputs Chrome trace JSON then output a begin event with the 
+   // argument names and values. 
+   if ( _chrome )
+   {
+      QJsonObject args;
+      for (int i = 0; i < values.size() ;++i)
+      {
+         args.insert(i < info.names.size() ? info.names.at(i) : QStringLiteral("arg%1").arg(i),values.at(i));
+      }
+      QJsonObject event
+      {
+         {"name",function}
+         ,{"ph","B"}
+         ,{"ts",time/1000.0}
+         ,{"pid",_pid}
+         ,{"tid",thread}
+         ,{"args",args}
+      };
+      _out << (_first ? "" : ",\n") << QJsonDocument(event).toJson(QJsonDocument::Compact);
+      _first = false;
+      return;
+   }
+
+   // Else this reader outputs debug stacks so if the event is on a thread this 
+   // reader outputs then output its function name and argument values as a new 
+   // debug stack level. 
+   if ( _thread >= 0 && thread != _thread )
+   {
+      return;
+   }
+   int& depth {_depths[thread]};
+   if ( _thread < 0 )
+   {
+      _out << QStringLiteral("[") << thread << QStringLiteral("] ");
+   }
+   _out << QString(depth*4,' ') << function << QStringLiteral("(");
+   for (int i = 0; i < values.size() ;++i)
+   {
+      if ( i > 0 )
+      {
+         _out << QStringLiteral(", ");
+      }
+      _out << (i < info.names.size() ? info.names.at(i) : QStringLiteral("arg%1").arg(i))
+           << QStringLiteral(" = ")
+           << values.at(i);
+   }
+   _out << QStringLiteral(") {\n");
+   ++depth;
+}
+
+
+
+
+
+
+/*!
+ * Outputs a leave event with the given thread, call site ID, and timestamp. 
+ *
+ * @param thread The thread ID of the event. 
+ *
+ * @param site The call site ID of the event. 
+ *
+ * @param time The timestamp of the event in nanoseconds. 
+ */
+void Trace::leave(int thread, quint32 site, qint64 time)
+{
+   // If this reader outputs Chrome trace JSON then output an end event. 
+   if ( _chrome )
+   {
+      const Site& info {_sites[site]};
+      QJsonObject event
+      {
+         {"name",info.function.isEmpty() ? QStringLiteral("site%1").arg(site) : info.function}
+         ,{"ph","E"}
+         ,{"ts",time/1000.0}
+         ,{"pid",_pid}
+         ,{"tid",thread}
+      };
+      _out << (_first ? "" : ",\n") << QJsonDocument(event).toJson(QJsonDocument::Compact);
+      _first = false;
+      return;
+   }
+
+   // Else this reader outputs debug stacks so if the event is on a thread this 
+   // reader outputs then close its debug stack level, clamping the depth to 0. 
+   if ( _thread >= 0 && thread != _thread )
+   {
+      return;
+   }
+   int& depth {_depths[thread]};
+   depth = qMax(depth - 1,0);
+   if ( _thread < 0 )
+   {
+      _out << QStringLiteral("[") << thread << QStringLiteral("] ");
+   }
+   _out << QString(depth*4,' ') << QStringLiteral("}\n");
+}
+
+
+
+
+
+
+/*!
+ * Reads in a string of a trace file from the given stream. 
+ *
+ * @param stream The stream the string is read from. 
+ *
+ * @return The string that was read. 
+ */
+QString Trace::readString(QDataStream& stream)
+{
+   quint32 size;
+   stream >> size;
+   QByteArray bytes(static_cast<int>(size),Qt::Uninitialized);
+   if ( stream.status() != QDataStream::Ok || stream.readRawData(bytes.data(),bytes.size()) != bytes.size() )
+   {
+      stream.setStatus(QDataStream::ReadPastEnd);
+      return QString();
+   }
+   return QString::fromUtf8(bytes);
+}
+
+
+
+
+
+
+/*!
+ * Reads in a packed argument value from the given stream, returning it as a 
+ * string. 
+ *
+ * @param stream The stream the packed argument value is read from. 
+ *
+ * @param quote True to add quotes to string values or false otherwise. 
+ *
+ * @return The argument value as a string. 
+ */
+QString Trace::readValue(QDataStream& stream, bool quote)
+{
+   // Read in the tag of the argument value. 
+   quint8 tag;
+   stream >> tag;
+
+   // Read in the argument value according to its tag, returning it as a string. If 
+   // the tag is not valid then set the stream to a corrupt state. 
+   switch (tag)
+   {
+   case ETrace::Unknown:
+      return QStringLiteral("?");
+   case ETrace::Bool:
+      {
+         quint8 value;
+         stream >> value;
+         return value ? QStringLiteral("TRUE") : QStringLiteral("FALSE");
+      }
+   case ETrace::Int:
+      {
+         qint64 value;
+         stream >> value;
+         return QString::number(value);
+      }
+   case ETrace::UInt:
+      {
+         quint64 value;
+         stream >> value;
+         return QString::number(value);
+      }
+   case ETrace::Double:
+      {
+         double value;
+         stream >> value;
+         return QString::number(value);
+      }
+   case ETrace::Pointer:
+      {
+         quint64 value;
+         stream >> value;
+         return QStringLiteral("0x") + QString::number(value,16);
+      }
+   case ETrace::String:
+      {
+         QString value {readString(stream)};
+         return quote ? QStringLiteral("\"") + value + QStringLiteral("\"") : value;
+      }
+   default:
+      stream.setStatus(QDataStream::ReadCorruptData);
+      return QString();
+   }
+}
+
+
+
+
+
+
+/*!
+ * Shortens the given full function name to its qualified name, removing its 
+ * return type and parameter list. 
+ *
+ * @param function The full function name. 
+ *
+ * @return The shortened function name. 
+ */
+QString Trace::shorten(const QString& function)
+{
+   QString ret {function.left(function.indexOf('(')).trimmed()};
+   int index {ret.lastIndexOf(' ')};
+   if ( index > 0 )
+   {
+      ret = ret.mid(index + 1);
+   }
+   return ret;
+}
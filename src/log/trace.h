@@ -0,0 +1,83 @@
+#ifndef TRACE_H
+#define TRACE_H
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <QDataStream>
+#include <QTextStream>
+#include "../core/etrace.h"
+//
+
+
+
+/*!
+ * This is the trace reader that reads a binary trace file written by an ACE 
+ * application built with tracing and outputs it to standard output. By default 
+ * each function call is printed as an indented debug stack in the same form as 
+ * debug mode, optionally limited to one thread. It can instead convert the whole 
+ * trace to Chrome trace JSON that can be loaded by any Chrome trace viewer. 
+ */
+class Trace : public QObject
+{
+   Q_OBJECT
+public:
+   explicit Trace(bool chrome, int thread, QObject* parent = nullptr);
+   bool read(const QString& path);
+private:
+   /*!
+    * This holds the function name and argument names of a single call site. 
+    */
+   struct Site
+   {
+      /*!
+       * The short function name of this call site. 
+       */
+      QString function;
+      /*!
+       * The argument names of this call site. 
+       */
+      QStringList names;
+   };
+   bool readHeader(QDataStream& stream);
+   bool readSite(QDataStream& stream);
+   bool readEvents(QDataStream& stream);
+   void enter(int thread, quint32 site, qint64 time, const QStringList& values);
+   void leave(int thread, quint32 site, qint64 time);
+   static QString readString(QDataStream& stream);
+   static QString readValue(QDataStream& stream, bool quote);
+   static QString shorten(const QString& function);
+   /*!
+    * True if this reader outputs Chrome trace JSON or false if it outputs debug 
+    * stacks. 
+    */
+   bool _chrome;
+   /*!
+    * The only thread this reader outputs debug stacks for, or -1 to output every 
+    * thread prefixed with its thread ID. 
+    */
+   int _thread;
+   /*!
+    * The process ID of the trace file being read. 
+    */
+   qint64 _pid {0};
+   /*!
+    * True if no Chrome trace event has been output yet or false otherwise. 
+    */
+   bool _first {true};
+   /*!
+    * The call sites of the trace file being read mapped by their call site ID. 
+    */
+   QHash<quint32,Site> _sites;
+   /*!
+    * The current stack depth of each thread of the trace file being read. 
+    */
+   QHash<int,int> _depths;
+   /*!
+    * The standard output stream of this reader. 
+    */
+   QTextStream _out;
+};
+
+
+
+#endif
@@ -7,12 +7,11 @@
 class DummyData : public EAbstractData
 {
 public:
+   virtual qint64 dataEnd() const override final { return 0; }
    virtual void readData() override final {}
-   virtual quint64 getDataEnd() const override final { return 0; }
-   virtual void newData() override final {}
-   virtual void prepare(bool /*preAllocate*/) override final {}
+   virtual void writeNewData() override final {}
    virtual void finish() override final {}
-   virtual QAbstractTableModel* getModel() { return nullptr; }
+   virtual QAbstractTableModel* model() override final { return nullptr; }
    using EAbstractData::stream;
    bool getTouch() { return _touch; }
    void touch() { _touch = true; }
@@ -6,7 +6,7 @@
 
 
 
-std::unique_ptr<EAbstractData> DummyDataFactory::make(quint16 type)
+std::unique_ptr<EAbstractData> DummyDataFactory::make(quint16 type) const
 {
    Q_UNUSED(type);
    return std::unique_ptr<EAbstractData>(new DummyData);
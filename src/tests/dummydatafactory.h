@@ -7,11 +7,11 @@
 class DummyDataFactory : public EAbstractDataFactory
 {
 public:
-   virtual quint16 getCount() override final { return 1; }
-   virtual QString getName(quint16 /*type*/) override final { return QString("Dummy"); }
-   virtual QString getFileExtension(quint16 /*type*/) override final
+   virtual quint16 size() const override final { return 1; }
+   virtual QString name(quint16 /*type*/) const override final { return QString("Dummy"); }
+   virtual QString fileExtension(quint16 /*type*/) const override final
       { return QString("dmy"); }
-   virtual std::unique_ptr<EAbstractData> make(quint16 type) override final;
+   virtual std::unique_ptr<EAbstractData> make(quint16 type) const override final;
 };
 
 
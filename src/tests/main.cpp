@@ -9,6 +9,7 @@
 #include "testopenclkernel.h"
 #include "testopenclbuffer.h"
 #include "testopenclevent.h"
+#include "testopenclrun.h"
 
 #ifdef DUMMY_QTEST_APPLESS_MAIN_NEEDED_FOR_QTCREATOR_TO_RECOGNIZE_THIS_AS_QTTESTS
 QTEST_APPLESS_MAIN(TestException)
@@ -18,6 +19,7 @@ QTEST_APPLESS_MAIN(TestException)
 
 int main(int argc, char* argv[])
 {
+   QCoreApplication application(argc,argv);
    std::unique_ptr<EAbstractDataFactory> factory(new DummyDataFactory);
    EAbstractDataFactory::setInstance(std::move(factory));
    int status {0};
@@ -36,5 +38,6 @@ int main(int argc, char* argv[])
    ASSERT_TEST(new TestOpenCLKernel);
    ASSERT_TEST(new TestOpenCLBuffer);
    ASSERT_TEST(new TestOpenCLEvent);
+   ASSERT_TEST(new TestOpenCLRun);
    return status;
 }
@@ -1,5 +1,9 @@
 #include "testdatastream.h"
+#include <QtEndian>
+#include "ace_dataobject.h"
 #include "edatastream.h"
+#include "emetadata.h"
+#include "eexception.h"
 
 
 
@@ -8,9 +12,9 @@
 
 void TestDataStream::initTestCase()
 {
-   // open file that will be used
-   _file = new QFile(QDir::tempPath() + "/ACE_test_io.raw");
-   Q_ASSERT(_file->open(QIODevice::ReadWrite));
+   // make a new dummy data object whose data stream is tested
+   _path = QDir::tempPath() + "/ACE_test_io.dmy";
+   _object = new Ace::DataObject(_path,0,EMetadata(EMetadata::Object));
 }
 
 
@@ -34,8 +38,9 @@ void TestDataStream::testStreamOperators()
    QString valstring("test string");
    QByteArray valbytes("test bytes");
 
-   // make new stream and write all data to file
-   EDataStream stream(_file);
+   // write all data to the data object
+   EDataStream& stream {_object->stream()};
+   _object->seek(0);
    stream << vali8 << valu8 << vali16 << valu16 << vali32 << valu32 << vali64 << valu64 << valfloat
           << valdouble << valstring << valbytes;
 
@@ -45,7 +50,7 @@ void TestDataStream::testStreamOperators()
    valbytes.clear();
 
    // read all data types just written back
-   _file->seek(0);
+   _object->seek(0);
    stream >> vali8 >> valu8 >> vali16 >> valu16 >> vali32 >> valu32 >> vali64 >> valu64 >> valfloat
           >> valdouble >> valstring >> valbytes;
 
@@ -69,19 +74,49 @@ void TestDataStream::testStreamOperators()
 
 
 
+void TestDataStream::testArrays()
+{
+   checkArrays(QSysInfo::ByteOrder);
+}
+
+
+
+
+
+
+void TestDataStream::testSwappedArrays()
+{
+   checkArrays(QSysInfo::ByteOrder == QSysInfo::BigEndian ? QSysInfo::LittleEndian : QSysInfo::BigEndian);
+}
+
+
+
+
+
+
 void TestDataStream::testBadString()
 {
-   // initialize stream and string
-   EDataStream stream(_file);
+   // initialize stream and string, writing a value that is not a string
+   EDataStream& stream {_object->stream()};
    QString value("not empty");
+   _object->seek(0);
+   stream << quint8 {0};
 
    // attempt to read string that doesn't exist
-   _file->seek(0);
-   stream >> value;
+   bool caught {false};
+   try
+   {
+      _object->seek(0);
+      stream >> value;
+   }
+   catch (EException)
+   {
+      caught = true;
+   }
 
    // make sure it failed
-   Q_ASSERT( value.isEmpty() );
-   Q_ASSERT( !stream );
+   Q_ASSERT( caught );
+   Q_ASSERT( value == QString("not empty") );
 }
 
 
@@ -91,17 +126,27 @@ void TestDataStream::testBadString()
 
 void TestDataStream::testBadBytes()
 {
-   // initialize stream and bytes
-   EDataStream stream(_file);
+   // initialize stream and bytes, writing a value that is not a byte array
+   EDataStream& stream {_object->stream()};
    QByteArray value("not empty");
+   _object->seek(0);
+   stream << quint8 {0};
 
    // attempt to read in bytes that doesn't exist
-   _file->seek(0);
-   stream >> value;
+   bool caught {false};
+   try
+   {
+      _object->seek(0);
+      stream >> value;
+   }
+   catch (EException)
+   {
+      caught = true;
+   }
 
    // make sure it failed
-   Q_ASSERT( value.isEmpty() );
-   Q_ASSERT( !stream );
+   Q_ASSERT( caught );
+   Q_ASSERT( value == QByteArray("not empty") );
 }
 
 
@@ -111,7 +156,69 @@ void TestDataStream::testBadBytes()
 
 void TestDataStream::cleanupTestCase()
 {
-   // cleanup temporary file
-   _file->remove();
-   delete _file;
+   // delete the data object and cleanup its temporary file
+   delete _object;
+   QFile::remove(_path);
+}
+
+
+
+
+
+
+void TestDataStream::checkArrays(QSysInfo::Endian order)
+{
+   // initialize arrays of integer and floating point values, large enough that
+   // swapped values are written out in more than one piece
+   const int size {100000};
+   QVector<qint32> ints(size);
+   QVector<float> floats(size);
+   for (int i = 0; i < size ;++i)
+   {
+      ints[i] = i - size/2;
+      floats[i] = i/4.0f;
+   }
+
+   // write both arrays to the data object in the given byte order, followed by every
+   // value written individually
+   EDataStream& stream {_object->stream()};
+   stream.setByteOrder(order);
+   _object->seek(0);
+   stream.writeArray(ints.constData(),size).writeArray(floats.constData(),size);
+   for (auto value: qAsConst(ints))
+   {
+      stream << value;
+   }
+   for (auto value: qAsConst(floats))
+   {
+      stream << value;
+   }
+
+   // read both arrays just written back
+   QVector<qint32> intsRead(size);
+   QVector<float> floatsRead(size);
+   _object->seek(0);
+   stream.readArray(intsRead.data(),size).readArray(floatsRead.data(),size);
+
+   // make sure both arrays are the same
+   Q_ASSERT( intsRead == ints );
+   Q_ASSERT( floatsRead == floats );
+
+   // read the raw bytes of both arrays and of the individually written values
+   const int bytes {size*static_cast<int>(sizeof(qint32) + sizeof(float))};
+   QByteArray arrays(bytes,Qt::Uninitialized);
+   QByteArray values(bytes,Qt::Uninitialized);
+   _object->seek(0);
+   _object->read(arrays.data(),arrays.size());
+   _object->read(values.data(),values.size());
+
+   // make sure the arrays are stored exactly the same as the individual values and in
+   // the given byte order
+   Q_ASSERT( arrays == values );
+   qint32 first;
+   memcpy(&first,arrays.constData(),sizeof(first));
+   Q_ASSERT( (order == QSysInfo::BigEndian ? qFromBigEndian(first) : qFromLittleEndian(first)) == ints.at(0) );
+
+   // restore the byte order of the data object
+   stream.setByteOrder(_object->byteOrder());
 }
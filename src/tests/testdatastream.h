@@ -4,17 +4,25 @@
 
 
 
+namespace Ace { class DataObject; }
+
+
+
 class TestDataStream : public QObject
 {
    Q_OBJECT
 private slots:
    void initTestCase();
    void testStreamOperators();
+   void testArrays();
+   void testSwappedArrays();
    void testBadString();
    void testBadBytes();
    void cleanupTestCase();
 private:
-   QFile* _file;
+   void checkArrays(QSysInfo::Endian order);
+   QString _path;
+   Ace::DataObject* _object;
 };
 
 
@@ -1,6 +1,8 @@
 #include "testmetadata.h"
-#include "metadata.h"
+#include "emetaarray.h"
+#include "emetaobject.h"
 #include "edatastream.h"
+#include "ace_dataobject.h"
 
 
 
@@ -14,7 +16,7 @@ void TestMetadata::testBool()
    EMetadata data2(EMetadata::Null);
 
    // test first bool metadata
-   Q_ASSERT( data1.getType() == EMetadata::Bool );
+   Q_ASSERT( data1.type() == EMetadata::Bool );
    Q_ASSERT( data1.isBool() );
    Q_ASSERT( !data1.isDouble() );
    Q_ASSERT( !data1.isString() );
@@ -22,12 +24,12 @@ void TestMetadata::testBool()
    Q_ASSERT( !data1.isArray() );
    Q_ASSERT( !data1.isObject() );
    Q_ASSERT( !data1.isNull() );
-   *(data1.toBool()) = true;
-   Q_ASSERT( *(data1.toBool()) );
+   data1.toBool() = true;
+   Q_ASSERT( data1.toBool() );
 
    // test second bool metadata
-   data2.setType(EMetadata::Bool);
-   Q_ASSERT( data2.getType() == EMetadata::Bool );
+   data2 = EMetadata(EMetadata::Bool);
+   Q_ASSERT( data2.type() == EMetadata::Bool );
    Q_ASSERT( data2.isBool() );
    Q_ASSERT( !data2.isDouble() );
    Q_ASSERT( !data2.isString() );
@@ -35,8 +37,8 @@ void TestMetadata::testBool()
    Q_ASSERT( !data2.isArray() );
    Q_ASSERT( !data2.isObject() );
    Q_ASSERT( !data2.isNull() );
-   *(data2.toBool()) = true;
-   Q_ASSERT( *(data2.toBool()) );
+   data2.toBool() = true;
+   Q_ASSERT( data2.toBool() );
 }
 
 
@@ -51,7 +53,7 @@ void TestMetadata::testDouble()
    EMetadata data2(EMetadata::Null);
 
    // test first double metadata
-   Q_ASSERT( data1.getType() == EMetadata::Double );
+   Q_ASSERT( data1.type() == EMetadata::Double );
    Q_ASSERT( !data1.isBool() );
    Q_ASSERT( data1.isDouble() );
    Q_ASSERT( !data1.isString() );
@@ -59,12 +61,12 @@ void TestMetadata::testDouble()
    Q_ASSERT( !data1.isArray() );
    Q_ASSERT( !data1.isObject() );
    Q_ASSERT( !data1.isNull() );
-   *(data1.toDouble()) = 3.14;
-   Q_ASSERT( *(data1.toDouble()) == 3.14 );
+   data1.toDouble() = 3.14;
+   Q_ASSERT( data1.toDouble() == 3.14 );
 
    // test second double metadata
-   data2.setType(EMetadata::Double);
-   Q_ASSERT( data2.getType() == EMetadata::Double );
+   data2 = EMetadata(EMetadata::Double);
+   Q_ASSERT( data2.type() == EMetadata::Double );
    Q_ASSERT( !data2.isBool() );
    Q_ASSERT( data2.isDouble() );
    Q_ASSERT( !data2.isString() );
@@ -72,8 +74,8 @@ void TestMetadata::testDouble()
    Q_ASSERT( !data2.isArray() );
    Q_ASSERT( !data2.isObject() );
    Q_ASSERT( !data2.isNull() );
-   *(data2.toDouble()) = 3.14;
-   Q_ASSERT( *(data2.toDouble()) == 3.14 );
+   data2.toDouble() = 3.14;
+   Q_ASSERT( data2.toDouble() == 3.14 );
 }
 
 
@@ -88,7 +90,7 @@ void TestMetadata::testString()
    EMetadata data2(EMetadata::Null);
 
    // test first string metadata
-   Q_ASSERT( data1.getType() == EMetadata::String );
+   Q_ASSERT( data1.type() == EMetadata::String );
    Q_ASSERT( !data1.isBool() );
    Q_ASSERT( !data1.isDouble() );
    Q_ASSERT( data1.isString() );
@@ -96,12 +98,12 @@ void TestMetadata::testString()
    Q_ASSERT( !data1.isArray() );
    Q_ASSERT( !data1.isObject() );
    Q_ASSERT( !data1.isNull() );
-   *(data1.toString()) = QString("test string");
-   Q_ASSERT( *(data1.toString()) == QString("test string") );
+   data1.toString() = QString("test string");
+   Q_ASSERT( data1.toString() == QString("test string") );
 
    // test second string metadata
-   data2.setType(EMetadata::String);
-   Q_ASSERT( data2.getType() == EMetadata::String );
+   data2 = EMetadata(EMetadata::String);
+   Q_ASSERT( data2.type() == EMetadata::String );
    Q_ASSERT( !data2.isBool() );
    Q_ASSERT( !data2.isDouble() );
    Q_ASSERT( data2.isString() );
@@ -109,8 +111,8 @@ void TestMetadata::testString()
    Q_ASSERT( !data2.isArray() );
    Q_ASSERT( !data2.isObject() );
    Q_ASSERT( !data2.isNull() );
-   *(data2.toString()) = QString("test string");
-   Q_ASSERT( *(data2.toString()) == QString("test string") );
+   data2.toString() = QString("test string");
+   Q_ASSERT( data2.toString() == QString("test string") );
 }
 
 
@@ -125,7 +127,7 @@ void TestMetadata::testBytes()
    EMetadata data2(EMetadata::Null);
 
    // test first bytes metadata
-   Q_ASSERT( data1.getType() == EMetadata::Bytes );
+   Q_ASSERT( data1.type() == EMetadata::Bytes );
    Q_ASSERT( !data1.isBool() );
    Q_ASSERT( !data1.isDouble() );
    Q_ASSERT( !data1.isString() );
@@ -133,12 +135,12 @@ void TestMetadata::testBytes()
    Q_ASSERT( !data1.isArray() );
    Q_ASSERT( !data1.isObject() );
    Q_ASSERT( !data1.isNull() );
-   *(data1.toBytes()) = QByteArray("test bytes");
-   Q_ASSERT( *(data1.toBytes()) == QByteArray("test bytes") );
+   data1.toBytes() = QByteArray("test bytes");
+   Q_ASSERT( data1.toBytes() == QByteArray("test bytes") );
 
    // test second bytes metadata
-   data2.setType(EMetadata::Bytes);
-   Q_ASSERT( data2.getType() == EMetadata::Bytes );
+   data2 = EMetadata(EMetadata::Bytes);
+   Q_ASSERT( data2.type() == EMetadata::Bytes );
    Q_ASSERT( !data2.isBool() );
    Q_ASSERT( !data2.isDouble() );
    Q_ASSERT( !data2.isString() );
@@ -146,8 +148,8 @@ void TestMetadata::testBytes()
    Q_ASSERT( !data2.isArray() );
    Q_ASSERT( !data2.isObject() );
    Q_ASSERT( !data2.isNull() );
-   *(data2.toBytes()) = QByteArray("test bytes");
-   Q_ASSERT( *(data2.toBytes()) == QByteArray("test bytes") );
+   data2.toBytes() = QByteArray("test bytes");
+   Q_ASSERT( data2.toBytes() == QByteArray("test bytes") );
 }
 
 
@@ -162,7 +164,7 @@ void TestMetadata::testArray()
    EMetadata data2(EMetadata::Null);
 
    // test first array metadata
-   Q_ASSERT( data1.getType() == EMetadata::Array );
+   Q_ASSERT( data1.type() == EMetadata::Array );
    Q_ASSERT( !data1.isBool() );
    Q_ASSERT( !data1.isDouble() );
    Q_ASSERT( !data1.isString() );
@@ -170,12 +172,12 @@ void TestMetadata::testArray()
    Q_ASSERT( data1.isArray() );
    Q_ASSERT( !data1.isObject() );
    Q_ASSERT( !data1.isNull() );
-   data1.toArray()->append(new EMetadata);
-   Q_ASSERT( data1.toArray()->size() == 1 );
+   data1.toArray().append(EMetadata());
+   Q_ASSERT( data1.toArray().size() == 1 );
 
    // test second array metadata
-   data2.setType(EMetadata::Array);
-   Q_ASSERT( data2.getType() == EMetadata::Array );
+   data2 = EMetadata(EMetadata::Array);
+   Q_ASSERT( data2.type() == EMetadata::Array );
    Q_ASSERT( !data2.isBool() );
    Q_ASSERT( !data2.isDouble() );
    Q_ASSERT( !data2.isString() );
@@ -183,8 +185,8 @@ void TestMetadata::testArray()
    Q_ASSERT( data2.isArray() );
    Q_ASSERT( !data2.isObject() );
    Q_ASSERT( !data2.isNull() );
-   data2.toArray()->append(new EMetadata);
-   Q_ASSERT( data2.toArray()->size() == 1 );
+   data2.toArray().append(EMetadata());
+   Q_ASSERT( data2.toArray().size() == 1 );
 }
 
 
@@ -199,7 +201,7 @@ void TestMetadata::testObject()
    EMetadata data2(EMetadata::Null);
 
    // test first object metadata
-   Q_ASSERT( data1.getType() == EMetadata::Object );
+   Q_ASSERT( data1.type() == EMetadata::Object );
    Q_ASSERT( !data1.isBool() );
    Q_ASSERT( !data1.isDouble() );
    Q_ASSERT( !data1.isString() );
@@ -207,12 +209,12 @@ void TestMetadata::testObject()
    Q_ASSERT( !data1.isArray() );
    Q_ASSERT( data1.isObject() );
    Q_ASSERT( !data1.isNull() );
-   data1.toObject()->insert("test",new EMetadata);
-   Q_ASSERT( data1.toObject()->size() == 1 );
+   data1.toObject().insert("test",EMetadata());
+   Q_ASSERT( data1.toObject().size() == 1 );
 
    // test second object metadata
-   data2.setType(EMetadata::Object);
-   Q_ASSERT( data2.getType() == EMetadata::Object );
+   data2 = EMetadata(EMetadata::Object);
+   Q_ASSERT( data2.type() == EMetadata::Object );
    Q_ASSERT( !data2.isBool() );
    Q_ASSERT( !data2.isDouble() );
    Q_ASSERT( !data2.isString() );
@@ -220,8 +222,8 @@ void TestMetadata::testObject()
    Q_ASSERT( !data2.isArray() );
    Q_ASSERT( data2.isObject() );
    Q_ASSERT( !data2.isNull() );
-   data2.toObject()->insert("test",new EMetadata);
-   Q_ASSERT( data2.toObject()->size() == 1 );
+   data2.toObject().insert("test",EMetadata());
+   Q_ASSERT( data2.toObject().size() == 1 );
 }
 
 
@@ -236,7 +238,7 @@ void TestMetadata::testNull()
    EMetadata data2(EMetadata::Bool);
 
    // test first null metadata
-   Q_ASSERT( data1.getType() == EMetadata::Null );
+   Q_ASSERT( data1.type() == EMetadata::Null );
    Q_ASSERT( !data1.isBool() );
    Q_ASSERT( !data1.isDouble() );
    Q_ASSERT( !data1.isString() );
@@ -246,8 +248,8 @@ void TestMetadata::testNull()
    Q_ASSERT( data1.isNull() );
 
    // test second null metadata
-   data2.setType(EMetadata::Null);
-   Q_ASSERT( data2.getType() == EMetadata::Null );
+   data2 = EMetadata(EMetadata::Null);
+   Q_ASSERT( data2.type() == EMetadata::Null );
    Q_ASSERT( !data2.isBool() );
    Q_ASSERT( !data2.isDouble() );
    Q_ASSERT( !data2.isString() );
@@ -264,69 +266,25 @@ void TestMetadata::testNull()
 
 void TestMetadata::testFileInputOutput()
 {
-   // open file and initialize for stream
-   QFile file(QDir::tempPath() + "/ACE_metadata_raw.io");
-   Q_ASSERT( file.open(QIODevice::ReadWrite) );
-   EDataStream* stream = new EDataStream(&file);
-
-   // create metadata structure that will be written
-   EMetadata in(EMetadata::Object);
-   in.toObject()->insert("null",new EMetadata);
-   in.toObject()->insert("bool",new EMetadata(EMetadata::Bool));
-   *((*(in.toObject()))["bool"]->toBool()) = true;
-   in.toObject()->insert("double",new EMetadata(EMetadata::Double));
-   *((*(in.toObject()))["double"]->toDouble()) = 3.14;
-   in.toObject()->insert("string",new EMetadata(EMetadata::String));
-   *((*(in.toObject()))["string"]->toString()) = QString("test string");
-   in.toObject()->insert("bytes",new EMetadata(EMetadata::Bytes));
-   *((*(in.toObject()))["bytes"]->toBytes()) = QByteArray("test bytes");
-   in.toObject()->insert("array",new EMetadata(EMetadata::Array));
-   QList<EMetadata*>* array = (*(in.toObject()))["array"]->toArray();
-   array->append(new EMetadata);
-   array->append(new EMetadata(EMetadata::Bool));
-   *(array->back()->toBool()) = true;
-   array->append(new EMetadata(EMetadata::Double));
-   *(array->back()->toDouble()) = 6.28;
-   array->append(new EMetadata(EMetadata::String));
-   *(array->back()->toString()) = QString("array test string");
-   array->append(new EMetadata(EMetadata::Bytes));
-   *(array->back()->toBytes()) = QByteArray("array test bytes");
-
-   // write metadata to file and make sure it worked
-   *stream << in;
-   Q_ASSERT( (bool)*stream );
-
-   // close stream and file
-   delete stream;
-   file.close();
+   // make a new dummy data object whose data stream the metadata is written to
+   QString path {QDir::tempPath() + "/ACE_metadata_raw.dmy"};
+   Ace::DataObject* object {new Ace::DataObject(path,0,EMetadata(EMetadata::Object))};
+   EDataStream& stream {object->stream()};
 
-   // reopen same file with new stream
-   Q_ASSERT( file.open(QIODevice::ReadWrite) );
-   stream = new EDataStream(&file);
+   // write metadata to the data object in the tagged format and read it back
+   EMetadata in {makeTree()};
    EMetadata out;
+   object->seek(0);
+   stream << in;
+   object->seek(0);
+   stream >> out;
 
-   // read in metadata and confirm it is the same
-   *stream >> out;
-   Q_ASSERT( (bool)*stream );
-   Q_ASSERT( out.isObject() );
-   Q_ASSERT( out.toObject()->size() == 6 );
-   Q_ASSERT( (*(out.toObject()))["null"]->isNull() );
-   Q_ASSERT( *((*(out.toObject()))["bool"]->toBool()) );
-   Q_ASSERT( *((*(out.toObject()))["double"]->toDouble()) == 3.14 );
-   Q_ASSERT( *((*(out.toObject()))["string"]->toString()) == QString("test string") );
-   Q_ASSERT( *((*(out.toObject()))["bytes"]->toBytes()) == QByteArray("test bytes") );
-   array = (*(out.toObject()))["array"]->toArray();
-   Q_ASSERT( array->size() == 5 );
-   Q_ASSERT( (*array)[0]->isNull() );
-   Q_ASSERT( *((*array)[1]->toBool()) );
-   Q_ASSERT( *((*array)[2]->toDouble()) == 6.28 );
-   Q_ASSERT( *((*array)[3]->toString()) == QString("array test string") );
-   Q_ASSERT( *((*array)[4]->toBytes()) == QByteArray("array test bytes") );
-
-   // close stream and remove file
-   delete stream;
-   file.close();
-   file.remove();
+   // confirm the metadata read in is the same
+   checkTree(out);
+
+   // delete the data object and remove its file
+   delete object;
+   QFile::remove(path);
 }
 
 
@@ -336,45 +294,240 @@ void TestMetadata::testFileInputOutput()
 
 void TestMetadata::testCopyConstructor()
 {
-   // create metadata structure that will be written
-   EMetadata in(EMetadata::Object);
-   in.toObject()->insert("null",new EMetadata);
-   in.toObject()->insert("bool",new EMetadata(EMetadata::Bool));
-   *((*(in.toObject()))["bool"]->toBool()) = true;
-   in.toObject()->insert("double",new EMetadata(EMetadata::Double));
-   *((*(in.toObject()))["double"]->toDouble()) = 3.14;
-   in.toObject()->insert("string",new EMetadata(EMetadata::String));
-   *((*(in.toObject()))["string"]->toString()) = QString("test string");
-   in.toObject()->insert("bytes",new EMetadata(EMetadata::Bytes));
-   *((*(in.toObject()))["bytes"]->toBytes()) = QByteArray("test bytes");
-   in.toObject()->insert("array",new EMetadata(EMetadata::Array));
-   QList<EMetadata*>* array = (*(in.toObject()))["array"]->toArray();
-   array->append(new EMetadata);
-   array->append(new EMetadata(EMetadata::Bool));
-   *(array->back()->toBool()) = true;
-   array->append(new EMetadata(EMetadata::Double));
-   *(array->back()->toDouble()) = 6.28;
-   array->append(new EMetadata(EMetadata::String));
-   *(array->back()->toString()) = QString("array test string");
-   array->append(new EMetadata(EMetadata::Bytes));
-   *(array->back()->toBytes()) = QByteArray("array test bytes");
-
-   // make copy of the metadata
+   // create metadata structure and make a copy of it
+   EMetadata in {makeTree()};
    EMetadata out(in);
 
    // confirm copy is the same
-   Q_ASSERT( out.isObject() );
-   Q_ASSERT( out.toObject()->size() == 6 );
-   Q_ASSERT( (*(out.toObject()))["null"]->isNull() );
-   Q_ASSERT( *((*(out.toObject()))["bool"]->toBool()) );
-   Q_ASSERT( *((*(out.toObject()))["double"]->toDouble()) == 3.14 );
-   Q_ASSERT( *((*(out.toObject()))["string"]->toString()) == QString("test string") );
-   Q_ASSERT( *((*(out.toObject()))["bytes"]->toBytes()) == QByteArray("test bytes") );
-   array = (*(out.toObject()))["array"]->toArray();
-   Q_ASSERT( array->size() == 5 );
-   Q_ASSERT( (*array)[0]->isNull() );
-   Q_ASSERT( *((*array)[1]->toBool()) );
-   Q_ASSERT( *((*array)[2]->toDouble()) == 6.28 );
-   Q_ASSERT( *((*array)[3]->toString()) == QString("array test string") );
-   Q_ASSERT( *((*array)[4]->toBytes()) == QByteArray("array test bytes") );
+   checkTree(out);
+
+   // modify scalar values of the copy, both at its top level and nested in its array
+   out.toObject()["double"].toDouble() = 1.5;
+   out.toObject()["string"].toString() = QString("modified string");
+   out.toObject()["object"].toObject()["array"].toArray()[1].toBool() = false;
+
+   // confirm the copy is modified and the original is not
+   Q_ASSERT( out.toObject().at("double").toDouble() == 1.5 );
+   Q_ASSERT( out.toObject().at("string").toString() == QString("modified string") );
+   Q_ASSERT( !out.toObject().at("object").toObject().at("array").toArray().at(1).toBool() );
+   checkTree(in);
+
+   // modify a scalar copy and confirm the original is not modified
+   EMetadata scalar(3.14);
+   EMetadata scalarCopy(scalar);
+   scalarCopy.toDouble() = 6.28;
+   Q_ASSERT( scalar.toDouble() == 3.14 );
+   Q_ASSERT( scalarCopy.toDouble() == 6.28 );
+}
+
+
+
+
+
+
+void TestMetadata::testEncodeDecode()
+{
+   // encode metadata and decode it again
+   EMetadata in {makeTree()};
+   QByteArray bytes {in.encode()};
+   EMetadata out {EMetadata::decode(bytes)};
+
+   // confirm decoded metadata is the same and encodes to the same bytes
+   checkTree(out);
+   Q_ASSERT( out.encode() == bytes );
+
+   // confirm decoding only part of the metadata still encodes to the same bytes
+   const EMetadata partial {EMetadata::decode(bytes)};
+   Q_ASSERT( partial.toObject().at("object").toObject().at("array").toArray().size() == 5 );
+   Q_ASSERT( partial.encode() == bytes );
+
+   // confirm scalar metadata round trips on its own
+   EMetadata scalar(QStringLiteral("scalar string"));
+   Q_ASSERT( EMetadata::decode(scalar.encode()).toString() == QString("scalar string") );
+   Q_ASSERT( EMetadata::decode(EMetadata().encode()).isNull() );
+}
+
+
+
+
+
+
+void TestMetadata::testEncodeModified()
+{
+   // decode encoded metadata and modify a copy of a nested array
+   QByteArray bytes {makeTree().encode()};
+   EMetadata original {EMetadata::decode(bytes)};
+   EMetadata copy {original};
+   EMetaArray& array {copy.toObject()["object"].toObject()["array"].toArray()};
+   array[3].toString() = QString("modified string");
+   array.append(EMetadata(1.5));
+
+   // confirm the original is unchanged and still encodes to the same bytes
+   checkTree(original);
+   Q_ASSERT( original.encode() == bytes );
+
+   // confirm the modified copy encodes its changes
+   EMetadata out {EMetadata::decode(copy.encode())};
+   EMetaArray outArray {out.toObject().at("object").toObject().at("array").toArray()};
+   Q_ASSERT( outArray.size() == 6 );
+   Q_ASSERT( outArray.at(3).toString() == QString("modified string") );
+   Q_ASSERT( outArray.at(5).toDouble() == 1.5 );
+   Q_ASSERT( out.toObject().at("string").toString() == QString("test string") );
+}
+
+
+
+
+
+
+void TestMetadata::testReadVersion1()
+{
+   // build system and user metadata, the system metadata having no real numbers
+   // since version 1 headers store them in native byte order
+   EMetadata system(EMetadata::Object);
+   system.toObject().insert("command",EMetadata(QStringLiteral("test command")));
+   EMetaArray inputs;
+   inputs.append(EMetadata(QByteArray("input bytes")));
+   system.toObject().insert("input",EMetadata(inputs));
+   EMetadata user {makeTree()};
+
+   // write a version 1 data object file by hand, its header in big endian and its
+   // user metadata in little endian, both using the tagged metadata format
+   QString path {QDir::tempPath() + "/ACE_test_metadata_v1.dmy"};
+   QFile file(path);
+   QVERIFY( file.open(QIODevice::WriteOnly|QIODevice::Truncate) );
+   QDataStream stream(&file);
+   stream.setByteOrder(QDataStream::BigEndian);
+   stream << qint64 {585} << quint8 {1} << quint8 {1} << quint16 {0};
+   writeLegacy(stream,QString("Dummy"));
+   writeLegacy(stream,QString("dmy"));
+   writeLegacy(stream,system);
+   stream.setByteOrder(QDataStream::LittleEndian);
+   stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+   writeLegacy(stream,user);
+   Q_ASSERT( stream.status() == QDataStream::Ok );
+   file.close();
+
+   // open the file as a data object and confirm its metadata is read
+   {
+      Ace::DataObject object(path);
+      Q_ASSERT( object.version() == 1 );
+      Q_ASSERT( object.systemMeta().toObject().at("command").toString() == QString("test command") );
+      Q_ASSERT( object.systemMeta().toObject().at("input").toArray().at(0).toBytes() == QByteArray("input bytes") );
+      checkTree(object.userMeta());
+   }
+
+   // remove the file
+   file.remove();
+}
+
+
+
+
+
+
+EMetadata TestMetadata::makeTree()
+{
+   // create an object with every metadata type and a nested array
+   EMetadata ret(EMetadata::Object);
+   EMetaObject& object {ret.toObject()};
+   EMetadata flag(EMetadata::Bool);
+   flag.toBool() = true;
+   object.insert("null",EMetadata());
+   object.insert("bool",flag);
+   object.insert("double",EMetadata(3.14));
+   object.insert("string",EMetadata(QStringLiteral("test string")));
+   object.insert("bytes",EMetadata(QByteArray("test bytes")));
+   EMetaArray array;
+   array.append(EMetadata());
+   array.append(flag);
+   array.append(EMetadata(6.28));
+   array.append(EMetadata(QStringLiteral("array test string")));
+   array.append(EMetadata(QByteArray("array test bytes")));
+   EMetaObject child;
+   child.insert("array",EMetadata(array));
+   object.insert("object",EMetadata(child));
+   return ret;
+}
+
+
+
+
+
+
+void TestMetadata::checkTree(const EMetadata& meta)
+{
+   // confirm the metadata matches what make tree creates
+   Q_ASSERT( meta.isObject() );
+   const EMetaObject& object {meta.toObject()};
+   Q_ASSERT( object.size() == 6 );
+   Q_ASSERT( object.at("null").isNull() );
+   Q_ASSERT( object.at("bool").toBool() );
+   Q_ASSERT( object.at("double").toDouble() == 3.14 );
+   Q_ASSERT( object.at("string").toString() == QString("test string") );
+   Q_ASSERT( object.at("bytes").toBytes() == QByteArray("test bytes") );
+   EMetaArray array {object.at("object").toObject().at("array").toArray()};
+   Q_ASSERT( array.size() == 5 );
+   Q_ASSERT( array.at(0).isNull() );
+   Q_ASSERT( array.at(1).toBool() );
+   Q_ASSERT( array.at(2).toDouble() == 6.28 );
+   Q_ASSERT( array.at(3).toString() == QString("array test string") );
+   Q_ASSERT( array.at(4).toBytes() == QByteArray("array test bytes") );
+}
+
+
+
+
+
+
+void TestMetadata::writeLegacy(QDataStream& stream, const EMetadata& meta)
+{
+   // write the metadata in the tagged format of version 1 data objects
+   stream << static_cast<quint8>(meta.type());
+   switch (meta.type())
+   {
+   case EMetadata::Bool:
+      stream << static_cast<quint8>(meta.toBool());
+      break;
+   case EMetadata::Double:
+      stream << meta.toDouble();
+      break;
+   case EMetadata::String:
+      writeLegacy(stream,meta.toString());
+      break;
+   case EMetadata::Bytes:
+      stream << quint8 {170} << static_cast<quint32>(meta.toBytes().size());
+      stream.writeRawData(meta.toBytes().constData(),meta.toBytes().size());
+      break;
+   case EMetadata::Array:
+      stream << static_cast<quint32>(meta.toArray().size());
+      for (const auto& child: meta.toArray())
+      {
+         writeLegacy(stream,child);
+      }
+      break;
+   case EMetadata::Object:
+      stream << static_cast<quint32>(meta.toObject().size());
+      for (auto i = meta.toObject().cbegin(); i != meta.toObject().cend() ;++i)
+      {
+         writeLegacy(stream,i.key());
+         writeLegacy(stream,*i);
+      }
+      break;
+   default:
+      break;
+   }
+}
+
+
+
+
+
+
+void TestMetadata::writeLegacy(QDataStream& stream, const QString& value)
+{
+   // write the string in the tagged format of version 1 data objects
+   QByteArray bytes {value.toUtf8()};
+   stream << quint8 {85} << quint8 {170} << static_cast<quint32>(bytes.size());
+   stream.writeRawData(bytes.constData(),bytes.size());
 }
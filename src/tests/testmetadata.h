@@ -1,6 +1,7 @@
 #ifndef TESTMETADATA_H
 #define TESTMETADATA_H
 #include <QtTest>
+#include "emetadata.h"
 
 
 
@@ -17,6 +18,14 @@ private slots:
    void testNull();
    void testFileInputOutput();
    void testCopyConstructor();
+   void testEncodeDecode();
+   void testEncodeModified();
+   void testReadVersion1();
+private:
+   static EMetadata makeTree();
+   static void checkTree(const EMetadata& meta);
+   static void writeLegacy(QDataStream& stream, const EMetadata& meta);
+   static void writeLegacy(QDataStream& stream, const QString& value);
 };
 
 
@@ -0,0 +1,113 @@
+#include "testopenclrun.h"
+#include "ace_analytic_openclrun.h"
+#include "ace_analytic_abstractinput.h"
+#include "opencl_platform.h"
+#include "opencl_device.h"
+#include "eabstractanalyticblock.h"
+#include "eabstractanalyticopencl.h"
+#include "eabstractanalyticopenclworker.h"
+
+
+
+//
+
+
+
+/*!
+ * An OpenCL worker that returns an empty result block for each work block
+ * without using its device, so only the hand off between the run and its
+ * threads is measured.
+ */
+class DummyOpenCLWorker : public EAbstractAnalyticOpenCLWorker
+{
+public:
+   virtual std::unique_ptr<EAbstractAnalyticBlock> execute(const EAbstractAnalyticBlock* block) override final
+      { return std::unique_ptr<EAbstractAnalyticBlock>(new EAbstractAnalyticBlock(block->index())); }
+};
+
+
+
+/*!
+ * An abstract OpenCL object that makes dummy workers.
+ */
+class DummyOpenCL : public EAbstractAnalyticOpenCL
+{
+public:
+   DummyOpenCL(): EAbstractAnalyticOpenCL(nullptr) {}
+   virtual std::unique_ptr<EAbstractAnalyticOpenCLWorker> makeWorker() override final
+      { return std::unique_ptr<EAbstractAnalyticOpenCLWorker>(new DummyOpenCLWorker); }
+   virtual void initialize(::OpenCL::Context* /*context*/) override final {}
+};
+
+
+
+/*!
+ * An abstract input that counts the result blocks it is given and is finished
+ * once it has received the given number of them.
+ */
+class DummyInput : public Ace::Analytic::AbstractInput
+{
+public:
+   void reset(int size) { _size = size; _count = 0; }
+   virtual bool isFinished() const override final { return _count >= _size; }
+   virtual void saveResult(std::unique_ptr<EAbstractAnalyticBlock>&& /*result*/) override final
+      { ++_count; }
+private:
+   int _size {0};
+   int _count {0};
+};
+
+
+
+
+
+
+void TestOpenCLRun::initTestCase()
+{
+   // find a CPU device such as the one of a pocl platform, else use any device
+   for (int i = 0; i < OpenCL::Platform::size() ;++i)
+   {
+      OpenCL::Platform* platform {OpenCL::Platform::get(i)};
+      for (int j = 0; j < platform->deviceSize() ;++j)
+      {
+         OpenCL::Device* device {platform->device(j)};
+         if ( !_device || device->type() == OpenCL::Device::Type::CPU )
+         {
+            _device = device;
+         }
+      }
+   }
+   if ( !_device )
+   {
+      QSKIP("No OpenCL device is available.");
+   }
+}
+
+
+
+
+
+
+void TestOpenCLRun::benchmarkSmallBlocks()
+{
+   // make an OpenCL run whose workers do no work
+   DummyOpenCL opencl;
+   DummyInput input;
+   Ace::Analytic::OpenCLRun run(&opencl,_device,&input);
+   QEventLoop loop;
+   connect(&run,&Ace::Analytic::AbstractRun::finished,&loop,&QEventLoop::quit);
+
+   // send small blocks through the run and wait for all of their results, which
+   // took about 10 milliseconds per block and thread when the run threads polled
+   // for work
+   QBENCHMARK
+   {
+      input.reset(_blockSize);
+      for (int i = 0; i < _blockSize ;++i)
+      {
+         run.addWork(std::unique_ptr<EAbstractAnalyticBlock>(new EAbstractAnalyticBlock(i)));
+      }
+      loop.exec();
+   }
+   Q_ASSERT( input.isFinished() );
+}
@@ -0,0 +1,28 @@
+#ifndef TESTOPENCLRUN_H
+#define TESTOPENCLRUN_H
+#include <QtTest/QtTest>
+
+
+
+namespace OpenCL { class Device; }
+
+
+
+class TestOpenCLRun : public QObject
+{
+   Q_OBJECT
+private slots:
+   void initTestCase();
+   void benchmarkSmallBlocks();
+private:
+   /*!
+    * The number of work blocks sent through the OpenCL run by each iteration of
+    * the benchmark.
+    */
+   constexpr static int _blockSize {2000};
+   OpenCL::Device* _device {nullptr};
+};
+
+
+
+#endif
@@ -25,7 +25,8 @@ HEADERS += \
     testopenclprogram.h \
     testopenclkernel.h \
     testopenclbuffer.h \
-    testopenclevent.h
+    testopenclevent.h \
+    testopenclrun.h
 
 SOURCES += \
     testexception.cpp \
@@ -39,7 +40,8 @@ SOURCES += \
     testopenclprogram.cpp \
     testopenclkernel.cpp \
     testopenclbuffer.cpp \
-    testopenclevent.cpp
+    testopenclevent.cpp \
+    testopenclrun.cpp
 
 RESOURCES += \
     resources.qrc